@@ -34,7 +34,9 @@ public:
 	Index *i_orderline; // key = (w_id, d_id, o_id)
 	Index *i_orderline_wd; // key = (w_id, d_id).	  // SHARES ROWS WITH i_orderline !!
 
-	bool **delivering;
+	// The oldest undelivered order of each district, claimed with a CAS by
+	// the delivery that delivers it. Indexed by (w_id-1)*DIST_PER_WARE+d_id-1.
+	volatile uint64_t *delivery_o_id;
 	uint32_t next_tid;
 private:
 	uint64_t num_wh;
@@ -11,14 +11,15 @@ void tpcc_query::init(uint64_t thd_id, workload *h_wl)
 	double x = (double)(rand() % 100) / 100.0;
 	part_to_access = (uint64_t *)
 	    mem_allocator.alloc(sizeof (uint64_t)*g_part_cnt, thd_id);
-	if (x<g_perc_payment) gen_payment(thd_id);
-	else                  gen_new_order(thd_id);
+	if (x<g_perc_payment)                      gen_payment(thd_id);
+	else if (x<g_perc_payment+g_perc_delivery) gen_delivery(thd_id);
+	else                                       gen_new_order(thd_id);
 }
 
 void tpcc_query::gen_payment(uint64_t thd_id)
 {
 	type = TPCC_PAYMENT;
-	if (FIRST_PART_LOCAL) w_id = thd_id % g_num_wh + 1;
+	if (g_first_part_local) w_id = thd_id % g_num_wh + 1;
 	// WARNING: DEFINITELY NOT SAFE IF NTHREADS > NWAREHOUSES
 	else                  w_id = URand(1, g_num_wh, thd_id % g_num_wh); 
 	d_w_id = w_id;
@@ -64,7 +65,7 @@ void tpcc_query::gen_payment(uint64_t thd_id)
 void tpcc_query::gen_new_order(uint64_t thd_id)
 {
 	type = TPCC_NEW_ORDER;
-	if (FIRST_PART_LOCAL) w_id = thd_id%g_num_wh+1;
+	if (g_first_part_local) w_id = thd_id%g_num_wh+1;
 	else                  w_id = URand(1, g_num_wh, thd_id%g_num_wh);
 	d_id = URand(1, DIST_PER_WARE, w_id-1);
 	c_id = NURand(1023, 1, g_cust_per_dist, w_id-1);
@@ -115,10 +116,21 @@ void tpcc_query::gen_new_order(uint64_t thd_id)
 	}
 }
 
+void tpcc_query::gen_delivery(uint64_t thd_id)
+{
+	type = TPCC_DELIVERY;
+	if (g_first_part_local) w_id = thd_id%g_num_wh+1;
+	else                  w_id = URand(1, g_num_wh, thd_id%g_num_wh);
+	o_carrier_id = URand(1, 10, w_id-1);
+	ol_delivery_d = 2013;
+	part_to_access[0] = wh_to_part(w_id);
+	part_num = 1;
+}
+
 void tpcc_query::gen_order_status(uint64_t thd_id)
 {
 	type = TPCC_ORDER_STATUS;
-	if (FIRST_PART_LOCAL) w_id = thd_id%g_num_wh+1;
+	if (g_first_part_local) w_id = thd_id%g_num_wh+1;
 	else                  w_id = URand(1, g_num_wh, thd_id%g_num_wh);
 	d_id = URand(1, DIST_PER_WARE, w_id-1);
 	c_w_id = w_id;
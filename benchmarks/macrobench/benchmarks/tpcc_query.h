@@ -50,5 +50,6 @@ private:
 	//	uint64_t wh_to_part(uint64_t wid);
 	void gen_payment(uint64_t thd_id);
 	void gen_new_order(uint64_t thd_id);
+	void gen_delivery(uint64_t thd_id);
 	void gen_order_status(uint64_t thd_id);
 };
@@ -10,6 +10,7 @@
 #include "row.h"
 #include "all_indexes.h"
 #include "tpcc_const.h"
+#include "mem_alloc.h"
 
 void tpcc_txn_man::init(thread_t * h_thd, workload * h_wl, uint64_t thd_id)
 {
@@ -27,12 +28,12 @@ RC tpcc_txn_man::run_txn(base_query * query)
 		case TPCC_NEW_ORDER:
 			return run_new_order(m_query);
 			break;
+		case TPCC_DELIVERY :
+			return run_delivery(m_query);
+			break;
 		/*case TPCC_ORDER_STATUS :
 			return run_order_status(m_query);
 			break;
-		  case TPCC_DELIVERY :
-			return run_delivery(m_query);
-			break;
 		  case TPCC_STOCK_LEVEL :
 			return run_stock_level(m_query);
 			break;*/
@@ -135,43 +136,43 @@ RC tpcc_txn_man::run_payment(tpcc_query * query)
 		+=============================================================================*/
 		// XXX: we don't retrieve all the info, just the tuple we are interested in
 
-		#ifdef USE_RANGE_QUERIES
 		Index * index = _wl->i_customer_last;
-
-		uint64_t key_low = custNPKey_ordered_by_cid(query->c_last, 0, query->c_d_id, query->c_w_id);
-		uint64_t key_high = custNPKey_ordered_by_cid(query->c_last, g_cust_per_dist, query->c_d_id, query->c_w_id);
-		uint64_t resultKeys[key_high - key_low + 1];
-		itemid_t * resultValues[key_high - key_low + 1];
-		int numResults = index_range_query(index, key_low, key_high, resultKeys, resultValues, wh_to_part(c_w_id));
-		assert(numResults > 0);
-		
-		// get midpoint value
-		r_cust = ((row_t *) resultValues[numResults/2]->location);
-		#else
-		// the index does not have range query support, so the value associated
-		// with a given key in the dictionary is a linked list of rows for a
-		// given last name.
-		
-		uint64_t key = custNPKey(query->c_last, query->c_d_id, query->c_w_id);
-		// XXX: the list is not sorted. But let's assume it's sorted... 
-		// The performance won't be much different.
-		Index * index = _wl->i_customer_last;
-
-		//				index->lock_key(key);
-		item = index_read(index, key, wh_to_part(c_w_id));
-		assert(item!=NULL);
-		int cnt = 0;
-		itemid_t * it = item;
-		itemid_t * mid = item;
-		while (it!=NULL) {
-			//							cout<<"it="<<(unsigned long long) it<<std::endl;
-			cnt++;
-			it = it->next;
-			if (cnt%2==0) mid = mid->next;
+		if (index->supports_range_queries()) {
+			// the customers with a given last name are consecutive keys in the
+			// index, ordered by c_id, so they are found with one range query.
+			uint64_t key_low = custNPKey_ordered_by_cid(query->c_last, 0, query->c_d_id, query->c_w_id);
+			uint64_t key_high = custNPKey_ordered_by_cid(query->c_last, g_cust_per_dist, query->c_d_id, query->c_w_id);
+			uint64_t resultKeys[key_high - key_low + 1];
+			itemid_t * resultValues[key_high - key_low + 1];
+			int numResults = index_range_query(index, key_low, key_high, resultKeys, resultValues, wh_to_part(c_w_id));
+			assert(numResults > 0);
+			
+			// get midpoint value
+			r_cust = ((row_t *) resultValues[numResults/2]->location);
+		} else {
+			// the index does not have range query support, so the value associated
+			// with a given key in the dictionary is a linked list of rows for a
+			// given last name.
+			
+			uint64_t key = custNPKey(query->c_last, query->c_d_id, query->c_w_id);
+			// XXX: the list is not sorted. But let's assume it's sorted... 
+			// The performance won't be much different.
+
+			//				index->lock_key(key);
+			item = index_read(index, key, wh_to_part(c_w_id));
+			assert(item!=NULL);
+			int cnt = 0;
+			itemid_t * it = item;
+			itemid_t * mid = item;
+			while (it!=NULL) {
+				//							cout<<"it="<<(unsigned long long) it<<std::endl;
+				cnt++;
+				it = it->next;
+				if (cnt%2==0) mid = mid->next;
+			}
+			r_cust = ((row_t *) mid->location);
+			//				index->unlock_key(key);
 		}
-		r_cust = ((row_t *) mid->location);
-		//				index->unlock_key(key);
-		#endif
 	} else { // search customers by cust_id
 		/*=====================================================================+
 		EXEC SQL SELECT c_first, c_middle, c_last, c_street_1, c_street_2,
@@ -257,7 +258,8 @@ RC tpcc_txn_man::run_payment(tpcc_query * query)
 	/////// we simply FREE the row (since it will never be touched by any thread, and we want to avoid leaks, and capture memory reclamation costs)
 	// we comment out insert_row because all it does is ensure the row gets freed if we ABORT... we free it now.
 //	insert_row(r_hist, _wl->t_history);
-	free(r_hist);
+	r_hist->free_row();
+	mem_allocator.free(r_hist, sizeof(row_t));
 
 	assert(rc==RCOK);
 	return finish(rc);
@@ -322,8 +324,8 @@ RC tpcc_txn_man::run_new_order(tpcc_query * query)
 	int64_t o_id;
 	//d_tax = *(double *) r_dist_local->get_value(D_TAX);
 	o_id = *(int64_t *) r_dist_local->get_value(D_NEXT_O_ID);
-	o_id++;
-	r_dist_local->set_value(D_NEXT_O_ID, o_id);
+	int64_t next_o_id = o_id + 1;
+	r_dist_local->set_value(D_NEXT_O_ID, next_o_id);
 
 	/*========================================================================================+
 	EXEC SQL INSERT INTO ORDERS (o_id, o_d_id, o_w_id, o_c_id, o_entry_d, o_ol_cnt, o_all_local)
@@ -337,6 +339,7 @@ RC tpcc_txn_man::run_new_order(tpcc_query * query)
 	r_order->set_value(O_D_ID, d_id);
 	r_order->set_value(O_W_ID, w_id);
 	r_order->set_value(O_ENTRY_D, query->o_entry_d);
+	r_order->set_value(O_CARRIER_ID, (int64_t) 0);
 	r_order->set_value(O_OL_CNT, ol_cnt);
 	int64_t all_local = (remote ? 0 : 1);
 	r_order->set_value(O_ALL_LOCAL, all_local);
@@ -350,14 +353,8 @@ RC tpcc_txn_man::run_new_order(tpcc_query * query)
 	r_no->set_value(NO_O_ID, o_id);
 	r_no->set_value(NO_D_ID, d_id);
 	r_no->set_value(NO_W_ID, w_id);
-	/////// in this special case, where there is NO INDEX to contain this row in the orignal dbx,
-	/////// we simply FREE the row (since it will never be touched by any thread, and we want to avoid leaks, and capture memory reclamation costs)
-	// we comment out insert_row because all it does is ensure the row gets freed if we ABORT... we free it now.
-//	insert_row(r_no, _wl->t_neworder); 
-	if (r_no) {
-		free(r_no);
-		r_no = NULL;
-	}
+	// the row is indexed once committed, and removed again by the delivery
+	insert_row(r_no, _wl->t_neworder);
 	
 #ifndef READ_ONLY		
 	row_t*buf[15]; // can hold up to 15 orderline rows, which is the max allowed by tpc-c
@@ -460,6 +457,7 @@ RC tpcc_txn_man::run_new_order(tpcc_query * query)
 		r_ol->set_value(OL_SUPPLY_W_ID, ol_supply_w_id);
 		r_ol->set_value(OL_QUANTITY, ol_quantity);
 		r_ol->set_value(OL_AMOUNT, ol_amount);
+		r_ol->set_value(OL_DELIVERY_D, (int64_t) 0);
 		#endif  
 		#ifndef READ_ONLY  
 		buf[ol_number] = r_ol;
@@ -468,17 +466,22 @@ RC tpcc_txn_man::run_new_order(tpcc_query * query)
 		insert_row(r_ol, _wl->t_orderline);
 	}
 	assert(rc==RCOK);
+	rc = finish(rc);
+	// The inserted rows are freed if the transaction aborts, so they are
+	// indexed only after it has committed.
+	if (rc != RCOK) return rc;
 
 	//i_order; key = (w_id, d_id, o_id)
 	key = orderPrimaryKey(w_id, d_id, o_id);
 	#ifndef READ_ONLY
 	index_insert(_wl->i_order, key, r_order, wh_to_part(w_id));
+	index_insert(_wl->i_neworder, neworderKey(w_id, d_id, o_id), r_no, wh_to_part(w_id));
 	for (int i = 0; i<bufsize; ++i) {
 		index_insert(_wl->i_orderline, orderlineKey(w_id, d_id, o_id), buf[i], wh_to_part(w_id));
 		index_insert(_wl->i_orderline_wd, orderline_wdKey(w_id, d_id), buf[i], wh_to_part(w_id));
 	}
 	#endif
-	return finish(rc);
+	return rc;
 }
 
 RC tpcc_txn_man::run_order_status(tpcc_query * query)
@@ -524,18 +527,17 @@ RC tpcc_txn_man::run_order_status(tpcc_query * query)
 				itemid_t * item = index_read(index, key, wh_to_part(query->c_w_id));
 				r_cust = (row_t *) item->location;
 		}
-#if TPCC_ACCESS_ALL
-
-		row_t * r_cust_local = get_row(r_cust, RD);
-		if (r_cust_local == NULL) {
-				return finish(Abort);
+		if (g_tpcc_access_all) {
+			row_t * r_cust_local = get_row(r_cust, RD);
+			if (r_cust_local == NULL) {
+					return finish(Abort);
+			}
+			double c_balance;
+			r_cust_local->get_value(C_BALANCE, c_balance);
+			__attribute__ ((unused)) char * c_first = r_cust_local->get_value(C_FIRST);
+			__attribute__ ((unused)) char * c_middle = r_cust_local->get_value(C_MIDDLE);
+			__attribute__ ((unused)) char * c_last = r_cust_local->get_value(C_LAST);
 		}
-		double c_balance;
-		r_cust_local->get_value(C_BALANCE, c_balance);
-		char * c_first = r_cust_local->get_value(C_FIRST);
-		char * c_middle = r_cust_local->get_value(C_MIDDLE);
-		char * c_last = r_cust_local->get_value(C_LAST);
-#endif
 		// EXEC SQL SELECT o_id, o_carrier_id, o_entry_d
 		// INTO :o_id, :o_carrier_id, :entdate FROM orders
 		// ORDER BY o_id DESC;
@@ -551,10 +553,10 @@ RC tpcc_txn_man::run_order_status(tpcc_query * query)
 
 		uint64_t o_id, o_entry_d, o_carrier_id;
 		r_order_local->get_value(O_ID, o_id);
-#if TPCC_ACCESS_ALL
-		r_order_local->get_value(O_ENTRY_D, o_entry_d);
-		r_order_local->get_value(O_CARRIER_ID, o_carrier_id);
-#endif
+		if (g_tpcc_access_all) {
+			r_order_local->get_value(O_ENTRY_D, o_entry_d);
+			r_order_local->get_value(O_CARRIER_ID, o_carrier_id);
+		}
 #if DEBUG_ASSERT
 		itemid_t * it = item;
 		while (it != NULL && it->next != NULL) {
@@ -581,9 +583,8 @@ RC tpcc_txn_man::run_order_status(tpcc_query * query)
 		index = _wl->i_orderline;
 		item = index_read(index, key, wh_to_part(query->w_id));
 		assert(item != NULL);
-#if TPCC_ACCESS_ALL
 		// TODO the rows are simply read without any locking mechanism
-		while (item != NULL) {
+		while (g_tpcc_access_all && item != NULL) {
 				row_t * r_orderline = (row_t *) item->location;
 				int64_t ol_i_id, ol_supply_w_id, ol_quantity, ol_amount, ol_delivery_d;
 				r_orderline->get_value(OL_I_ID, ol_i_id);
@@ -593,7 +594,6 @@ RC tpcc_txn_man::run_order_status(tpcc_query * query)
 				r_orderline->get_value(OL_DELIVERY_D, ol_delivery_d);
 				item = item->next;
 		}
-#endif
 
 final:
 		assert( rc == RCOK );
@@ -604,59 +604,163 @@ final:
 
 RC tpcc_txn_man::run_delivery(tpcc_query * query)
 {
-	/*
-		// XXX HACK if another delivery txn is running on this warehouse, simply commit.
-		if ( !ATOM_CAS(_wl->delivering[query->w_id], false, true) )
-				return finish(RCOK);
-
-		for (int d_id = 1; d_id <= DIST_PER_WARE; d_id++) {
-				uint64_t key = distKey(d_id, query->w_id);
-				Index * index = _wl->i_orderline_wd;
-				itemid_t * item = index_read(index, key, wh_to_part(query->w_id));
-				assert(item != NULL);
-				while (item->next != NULL) {
-#if DEBUG_ASSERT
-						uint64_t o_id_1, o_id_2;
-						((row_t *)item->location)->get_value(OL_O_ID, o_id_1);
-						((row_t *)item->next->location)->get_value(OL_O_ID, o_id_2);
-						assert(o_id_1 > o_id_2);
+	uint64_t w_id = query->w_id;
+	uint64_t part_id_w = wh_to_part(w_id);
+
+	// The orders this delivery has set the carrier of. Advancing the
+	// district cursor, removing the new-order entry and stamping the order
+	// lines is left until the transaction has committed, so that an abort
+	// does not lose the order.
+	struct {
+		volatile uint64_t * next_o_id;
+		uint64_t no_o_id;
+		uint64_t no_key;
+		itemid_t * no_item;
+		row_t * ol_rows[15]; // tpc-c orders have at most 15 order lines
+		int ol_cnt;
+	} delivered[DIST_PER_WARE];
+	int delivered_cnt = 0;
+
+	for (uint64_t d_id = 1; d_id <= DIST_PER_WARE; d_id++) {
+		/*===========================================================+
+		EXEC SQL DECLARE c_no CURSOR FOR
+		         SELECT no_o_id FROM new_order
+		         WHERE no_d_id = :d_id AND no_w_id = :w_id
+		         ORDER BY no_o_id ASC;
+		EXEC SQL OPEN c_no;
+		EXEC SQL FETCH c_no INTO :no_o_id;
+		+===========================================================*/
+		// The oldest new-order of the district is the one after the last
+		// delivered. No new-order yet (or a key collision with another
+		// district only): nothing to deliver in this district.
+		volatile uint64_t * next_o_id =
+			&_wl->delivery_o_id[(w_id-1)*DIST_PER_WARE + d_id-1];
+		uint64_t no_o_id = *next_o_id;
+		uint64_t no_key = neworderKey(w_id, d_id, no_o_id);
+		itemid_t * no_item = index_read(_wl->i_neworder, no_key, part_id_w);
+		while (no_item != NULL) {
+			row_t * r_no = (row_t *) no_item->location;
+			int64_t o, d, w;
+			r_no->get_value(NO_O_ID, o);
+			r_no->get_value(NO_D_ID, d);
+			r_no->get_value(NO_W_ID, w);
+			if ((uint64_t) o == no_o_id && (uint64_t) d == d_id && (uint64_t) w == w_id)
+				break;
+			no_item = no_item->next;
+		}
+		if (no_item == NULL) continue;
+
+		/*===========================================================+
+		EXEC SQL SELECT o_c_id INTO :c_id FROM orders
+		         WHERE o_id = :no_o_id AND o_d_id = :d_id AND o_w_id = :w_id;
+		EXEC SQL UPDATE orders SET o_carrier_id = :o_carrier_id
+		         WHERE o_id = :no_o_id AND o_d_id = :d_id AND o_w_id = :w_id;
+		+===========================================================*/
+		itemid_t * item = index_read(_wl->i_order,
+		                             orderPrimaryKey(w_id, d_id, no_o_id), part_id_w);
+		row_t * r_order = NULL;
+		for (; item != NULL && r_order == NULL; item = item->next) {
+			row_t * r = (row_t *) item->location;
+			int64_t o, d, w;
+			r->get_value(O_ID, o);
+			r->get_value(O_D_ID, d);
+			r->get_value(O_W_ID, w);
+			if ((uint64_t) o == no_o_id && (uint64_t) d == d_id && (uint64_t) w == w_id)
+				r_order = r;
+		}
+		assert(r_order != NULL);
+		row_t * r_order_local = get_row(r_order, WR);
+		if (r_order_local == NULL) return finish(Abort);
+		// A carrier means that another delivery has committed the order
+		// and not advanced the cursor yet. The concurrency control lets
+		// only one delivery set it.
+		int64_t o_carrier_id;
+		r_order_local->get_value(O_CARRIER_ID, o_carrier_id);
+		if (o_carrier_id != 0) continue;
+		int64_t o_c_id;
+		r_order_local->get_value(O_C_ID, o_c_id);
+
+		item = index_read(_wl->i_customer_id, custKey(o_c_id, d_id, w_id), part_id_w);
+		assert(item != NULL);
+		row_t * r_cust_local = get_row((row_t *) item->location, WR);
+		if (r_cust_local == NULL) return finish(Abort);
+
+		o_carrier_id = query->o_carrier_id;
+		r_order_local->set_value(O_CARRIER_ID, o_carrier_id);
+
+		/*===========================================================+
+		EXEC SQL SELECT SUM(ol_amount) INTO :ol_total FROM order_line
+		         WHERE ol_o_id = :no_o_id AND ol_d_id = :d_id AND ol_w_id = :w_id;
+		+===========================================================*/
+		// The order lines do not change once indexed, so they are read
+		// without going through the concurrency control.
+		double ol_total = 0;
+		int ol_cnt = 0;
+		item = index_read(_wl->i_orderline,
+		                  orderlineKey(w_id, d_id, no_o_id), part_id_w);
+		for (; item != NULL; item = item->next) {
+			row_t * r_ol = (row_t *) item->location;
+			int64_t o, d, w;
+			r_ol->get_value(OL_O_ID, o);
+			r_ol->get_value(OL_D_ID, d);
+			r_ol->get_value(OL_W_ID, w);
+			if ((uint64_t) o != no_o_id || (uint64_t) d != d_id || (uint64_t) w != w_id)
+				continue;
+			assert(ol_cnt < 15);
+			delivered[delivered_cnt].ol_rows[ol_cnt++] = r_ol;
+#if !TPCC_SMALL
+			double ol_amount;
+			r_ol->get_value(OL_AMOUNT, ol_amount);
+			ol_total += ol_amount;
 #endif
-						item = item->next;
-				}
-				uint64_t no_o_id;
-				row_t * r_orderline = (row_t *)item->location;
-				r_orderling->get_value(OL_O_ID, no_o_id);
-				// TODO the orderline row should be removed from the table and indexes.
-	
-				index = _wl->i_order;
-				key = orderPrimaryKey(query->w_id, d_id, no_o_id);
-				itemid_t * item = index_read(index, key, wh_to_part(query->w_id));
-				row_t * r_order = (row_t *)item->location;
-				row_t * r_order_local = get_row(r_order, WR);
-
-				uint64_t o_c_id;
-				r_order_local->get_value(O_C_ID, o_c_id);
-				r_order_local->set_value(O_CARRIER_ID, query->o_carrier_id);
-
-				item = index_read(_wl->i_order_line, orderlineKey(query->w_id, d_id, no_o_id));
-				double sum_ol_amount;
-				double ol_amount;
-				while (item != NULL) {
-						// TODO the row is not locked
-						row_t * r_orderline = (row_t *)item->location;
-						r_orderline->set_value(OL_DELIVERY_D, query->ol_delivery_d);
-						r_orderline->get_value(OL_AMOUNT, ol_amount);
-						sum_ol_amount += ol_amount;
-				}
-	
-				key = custKey(o_c_id, d_id, query->w_id);
-				itemid_t * item = index_read(_wl->i_customer_id, key, wh_to_part(query->w_id));
-				row_t * r_cust = (row_t *)item->location;
-				double c_balance;
-				uint64_t c_delivery_cnt;
 		}
-	 */
-	return RCOK;
+
+		/*===========================================================+
+		EXEC SQL UPDATE customer SET c_balance = c_balance + :ol_total,
+		                             c_delivery_cnt = c_delivery_cnt + 1
+		         WHERE c_id = :c_id AND c_d_id = :d_id AND c_w_id = :w_id;
+		+===========================================================*/
+		double c_balance;
+		r_cust_local->get_value(C_BALANCE, c_balance);
+		r_cust_local->set_value(C_BALANCE, c_balance + ol_total);
+#if !TPCC_SMALL
+		int64_t c_delivery_cnt;
+		r_cust_local->get_value(C_DELIVERY_CNT, c_delivery_cnt);
+		r_cust_local->set_value(C_DELIVERY_CNT, c_delivery_cnt + 1);
+#endif
+
+		delivered[delivered_cnt].next_o_id = next_o_id;
+		delivered[delivered_cnt].no_o_id = no_o_id;
+		delivered[delivered_cnt].no_key = no_key;
+		delivered[delivered_cnt].no_item = no_item;
+		delivered[delivered_cnt].ol_cnt = ol_cnt;
+		delivered_cnt++;
+	}
+	RC rc = finish(RCOK);
+	if (rc != RCOK) return rc;
+
+	// Only the delivery that set the carrier of an order gets here for it,
+	// so the cursor, the new-order entry and the order lines have a single
+	// writer.
+	for (int i = 0; i < delivered_cnt; i++) {
+		*delivered[i].next_o_id = delivered[i].no_o_id + 1;
+		/*===========================================================+
+		EXEC SQL DELETE FROM new_order WHERE CURRENT OF c_no;
+		+===========================================================*/
+		RC rm_rc = index_remove(_wl->i_neworder, delivered[i].no_key,
+		                        delivered[i].no_item, part_id_w);
+		assert(rm_rc == RCOK);
+		/*===========================================================+
+		EXEC SQL UPDATE order_line SET ol_delivery_d = :datetime
+		         WHERE ol_o_id = :no_o_id AND ol_d_id = :d_id AND ol_w_id = :w_id;
+		+===========================================================*/
+#if !TPCC_SMALL
+		int64_t ol_delivery_d = query->ol_delivery_d;
+		for (int j = 0; j < delivered[i].ol_cnt; j++)
+			delivered[i].ol_rows[j]->set_value(OL_DELIVERY_D, ol_delivery_d);
+#endif
+	}
+	return rc;
 }
 
 RC tpcc_txn_man::run_stock_level(tpcc_query * query)
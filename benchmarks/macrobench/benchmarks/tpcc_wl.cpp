@@ -27,10 +27,12 @@ RC tpcc_wl::init()
 	cout << "TPCC schema initialized\n";
 
 	printf("Initializing TPCC data!\n");
+	uint64_t starttime = get_server_clock();
 	next_tid = 0;
 	init_table();
 	next_tid = 0;
-	printf("TPCC Data Initialization Complete!\n");
+	printf("TPCC Data Initialization Complete! (%.3lf sec with %d threads)\n",
+	       (get_server_clock() - starttime) / 1000000000.0, load_threads);
 
 //	#define FUNC() validate()
 //	i_neworder->FUNC();
@@ -71,6 +73,8 @@ RC tpcc_wl::init_schema(const char * schema_file)
 	i_customer_id   = indexes["CUSTOMER_ID_IDX"];
 	i_customer_last = indexes["CUSTOMER_LAST_IDX"];
 	i_stock         = indexes["STOCK_IDX"];
+	// the deliveries remove the keys of the delivered orders
+	i_neworder->enable_removals();
 
 	return RCOK;
 }
@@ -91,11 +95,25 @@ RC tpcc_wl::init_table()
 	**********************************/
 	num_wh = g_num_wh;
 
+	// NEW-ORDER holds the last 900 orders of each district.
+	uint64_t ndists = g_num_wh * DIST_PER_WARE;
+	delivery_o_id = new uint64_t[ndists];
+	for (uint64_t i = 0; i < ndists; i++)
+		delivery_o_id[i] = (g_cust_per_dist > 2100) ? 2101 : g_cust_per_dist + 1;
+
+	// One random generator per warehouse, so the data do not depend on
+	// the number of loading threads.
 	tpcc_buffer = new drand48_data *[g_num_wh];
-	pthread_t *p_thds = new pthread_t[g_num_wh];
-	for (uint32_t i = 0; i < g_num_wh; i++)
+	for (uint32_t i = 0; i < g_num_wh; i++) {
+		tpcc_buffer[i] = (drand48_data *)_mm_malloc(sizeof (drand48_data), ALIGNMENT);
+		srand48_r(i+1, tpcc_buffer[i]);
+	}
+
+	init_bulk_load(std::min(g_init_parallelism, (UInt32) g_num_wh));
+	pthread_t *p_thds = new pthread_t[load_threads];
+	for (uint32_t i = 0; i < load_threads; i++)
 		pthread_create(&p_thds[i], NULL, threadInitWarehouse, this);
-	for (uint32_t i = 0; i < g_num_wh; i++)
+	for (uint32_t i = 0; i < load_threads; i++)
 		pthread_join(p_thds[i], NULL);
 	delete[] p_thds;
 
@@ -136,7 +154,7 @@ void tpcc_wl::init_tab_item()
 		if (RAND(10, 0) == 0) strcpy(data, "original");
 		row->set_value(I_DATA, data);
 
-		index_insert(i_item, itemKey(key), row, 0);
+		index_load(i_item, itemKey(key), row, 0);
 	}
 }
 
@@ -170,7 +188,7 @@ void tpcc_wl::init_tab_wh(uint32_t wid)
 	row->set_value(W_TAX, tax);
 	row->set_value(W_YTD, w_ytd);
 
-	index_insert(i_warehouse, wid, row, wh_to_part(wid));
+	index_load(i_warehouse, wid, row, wh_to_part(wid));
 	return;
 }
 
@@ -210,8 +228,8 @@ void tpcc_wl::init_tab_dist(uint64_t wid)
 		double w_ytd = 30000.00;
 		row->set_value(D_TAX, tax);
 		row->set_value(D_YTD, w_ytd);
-		row->set_value(D_NEXT_O_ID, 3001);
-		index_insert(i_district, distKey(did, wid), row, wh_to_part(wid));
+		row->set_value(D_NEXT_O_ID, (int64_t) g_cust_per_dist + 1);
+		index_load(i_district, distKey(did, wid), row, wh_to_part(wid));
 	}
 }
 
@@ -257,7 +275,7 @@ void tpcc_wl::init_tab_stock(uint64_t wid)
 		}
 		row->set_value(S_DATA, s_data);
 		#endif
-		index_insert(i_stock, stockKey(sid, wid), row, wh_to_part(wid));
+		index_load(i_stock, stockKey(sid, wid), row, wh_to_part(wid));
 	}
 }
 
@@ -326,14 +344,13 @@ void tpcc_wl::init_tab_cust(uint64_t did, uint64_t wid)
 		row->set_value(C_YTD_PAYMENT, 10.0);
 		row->set_value(C_PAYMENT_CNT, 1);
 		uint64_t key;
-		#ifdef USE_RANGE_QUERIES
-		key = custNPKey_ordered_by_cid(c_last, cid, did, wid);
-		#else
-		key = custNPKey(c_last, did, wid);
-		#endif
-		index_insert(i_customer_last, key, row, wh_to_part(wid));
+		if (i_customer_last->supports_range_queries())
+			key = custNPKey_ordered_by_cid(c_last, cid, did, wid);
+		else
+			key = custNPKey(c_last, did, wid);
+		index_load(i_customer_last, key, row, wh_to_part(wid));
 		key = custKey(cid, did, wid);
-		index_insert(i_customer_id, key, row, wh_to_part(wid));
+		index_load(i_customer_id, key, row, wh_to_part(wid));
 	}
 }
 
@@ -356,7 +373,8 @@ void tpcc_wl::init_tab_hist(uint64_t c_id, uint64_t d_id, uint64_t w_id)
 	row->set_value(H_DATA, h_data);
 	#endif
 	// just free the row right away, because it isn't even used in the original dbx implementation...
-	free(row);
+	row->free_row();
+	mem_allocator.free(row, sizeof(row_t));
 }
 
 void tpcc_wl::init_tab_order(uint64_t did, uint64_t wid)
@@ -369,7 +387,7 @@ void tpcc_wl::init_tab_order(uint64_t did, uint64_t wid)
 	for (unsigned i = 0; i<g_cust_per_dist; ++i) perm_oid[i] = i+1;
 	#endif
 	for (UInt32 i = 0; i<g_cust_per_dist; i++) {
-		UInt32 oid = (UInt32) perm_oid[i];
+		uint64_t oid = perm_oid[i];
 		row_t * row;
 		uint64_t row_id;
 		t_order->get_new_row(row, 0, row_id);
@@ -385,11 +403,11 @@ void tpcc_wl::init_tab_order(uint64_t did, uint64_t wid)
 		if (oid<2101)
 			row->set_value(O_CARRIER_ID, URand(1, 10, wid-1));
 		else
-			row->set_value(O_CARRIER_ID, 0);
+			row->set_value(O_CARRIER_ID, (int64_t) 0);
 		o_ol_cnt = URand(5, 15, wid-1);
 		row->set_value(O_OL_CNT, o_ol_cnt);
 		row->set_value(O_ALL_LOCAL, 1);
-		index_insert(i_order, orderPrimaryKey(wid, did, oid), row, wh_to_part(wid));
+		index_load(i_order, orderPrimaryKey(wid, did, oid), row, wh_to_part(wid));
 
 		// ORDER-LINE	
 		#if !TPCC_SMALL
@@ -405,15 +423,15 @@ void tpcc_wl::init_tab_order(uint64_t did, uint64_t wid)
 				row->set_value(OL_DELIVERY_D, o_entry);
 				row->set_value(OL_AMOUNT, 0);
 			} else {
-				row->set_value(OL_DELIVERY_D, 0);
+				row->set_value(OL_DELIVERY_D, (int64_t) 0);
 				row->set_value(OL_AMOUNT, (double) URand(1, 999999, wid-1)/100);
 			}
 			row->set_value(OL_QUANTITY, 5);
 			char ol_dist_info[25]; // FIXED: this was too small in the original DBx1000 implementation, causing nasty overflows!
 			MakeAlphaString(24, 24, ol_dist_info, wid-1);
 			row->set_value(OL_DIST_INFO, ol_dist_info);
-			index_insert(i_orderline, orderlineKey(wid, did, oid), row, wh_to_part(wid));
-			index_insert(i_orderline_wd, orderline_wdKey(wid, did), row, wh_to_part(wid));
+			index_load(i_orderline, orderlineKey(wid, did, oid), row, wh_to_part(wid));
+			index_load(i_orderline_wd, orderline_wdKey(wid, did), row, wh_to_part(wid));
 		}
 		#endif
 		// NEW ORDER
@@ -422,7 +440,7 @@ void tpcc_wl::init_tab_order(uint64_t did, uint64_t wid)
 			row->set_value(NO_O_ID, oid);
 			row->set_value(NO_D_ID, did);
 			row->set_value(NO_W_ID, wid);
-			index_insert(i_neworder, neworderKey(wid, did, oid), row, wh_to_part(wid));
+			index_load(i_neworder, neworderKey(wid, did, oid), row, wh_to_part(wid));
 		}
 	}
 }
@@ -468,23 +486,24 @@ void *tpcc_wl::threadInitWarehouse(void *This)
 
 	thread_pinning::bindThread(__tid);
 	
-	uint32_t wid = __tid+1;
-	tpcc_buffer[__tid] = (drand48_data *)_mm_malloc(sizeof (drand48_data), ALIGNMENT);
-	assert((uint64_t) __tid < g_num_wh);
-	srand48_r(wid, tpcc_buffer[__tid]);
+	assert(__tid < wl->load_threads);
 
 	wl->initThread(__tid);
 
+	// ITEM uses the random generator of warehouse 1
 	if (__tid == 0) wl->init_tab_item();
-	wl->init_tab_wh(wid);
-	wl->init_tab_dist(wid);
-	wl->init_tab_stock(wid);
-	for (uint64_t did = 1; did <= DIST_PER_WARE; did++) {
-		wl->init_tab_cust(did, wid);
-		wl->init_tab_order(did, wid);
-		for (uint64_t cid = 1; cid <= g_cust_per_dist; cid++)
-			wl->init_tab_hist(cid, did, wid);
+	for (uint32_t wid = __tid+1; wid <= g_num_wh; wid += wl->load_threads) {
+		wl->init_tab_wh(wid);
+		wl->init_tab_dist(wid);
+		wl->init_tab_stock(wid);
+		for (uint64_t did = 1; did <= DIST_PER_WARE; did++) {
+			wl->init_tab_cust(did, wid);
+			wl->init_tab_order(did, wid);
+			for (uint64_t cid = 1; cid <= g_cust_per_dist; cid++)
+				wl->init_tab_hist(cid, did, wid);
+		}
 	}
+	wl->bulk_load_indexes();
 
 	wl->deinitThread(__tid);
 
@@ -6,6 +6,7 @@
 #include "helper.h"
 
 class ycsb_query;
+class ycsb_request;
 
 class ycsb_wl : public workload {
 public:
@@ -37,6 +38,10 @@ public:
 	RC run_txn(base_query * query);
 
 private:
+	RC run_scan(ycsb_request * req, uint64_t key, int part_id, bool access_data);
 	uint64_t row_cnt;
 	ycsb_wl * _wl;
+	// the keys and items of a scan, which is at most MAX_ROW_PER_TXN rows
+	uint64_t scan_keys[MAX_ROW_PER_TXN];
+	itemid_t * scan_items[MAX_ROW_PER_TXN];
 };
@@ -4,9 +4,11 @@
 #include "wl.h"
 #include "ycsb.h"
 #include "table.h"
+#include <algorithm>
 
 uint64_t ycsb_query::the_n = 0;
 double ycsb_query::denom = 0;
+std::vector<double> ycsb_query::scan_len_cdf;
 
 void ycsb_query::init(uint64_t thd_id, workload * h_wl, Query_thd * query_thd)
 {
@@ -27,6 +29,10 @@ void ycsb_query::calculateDenom()
 	uint64_t table_size = g_synth_table_size/g_virtual_part_cnt;
 	the_n = table_size-1;
 	denom = zeta(the_n, g_zipf_theta);
+
+	double scan_len_zeta = zeta(g_scan_len, g_zipf_theta);
+	for (UInt32 i = 1; i <= g_scan_len; i++)
+		scan_len_cdf.push_back(zeta(i, g_zipf_theta) / scan_len_zeta);
 }
 
 // The following algorithm comes from the paper:
@@ -58,6 +64,26 @@ uint64_t ycsb_query::zipf(uint64_t n, double theta)
 	return 1+(uint64_t) (n*pow(eta*u-eta+1, alpha));
 }
 
+// Shorter scans are the more frequent ones with SCAN_LEN_ZIPF.
+UInt32 ycsb_query::gen_scan_len()
+{
+	double u;
+	switch (g_scan_len_dist) {
+	case SCAN_LEN_CONST:
+		return g_scan_len;
+	case SCAN_LEN_UNIFORM:
+		drand48_r(&_query_thd->buffer, &u);
+		return 1 + (UInt32) (u * g_scan_len);
+	case SCAN_LEN_ZIPF:
+		drand48_r(&_query_thd->buffer, &u);
+		return 1 + (std::lower_bound(scan_len_cdf.begin(), scan_len_cdf.end(), u)
+		            - scan_len_cdf.begin());
+	default:
+		assert(false);
+		return g_scan_len;
+	}
+}
+
 void ycsb_query::gen_requests(uint64_t thd_id, workload * h_wl)
 {
 	#if CC_ALG == HSTORE
@@ -75,7 +101,7 @@ void ycsb_query::gen_requests(uint64_t thd_id, workload * h_wl)
 
 	if (r < g_perc_multi_part) {
 		for (UInt32 i = 0; i < g_part_per_txn; i++) {
-			if (i==0 && FIRST_PART_LOCAL)
+			if (i==0 && g_first_part_local)
 				part_to_access[part_num] = thd_id%g_virtual_part_cnt;
 			else
 				part_to_access[part_num] = rint64%g_virtual_part_cnt;
@@ -88,7 +114,7 @@ void ycsb_query::gen_requests(uint64_t thd_id, workload * h_wl)
 		}
 	} else {
 		part_num = 1;
-		if (FIRST_PART_LOCAL) part_to_access[0] = thd_id%g_part_cnt;
+		if (g_first_part_local) part_to_access[0] = thd_id%g_part_cnt;
 		else                  part_to_access[0] = rint64%g_part_cnt;
 	}
 
@@ -103,7 +129,7 @@ void ycsb_query::gen_requests(uint64_t thd_id, workload * h_wl)
 			req->rtype = WR;
 		} else {
 			req->rtype = SCAN;
-			req->scan_len = SCAN_LEN;
+			req->scan_len = gen_scan_len();
 		}
 
 		// the request will access part_id.
@@ -120,24 +146,30 @@ void ycsb_query::gen_requests(uint64_t thd_id, workload * h_wl)
 		req->value = rint64%(1<<8);
 		// Make sure a single row is not accessed twice
 		if (req->rtype == RD || req->rtype == WR) {
-			if (all_keys.find(req->key) == all_keys.end()) {
+			if (access_cnt < MAX_ROW_PER_TXN
+			    && all_keys.find(req->key) == all_keys.end()) {
 				all_keys.insert(req->key);
 				access_cnt++;
 			} else {
 				continue;
 			}
 		} else {
+			// A scan reads the next scan_len keys of the partition, as long
+			// as the rows of the transaction fit in MAX_ROW_PER_TXN.
+			req->scan_len = std::min(req->scan_len, (UInt32) (table_size - row_id));
+			req->scan_len = std::min(req->scan_len, (UInt32) (MAX_ROW_PER_TXN - access_cnt));
+			if (req->scan_len == 0) continue;
 			bool conflict = false;
 			for (UInt32 i = 0; i < req->scan_len; i++) {
-				primary_key = (row_id+i)*g_part_cnt+part_id;
+				primary_key = (row_id+i)*g_virtual_part_cnt+part_id;
 				if (all_keys.find(primary_key) != all_keys.end())
 					conflict = true;
 			}
 			if (conflict) continue;
 			else {
 				for (UInt32 i = 0; i < req->scan_len; i++)
-					all_keys.insert((row_id+i)*g_part_cnt+part_id);
-				access_cnt += SCAN_LEN;
+					all_keys.insert((row_id+i)*g_virtual_part_cnt+part_id);
+				access_cnt += req->scan_len;
 			}
 		}
 		rid++;
@@ -29,12 +29,15 @@ public:
 
 private:
 	void gen_requests(uint64_t thd_id, workload * h_wl);
+	UInt32 gen_scan_len();
 
 	// for Zipfian distribution
 	static double zeta(uint64_t n, double theta);
 	uint64_t zipf(uint64_t n, double theta);
 	static uint64_t the_n;
 	static double denom;
+	// for SCAN_LEN_ZIPF: the probability of a scan of up to i+1 keys
+	static std::vector<double> scan_len_cdf;
 	double zeta_2_theta;
 	Query_thd *_query_thd;
 };
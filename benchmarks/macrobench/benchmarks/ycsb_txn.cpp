@@ -32,40 +32,36 @@ RC ycsb_txn_man::run_txn(base_query *query)
 		ycsb_request *req = &m_query->requests[rid];
 		uint64_t key = req->key + 1; // make sure key != 0	
 		int part_id = wl->key_to_part(key);
-		bool finish_req = false;
-		UInt32 iteration = 0;
-		while (!finish_req) {
-			if (iteration == 0) {
-				m_item = index_read(_wl->the_index, key, part_id);
-				if (m_item == NULL) cout << "item is null, key is " << key << std::endl;
-				assert(m_item != NULL);
-			}
+		if (req->rtype == SCAN) {
+			rc = run_scan(req, key, part_id, m_query->request_cnt > 1);
+			if (rc != RCOK) goto final;
+			continue;
+		}
 
-			row_t *row = ((row_t *) m_item->location);
-			row_t *row_local;
+		m_item = index_read(_wl->the_index, key, part_id);
+		if (m_item == NULL) cout << "item is null, key is " << key << std::endl;
+		assert(m_item != NULL);
 
-			row_local = get_row(row, req->rtype);
-			if (row_local == NULL) {
-				rc = Abort;
-				goto final;
-			}
+		row_t *row = ((row_t *) m_item->location);
+		row_t *row_local;
 
-			//> Only do computation when there are more than 1 requests.
-			if (m_query->request_cnt > 1) {
-				int fid = 0;
-				if (req->rtype == RD || req->rtype == SCAN) {
-					char *data = row_local->get_data();
-					__attribute__ ((unused)) uint64_t fval = *(uint64_t *)(&data[fid*10]);
-				} else {
-					assert(req->rtype == WR);
-					char * data = row->get_data();
-					*(uint64_t *)(&data[fid*10]) = 0;
-				}
-			}
+		row_local = get_row(row, req->rtype);
+		if (row_local == NULL) {
+			rc = Abort;
+			goto final;
+		}
 
-			iteration++;
-			if (req->rtype == RD || req->rtype == WR || iteration == req->scan_len)
-				finish_req = true;
+		//> Only do computation when there are more than 1 requests.
+		if (m_query->request_cnt > 1) {
+			int fid = 0;
+			if (req->rtype == RD) {
+				char *data = row_local->get_data();
+				__attribute__ ((unused)) uint64_t fval = *(uint64_t *)(&data[fid*10]);
+			} else {
+				assert(req->rtype == WR);
+				char * data = row->get_data();
+				*(uint64_t *)(&data[fid*10]) = 0;
+			}
 		}
 	}
 
@@ -75,3 +71,37 @@ final:
 	rc = finish(rc);
 	return rc;
 }
+
+//> Reads the scan_len keys of the partition starting at `key`. They are
+//> g_virtual_part_cnt apart, so they are fetched with a single range query
+//> only if they are contiguous (and the index supports range queries), else
+//> with one index_read() per key. The rows are read as RD, which every
+//> concurrency control algorithm handles.
+RC ycsb_txn_man::run_scan(ycsb_request * req, uint64_t key, int part_id, bool access_data)
+{
+	uint64_t stride = g_virtual_part_cnt;
+	int numResults;
+
+	assert(req->scan_len <= MAX_ROW_PER_TXN);
+	if (stride == 1 && _wl->the_index->supports_range_queries()) {
+		numResults = index_range_query(_wl->the_index, key, key + req->scan_len - 1,
+		                               scan_keys, scan_items, part_id);
+	} else {
+		numResults = req->scan_len;
+		for (int i = 0; i < numResults; i++) {
+			scan_keys[i] = key + i * stride;
+			scan_items[i] = index_read(_wl->the_index, scan_keys[i], part_id);
+			assert(scan_items[i] != NULL);
+		}
+	}
+
+	for (int i = 0; i < numResults; i++) {
+		row_t *row_local = get_row((row_t *) scan_items[i]->location, RD);
+		if (row_local == NULL) return Abort;
+		if (access_data) {
+			char *data = row_local->get_data();
+			__attribute__ ((unused)) uint64_t fval = *(uint64_t *)(&data[0]);
+		}
+	}
+	return RCOK;
+}
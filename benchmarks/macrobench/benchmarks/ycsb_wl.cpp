@@ -125,7 +125,6 @@ void ycsb_wl::init_table_parallel()
 		}
 	}
 	enable_thread_mem_pool = false;
-	mem_allocator.unregister();
 }
 
 void *ycsb_wl::init_table_slice()
@@ -136,7 +135,6 @@ void *ycsb_wl::init_table_slice()
 	tid = __tid;
 	this->initThread(tid);
 
-	mem_allocator.register_thread(__tid);
 	RC rc;
 	if (g_synth_table_size % g_init_parallelism)
 		cout << "g_synth_table_size=" << g_synth_table_size <<
@@ -12,12 +12,8 @@ void Row_lock::init(row_t * row) {
 	owner_cnt = 0;
 	waiter_cnt = 0;
 
-	latch = new pthread_mutex_t;
-	pthread_mutex_init(latch, NULL);
-	
+	latch.init();
 	lock_type = LOCK_NONE;
-	blatch = false;
-
 }
 
 RC Row_lock::lock_get(lock_t type, txn_man * txn) {
@@ -33,7 +29,7 @@ RC Row_lock::lock_get(lock_t type, txn_man * txn, uint64_t* &txnids, int &txncnt
 	if (g_central_man)
 		glob_manager->lock_row(_row);
 	else 
-		pthread_mutex_lock( latch );
+		latch.lock();
 	assert(owner_cnt <= g_thread_cnt);
 	assert(waiter_cnt < g_thread_cnt);
 #if DEBUG_ASSERT
@@ -156,7 +152,7 @@ final:
 	if (g_central_man)
 		glob_manager->release_row(_row);
 	else
-		pthread_mutex_unlock( latch );
+		latch.unlock();
 
 	return rc;
 }
@@ -167,7 +163,7 @@ RC Row_lock::lock_release(txn_man * txn) {
 	if (g_central_man)
 		glob_manager->lock_row(_row);
 	else 
-		pthread_mutex_lock( latch );
+		latch.lock();
 
 	// Try to find the entry in the owners
 	LockEntry * en = owners;
@@ -222,7 +218,7 @@ RC Row_lock::lock_release(txn_man * txn) {
 	if (g_central_man)
 		glob_manager->release_row(_row);
 	else
-		pthread_mutex_unlock( latch );
+		latch.unlock();
 
 	return RCOK;
 }
@@ -1,6 +1,8 @@
 #ifndef ROW_LOCK_H
 #define ROW_LOCK_H
 
+#include "row_latch.h"
+
 class row_t;
 class txn_man;
 
@@ -20,8 +22,7 @@ public:
     RC lock_release(txn_man * txn);
 	
 private:
-    pthread_mutex_t * latch;
-	bool blatch;
+	row_latch latch;
 	
 	bool 		conflict_lock(lock_t l1, lock_t l2);
 	LockEntry * get_entry();
@@ -28,9 +28,7 @@ void Row_mvcc::init(row_t * row) {
 	_exists_prewrite = false;
 	_max_served_rts = 0;
 	
-	blatch = false;
-	latch = (pthread_mutex_t *) _mm_malloc(sizeof(pthread_mutex_t), ALIGNMENT);
-	pthread_mutex_init(latch, NULL);
+	latch.init();
 }
 
 void Row_mvcc::buffer_req(TsType type, txn_man * txn, bool served)
@@ -101,9 +99,7 @@ uint64_t t1 = get_sys_clock();
 	if (g_central_man)
 		glob_manager->lock_row(_row);
 	else
-		while (!ATOM_CAS(blatch, false, true))
-			PAUSE
-		//pthread_mutex_lock( latch );
+		latch.lock();
 uint64_t t2 = get_sys_clock();
 INC_STATS(txn->get_thd_id(), debug4, t2 - t1);
 
@@ -189,8 +185,7 @@ INC_STATS(txn->get_thd_id(), debug3, get_sys_clock() - t2);
 	if (g_central_man)
 		glob_manager->release_row(_row);
 	else
-		blatch = false;
-		//pthread_mutex_unlock( latch );	
+		latch.unlock();
 		
 	return rc;
 }
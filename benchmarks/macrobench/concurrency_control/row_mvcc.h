@@ -1,5 +1,7 @@
 #pragma once
 
+#include "row_latch.h"
+
 class table_t;
 class Catalog;
 class txn_man;
@@ -30,8 +32,7 @@ public:
 	void init(row_t * row);
 	RC access(txn_man * txn, TsType type, row_t * row);
 private:
- 	pthread_mutex_t * latch;
-	volatile bool blatch;
+	row_latch latch;
 
 	row_t * _row;
 
@@ -6,18 +6,14 @@
 void 
 Row_occ::init(row_t * row) {
 	_row = row;
-	int part_id = row->get_part_id();
-	_latch = (pthread_mutex_t *) 
-		mem_allocator.alloc(sizeof(pthread_mutex_t), part_id);
-	pthread_mutex_init( _latch, NULL );
+	_latch.init();
 	wts = 0;
-	blatch = false;
 }
 
 RC
 Row_occ::access(txn_man * txn, TsType type) {
 	RC rc = RCOK;
-	pthread_mutex_lock( _latch );
+	_latch.lock();
 	if (type == R_REQ) {
 		if (txn->start_ts < wts)
 			rc = Abort;
@@ -27,13 +23,13 @@ Row_occ::access(txn_man * txn, TsType type) {
 		}
 	} else 
 		assert(false);
-	pthread_mutex_unlock( _latch );
+	_latch.unlock();
 	return rc;
 }
 
 void
 Row_occ::latch() {
-	pthread_mutex_lock( _latch );
+	_latch.lock();
 }
 
 bool
@@ -53,5 +49,5 @@ Row_occ::write(row_t * data, uint64_t ts) {
 
 void
 Row_occ::release() {
-	pthread_mutex_unlock( _latch );
+	_latch.unlock();
 }
@@ -1,6 +1,8 @@
 #ifndef ROW_OCC_H
 #define ROW_OCC_H
 
+#include "row_latch.h"
+
 class table_t;
 class Catalog;
 class txn_man;
@@ -16,8 +18,7 @@ public:
 	void				write(row_t * data, uint64_t ts);
 	void 				release();
 private:
- 	pthread_mutex_t * 	_latch;
-	bool 				blatch;
+ 	row_latch 			_latch;
 
 	row_t * 			_row;
 	// the last update time
@@ -12,8 +12,7 @@ Row_silo::init(row_t * row)
 #if ATOMIC_WORD
 	_tid_word = 0;
 #else 
-	_latch = (pthread_mutex_t *) _mm_malloc(sizeof(pthread_mutex_t), ALIGNMENT);
-	pthread_mutex_init( _latch, NULL );
+	_latch.init();
 	_tid = 0;
 #endif
 }
@@ -88,7 +87,7 @@ Row_silo::lock() {
 		v = _tid_word;
 	}
 #else
-	pthread_mutex_lock( _latch );
+	_latch.lock();
 #endif
 }
 
@@ -98,7 +97,7 @@ Row_silo::release() {
 	assert(_tid_word & LOCK_BIT);
 	_tid_word = _tid_word & (~LOCK_BIT);
 #else 
-	pthread_mutex_unlock( _latch );
+	_latch.unlock();
 #endif
 }
 
@@ -111,7 +110,7 @@ Row_silo::try_lock()
 		return false;
 	return __sync_bool_compare_and_swap(&_tid_word, v, (v | LOCK_BIT));
 #else
-	return pthread_mutex_trylock( _latch ) != EBUSY;
+	return _latch.try_lock();
 #endif
 }
 
@@ -1,5 +1,7 @@
 #pragma once 
 
+#include "row_latch.h"
+
 class table_t;
 class Catalog;
 class txn_man;
@@ -26,7 +28,7 @@ private:
 #if ATOMIC_WORD
 	volatile uint64_t	_tid_word;
 #else
- 	pthread_mutex_t * 	_latch;
+ 	row_latch 			_latch;
 	ts_t 				_tid;
 #endif
 	row_t * 			_row;
@@ -2,7 +2,6 @@
 #include "row.h"
 #include "txn.h"
 #include "mem_alloc.h"
-#include <mm_malloc.h>
 
 #if CC_ALG==TICTOC
 
@@ -13,8 +12,7 @@ Row_tictoc::init(row_t * row)
 #if ATOMIC_WORD
 	_ts_word = 0;
 #else
-	_latch = (pthread_mutex_t *) _mm_malloc(sizeof(pthread_mutex_t), ALIGNMENT);
-	pthread_mutex_init( _latch, NULL );
+	_latch.init();
 	_wts = 0;
 	_rts = 0;
 #endif
@@ -163,23 +161,22 @@ Row_tictoc::try_renew(ts_t wts, ts_t rts, ts_t &new_rts, uint64_t thd_id)
 	if (wts != _wts)
 		return false;
   #endif
-	int ret = pthread_mutex_trylock( _latch );
-	if (ret == EBUSY) 
+	if (!_latch.try_lock())
 		return false;
 
 	if (wts != _wts) { 
   #if TICTOC_MV
 		if (wts == _hist_wts && rts < _wts) {
-			pthread_mutex_unlock( _latch );
+			_latch.unlock();
 			return true;
 		}
   #endif
-		pthread_mutex_unlock( _latch );
+		_latch.unlock();
 		return false;
 	}
 	if (rts > _rts)
 		_rts = rts;
-	pthread_mutex_unlock( _latch );
+	_latch.unlock();
 	new_rts = rts;
 	return true;
 #endif
@@ -229,7 +226,7 @@ Row_tictoc::lock()
 		v = _ts_word;
 	}
 #else 
-	pthread_mutex_lock( _latch );
+	_latch.lock();
 #endif
 }
 
@@ -243,7 +240,7 @@ Row_tictoc::try_lock()
 		return false;
 	return __sync_bool_compare_and_swap(&_ts_word, v, v | lock_mask);
 #else
-	return pthread_mutex_trylock( _latch ) != EBUSY; 
+	return _latch.try_lock(); 
 #endif
 }
 
@@ -254,7 +251,7 @@ Row_tictoc::release()
 	uint64_t lock_mask = (WRITE_PERMISSION_LOCK)? WRITE_BIT : LOCK_BIT;
 	_ts_word &= (~lock_mask);
 #else 
-	pthread_mutex_unlock( _latch );
+	_latch.unlock();
 #endif
 }
 
@@ -1,6 +1,7 @@
 #pragma once 
 
 #include "global.h"
+#include "row_latch.h"
 
 #if CC_ALG == TICTOC
 
@@ -53,7 +54,7 @@ private:
 #else
 	ts_t 				_wts; // last write timestamp
 	ts_t 				_rts; // end lease timestamp
-	pthread_mutex_t * 	_latch;
+	row_latch 			_latch;
 #endif
 #if TICTOC_MV
 	volatile ts_t 		_hist_wts;
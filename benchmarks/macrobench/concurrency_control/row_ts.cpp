@@ -7,7 +7,6 @@
 
 void Row_ts::init(row_t * row) {
 	_row = row;
-	uint64_t part_id = row->get_part_id();
 	wts = 0;
 	rts = 0;
 	min_wts = UINT64_MAX;
@@ -17,10 +16,7 @@ void Row_ts::init(row_t * row) {
     writereq = NULL;
     prereq = NULL;
 	preq_len = 0;
-	latch = (pthread_mutex_t *) 
-		mem_allocator.alloc(sizeof(pthread_mutex_t), part_id);
-	pthread_mutex_init( latch, NULL );
-	blatch = false;
+	latch.init();
 }
 
 TsReqEntry * Row_ts::get_req_entry() {
@@ -154,7 +150,7 @@ RC Row_ts::access(txn_man * txn, TsType type, row_t * row) {
 	if (g_central_man)
 		glob_manager->lock_row(_row);
 	else
-		pthread_mutex_lock( latch );
+		latch.lock();
 	if (type == R_REQ) {
 		if (ts < wts) {
 			rc = Abort;
@@ -235,7 +231,7 @@ final:
 	if (g_central_man)
 		glob_manager->release_row(_row);
 	else
-		pthread_mutex_unlock( latch );
+		latch.unlock();
 	return rc;
 }
 
@@ -1,6 +1,8 @@
 #ifndef ROW_TS_H
 #define ROW_TS_H
 
+#include "row_latch.h"
+
 class table_t;
 class Catalog;
 class txn_man;
@@ -19,8 +21,7 @@ public:
 	RC access(txn_man * txn, TsType type, row_t * row);
 
 private:
- 	pthread_mutex_t * latch;
-	bool blatch;
+	row_latch latch;
 
 	void buffer_req(TsType type, txn_man * txn, row_t * row);
 	TsReqEntry * debuffer_req(TsType type, txn_man * txn);
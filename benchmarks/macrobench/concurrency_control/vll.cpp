@@ -25,14 +25,21 @@ VLLMan::vllMainLoop(txn_man * txn, base_query * query) {
 	for (int rid = 0; rid < m_query->request_cnt; rid ++) {
 		ycsb_request * req = &m_query->requests[rid];
 		ycsb_wl * wl = (ycsb_wl *) txn->get_wl();
-		int part_id = wl->key_to_part( req->key );
+		uint64_t key = req->key + 1; // the keys are loaded as row id + 1
+		int part_id = wl->key_to_part( key );
 		Index * index = wl->the_index;
-		itemid_t * item;
-		item = txn->index_read(index, req->key, part_id);
-		row_t * row = ((row_t *)item->location);
-		// the following line adds the read/write sets to txn->accesses
-		txn->get_row(row, req->rtype);
-		int cs = row->manager->get_cs();
+		// a scan reads scan_len keys of the partition, all of which are
+		// locked here like the key of a read
+		access_t type = (req->rtype == SCAN) ? RD : req->rtype;
+		UInt32 nkeys = (req->rtype == SCAN) ? req->scan_len : 1;
+		for (UInt32 i = 0; i < nkeys; i++) {
+			itemid_t * item;
+			item = txn->index_read(index, key + i * g_virtual_part_cnt, part_id);
+			row_t * row = ((row_t *)item->location);
+			// the following line adds the read/write sets to txn->accesses
+			txn->get_row(row, type);
+			int cs = row->manager->get_cs();
+		}
 	}
 
 	bool done = false;
@@ -133,7 +140,7 @@ VLLMan::finishTxn(txn_man * txn, TxnQEntry * entry) {
 	LIST_REMOVE_HT(entry, _txn_queue, _txn_queue_tail);
 	pthread_mutex_unlock(&_mutex);
 	txn->release();
-	mem_allocator.free(txn, 0);
+	_mm_free(txn); // allocated by get_txn_man()
 }
 
 
@@ -10,8 +10,8 @@
 #define VIRTUAL_PART_CNT			1
 #define PAGE_SIZE					4096 
 #define CL_SIZE						64
-// CPU_FREQ_GHZ is used to get accurate timing info 
-//#define CPU_FREQ_GHZ 					2.410426 	// in GHz/s
+// timing info comes from the TSC, whose rate is calibrated at startup
+// (see lib/Timer.h), so no CPU_FREQ_GHZ is needed
 
 // # of transactions to run for warmup
 #define WARMUP						0
@@ -25,7 +25,7 @@
 #define MEM_ALLIGN					8 
 
 // [THREAD_ALLOC]
-#define THREAD_ALLOC				false
+#define THREAD_ALLOC				true
 #define THREAD_ARENA_SIZE			(1UL << 22) 
 #define MEM_PAD 					true
 #ifdef ALIGNED_ALLOCATIONS
@@ -44,7 +44,12 @@
 /***********************************************/
 // WAIT_DIE, NO_WAIT, DL_DETECT, TIMESTAMP, MVCC, HEKATON, HSTORE, OCC, VLL, TICTOC, SILO
 // TODO TIMESTAMP does not work at this moment
+// Unlike the workload parameters, which can be changed at run time (see
+// system/parser.cpp), the CC algorithm shapes the row managers and stays a
+// build-time choice; e.g. `make xargs=-DCC_ALG=SILO` builds for SILO.
+#ifndef CC_ALG
 #define CC_ALG 						NO_WAIT
+#endif
 #define ISOLATION_LEVEL 			SERIALIZABLE
 
 // all transactions acquire tuples according to the primary key order.
@@ -122,8 +127,10 @@
 #define ZIPF_THETA 					0.6
 #define READ_PERC 					0.9
 #define WRITE_PERC 					0.1
-#define SCAN_PERC 					0
+// The rest of the requests, 1 - READ_PERC - WRITE_PERC, are scans.
 #define SCAN_LEN					20
+// Distribution of the lengths of the scans, in [1, SCAN_LEN].
+#define SCAN_LEN_DIST				SCAN_LEN_CONST
 #define PART_PER_TXN 				1
 #define PERC_MULTI_PART				1
 #define REQ_PER_QUERY				16
@@ -149,6 +156,8 @@ extern TPCCTxnType 					g_tpcc_txn_type;
 
 //#define TXN_TYPE					TPCC_ALL
 #define PERC_PAYMENT 				0.5
+// The rest of the transactions are new-orders.
+#define PERC_DELIVERY 				0.04
 #define FIRSTNAME_MINLEN 			8
 #define FIRSTNAME_LEN 				16
 #define LASTNAME_LEN 				16
@@ -215,5 +224,9 @@ extern TestCases					g_test_case;
 #define TS_CAS						2
 #define TS_HW						3
 #define TS_CLOCK					4
+// Distribution of the YCSB scan lengths.
+#define SCAN_LEN_CONST				1
+#define SCAN_LEN_UNIFORM			2
+#define SCAN_LEN_ZIPF				3
 
 #endif
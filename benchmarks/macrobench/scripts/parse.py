@@ -68,6 +68,7 @@ def parse_output_file(filename):
 		if line.startswith("mem_allocator initialized!"):
 			run_stats = dict()
 			per_index_stats = dict()
+			per_table_stats = dict()
 		if line.startswith("Running "):
 			run_stats['bench'] = tokens[1]
 		elif line.startswith("Reading schema file:"):
@@ -101,10 +102,15 @@ def parse_output_file(filename):
 			stats = summary_to_dict(line)
 			index_name = stats['index']
 			per_index_stats[index_name] = stats
+		elif line.startswith("Per-table index stats"):
+			line = line.replace("Per-table index stats: ", '')
+			stats = summary_to_dict(line)
+			per_table_stats[stats['table']] = stats
 		elif line.startswith("[summary]"):
 			line = line.replace('[summary] ', '')
 			stats = summary_to_dict(line)
 			run_stats['per_index_stats'] = per_index_stats
+			run_stats['per_table_stats'] = per_table_stats
 			run_stats['summary_stats'] = stats
 			ret.append(run_stats)
 			
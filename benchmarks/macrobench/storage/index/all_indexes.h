@@ -11,6 +11,8 @@
 
 #if defined IDX_HASH
 #   include "index_hash.h"
+#elif defined IDX_HASH_LF
+#   include "index_hash_lf.h"
 #else
 #   include "index_adapter.h"
 #endif
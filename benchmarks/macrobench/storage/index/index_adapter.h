@@ -17,8 +17,10 @@
 class Index : public index_base {
 private:
 	Map<KEY_TYPE, VALUE_TYPE> *index;
+	volatile int rq_support; //> -1 until the first supports_range_queries()
 
 public:
+	Index() : rq_support(-1) {}
 	~Index() { delete index; }
 
 	// WARNING: DO NOT OVERLOAD init() WITH NO ARGUMENTS!!!
@@ -35,24 +37,39 @@ public:
 		return RCOK;
 	}
 
+	// The items of a key form a list whose head is the value in the map.
+	// A new item is prepended to the rest of the list with a CAS, so an
+	// insertion is a single operation on the map. Only in an index that
+	// keys are removed from does it take the key's lock, since a removal
+	// takes the head out of the map and an item appended to it meanwhile
+	// would be lost.
 	RC index_insert(KEY_TYPE key, VALUE_TYPE newItem, int part_id = -1) {
-		#if defined USE_RANGE_QUERIES
-		auto oldVal = index->insertIfAbsent(tid, key, newItem);
-		// TODO: determine if there are index collisions in anything but orderline
-		//       (and determine why they happen in orderline, and if it's ok)
-		#else
 		newItem->next = NULL;
+		if (removals) lock_key(key);
+		index->insertOrAppend(tid, key, newItem, append_item);
+		if (removals) unlock_key(key);
+		INCREMENT_NUM_INSERTS(tid);
+		return RCOK;
+	}
+
+	RC index_remove(KEY_TYPE key, VALUE_TYPE item, int part_id = -1) {
+		assert(removals);
+		RC rc = RCOK;
 		lock_key(key);
-		VALUE_TYPE oldItem = index->insertIfAbsent(tid, key, newItem);
-		if (oldItem != NULL) {
-			// adding to existing list
-			newItem->next = oldItem->next;
-			oldItem->next = newItem;
+		VALUE_TYPE head = index->find(tid, key).first;
+		if (head == item) {
+			// the key is reinserted with the rest of the list, if any
+			index->remove(tid, key);
+			if (item->next != NULL)
+				index->insertIfAbsent(tid, key, item->next);
+		} else {
+			VALUE_TYPE prev = head;
+			while (prev != NULL && prev->next != item) prev = prev->next;
+			if (prev != NULL) prev->next = item->next;
+			else              rc = ERROR;
 		}
 		unlock_key(key);
-		#endif
-		INCREMENT_NUM_INSERTS(tid);
-		return RCOK;
+		return rc;
 	}
 
 	RC index_read(KEY_TYPE key, VALUE_TYPE * item, int part_id = -1,
@@ -68,14 +85,49 @@ public:
 	// saves the number N of keys in numResults,
 	// saves the keys themselves in resultKeys[0...N-1],
 	// and saves their values in resultValues[0...N-1].
+	// The arrays must have room for high - low + 1 results.
 	RC index_range_query(KEY_TYPE low, KEY_TYPE high, KEY_TYPE * resultKeys,
 	                     VALUE_TYPE * resultValues, int * numResults,
 	                     int part_id = -1) {
-//		*numResults = index->rangeQuery(tid, low, high, resultKeys, (VALUE_TYPE *) resultValues);
+		std::vector<std::pair<KEY_TYPE, VALUE_TYPE>> kv_pairs;
+		int n = index->rangeQuery(tid, low, high, kv_pairs);
+		if (n < 0) {
+			std::cout << "Range queries are not supported by "
+			          << index->name() << "\n";
+			*numResults = 0;
+			return ERROR;
+		}
+		for (int i = 0; i < n; i++) {
+			resultKeys[i] = kv_pairs[i].first;
+			resultValues[i] = kv_pairs[i].second;
+		}
+		*numResults = n;
 		INCREMENT_NUM_RQS(tid);
 		return RCOK;
 	}
 
+	// Whether the data structure provides range queries, found out with an
+	// empty range query the first time it is asked, so the calling thread
+	// must have called initThread().
+	bool supports_range_queries() {
+		if (rq_support == -1) {
+			std::vector<std::pair<KEY_TYPE, VALUE_TYPE>> kv_pairs;
+			rq_support = (index->rangeQuery(tid, MIN_KEY, MIN_KEY, kv_pairs) >= 0);
+		}
+		return rq_support;
+	}
+
+	// Whether the data structure provides a bulk load, found out with an
+	// empty one, which needs no initThread().
+	bool supports_bulk_load() {
+		std::vector<std::pair<KEY_TYPE, VALUE_TYPE>> kv_pairs;
+		return index->bulkLoad(tid, kv_pairs);
+	}
+
+	RC index_bulk_load(const std::vector<std::pair<KEY_TYPE, VALUE_TYPE>>& kv_pairs) {
+		return index->bulkLoad(tid, kv_pairs) ? RCOK : ERROR;
+	}
+
 	void initThread(const int tid) { index->initThread(tid); }
 	void deinitThread(const int tid) { index->deinitThread(tid); }
 
@@ -84,5 +136,14 @@ public:
 	void print_stats(){ index->validate(); }
 
 	void print() { index->print(); }
-	bool validate() { index->validate(); }
+	bool validate() { return index->validate(); }
+
+private:
+	static void append_item(VALUE_TYPE const& head, VALUE_TYPE const& item) {
+		VALUE_TYPE next;
+		do {
+			next = head->next;
+			item->next = next;
+		} while (!ATOM_CAS(head->next, next, item));
+	}
 };
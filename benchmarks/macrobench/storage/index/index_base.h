@@ -63,6 +63,7 @@ public:
         memset(numInserts, 0, MAX_THREADS_POW2*PREFETCH_SIZE_WORDS*sizeof(unsigned long long));
         memset(numReads, 0, MAX_THREADS_POW2*PREFETCH_SIZE_WORDS*sizeof(unsigned long long));
         debug_init_is_done = 0xCAFEBABE;
+        removals = false;
     }
 
 //    virtual bool index_exist(KEY_TYPE key) = 0; // check if the key exist.
@@ -71,11 +72,9 @@ public:
     //       OF ITEMS FOUND AT THE NODE CONTAINING KEY.
     //       This requirement comes from the fact that DBx1000 uses
     //       this linked list to do a limited form of range queries.
-    //       To maintain atomicity when modifying this list,
-    //       we lock the target key, then perform the insertion.
-    //       If there was already a value (a preexisting linked list),
-    //       then the insertion will replace that value and return it,
-    //       and we will append that list to our newly inserted list.
+    //       To maintain atomicity when modifying this list, the
+    //       new item is linked to a preexisting list with a CAS
+    //       (see Map::insertOrAppend()).
     virtual RC index_insert(KEY_TYPE key, VALUE_TYPE item, int part_id = -1) = 0;
     virtual RC index_read(KEY_TYPE key, VALUE_TYPE * item,
 	                      int part_id = -1, int thd_id = 0) = 0;
@@ -83,9 +82,38 @@ public:
         return index_read(key, item, part_id, 0);
     }
     
-    // TODO implement index_remove
-    virtual RC index_remove(KEY_TYPE key) { return RCOK; }
+    // Finds all keys in [low, high]; see index_adapter.h.
+    virtual RC index_range_query(KEY_TYPE low, KEY_TYPE high, KEY_TYPE * resultKeys,
+                                 VALUE_TYPE * resultValues, int * numResults,
+                                 int part_id = -1) {
+        *numResults = 0;
+        return ERROR;
+    }
+    // If false, every key must be read with index_read() and a table that
+    // needs scans hangs a linked list of items off a single key instead.
+    virtual bool supports_range_queries() { return false; }
+
+    // Builds the empty index out of `kv_pairs`, which are sorted by key and
+    // have no duplicate keys (the items of a key are already linked).
+    // supports_bulk_load() must be asked while the index is still empty.
+    virtual bool supports_bulk_load() { return false; }
+    virtual RC index_bulk_load(const std::vector<std::pair<KEY_TYPE, VALUE_TYPE>>& kv_pairs) {
+        return ERROR;
+    }
+
+    // Removes `item` from the items of `key`, and `key` itself when it was
+    // the last one; the key may be shared by other items (see index_insert()).
+    // The item and its row are not freed, since concurrent readers may still
+    // hold them. Returns ERROR if `item` is not found under `key`.
+    // Only allowed after enable_removals().
+    virtual RC index_remove(KEY_TYPE key, VALUE_TYPE item, int part_id = -1) = 0;
+
+    // Must be called before the first insertion into an index that keys
+    // will be removed from; its insertions then take the key's lock too.
+    void enable_removals() { removals = true; }
     
+    table_t * get_table() { return table; }
+
     virtual void print_stats(){}
     virtual size_t getNodeSize(){return 0;}
     virtual size_t getDescriptorSize(){return 0;}
@@ -139,4 +167,5 @@ protected:
 
     // the index in on "table". The key is the merged key of "fields"
     table_t *table;
+    bool removals; // see enable_removals()
 };
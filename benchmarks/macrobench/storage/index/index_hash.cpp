@@ -59,6 +59,16 @@ RC Index::index_insert(KEY_TYPE key, VALUE_TYPE item, int part_id) {
 	return rc;
 }
 
+RC Index::index_remove(KEY_TYPE key, VALUE_TYPE item, int part_id) {
+	uint64_t bkt_idx = hash(key);
+	assert(bkt_idx < _bucket_cnt_per_part);
+	BucketHeader * cur_bkt = &_buckets[part_id][bkt_idx];
+	get_latch(cur_bkt);
+	bool found = cur_bkt->remove_item(key, item);
+	release_latch(cur_bkt);
+	return found ? RCOK : ERROR;
+}
+
 RC Index::index_read(KEY_TYPE key, VALUE_TYPE * item, int part_id) {
 	uint64_t bkt_idx = hash(key);
 	assert(bkt_idx < _bucket_cnt_per_part);
@@ -92,6 +102,7 @@ RC Index::index_read(KEY_TYPE key, VALUE_TYPE * item,
 void BucketHeader::init() {
 	node_cnt = 0;
 	first_node = NULL;
+	free_nodes = NULL;
 	locked = false;
 }
 
@@ -107,7 +118,17 @@ void BucketHeader::insert_item(KEY_TYPE key,
 		prev_node = cur_node;
 		cur_node = cur_node->next;
 	}
-	if (cur_node == NULL) {		
+	if (cur_node == NULL && free_nodes != NULL) {
+		// A reused node goes to the head of the bucket: a reader that was
+		// still on it then starts over, instead of missing the nodes after it.
+		BucketNode * new_node = free_nodes;
+		free_nodes = new_node->next_free;
+		new_node->key = key;
+		new_node->items = item;
+		new_node->next = first_node;
+		COMPILER_BARRIER
+		first_node = new_node;
+	} else if (cur_node == NULL) {		
 		BucketNode * new_node = (BucketNode *) 
 			mem_allocator.alloc(sizeof(BucketNode), part_id );
 		new_node->init(key);
@@ -125,6 +146,37 @@ void BucketHeader::insert_item(KEY_TYPE key,
 	}
 }
 
+bool BucketHeader::remove_item(KEY_TYPE key, VALUE_TYPE item)
+{
+	BucketNode * cur_node = first_node;
+	BucketNode * prev_node = NULL;
+	while (cur_node != NULL) {
+		if (cur_node->key == key)
+			break;
+		prev_node = cur_node;
+		cur_node = cur_node->next;
+	}
+	if (cur_node == NULL) return false;
+
+	if (cur_node->items == item) {
+		cur_node->items = item->next;
+	} else {
+		VALUE_TYPE prev = cur_node->items;
+		while (prev != NULL && prev->next != item) prev = prev->next;
+		if (prev == NULL) return false;
+		prev->next = item->next;
+	}
+	if (cur_node->items == NULL) {
+		// unlink the node but keep its next pointer for concurrent readers
+		if (prev_node != NULL) prev_node->next = cur_node->next;
+		else                   first_node = cur_node->next;
+		cur_node->next_free = free_nodes;
+		free_nodes = cur_node;
+	}
+	return true;
+}
+
+// Items are NULL if the key does not exist (e.g., it has been removed).
 void BucketHeader::read_item(KEY_TYPE key, VALUE_TYPE * item, const char * tname) 
 {
 	BucketNode * cur_node = first_node;
@@ -133,8 +185,7 @@ void BucketHeader::read_item(KEY_TYPE key, VALUE_TYPE * item, const char * tname
 			break;
 		cur_node = cur_node->next;
 	}
-	M_ASSERT(cur_node->key == key, "Key does not exist!");
-	*item = cur_node->items;
+	*item = (cur_node != NULL) ? cur_node->items : NULL;
 }
 
 #endif
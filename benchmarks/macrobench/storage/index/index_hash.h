@@ -12,11 +12,14 @@ public:
 	void init(KEY_TYPE key) {
 		this->key = key;
 		next = NULL;
+		next_free = NULL;
 		items = NULL;
 	}
 	KEY_TYPE 		key;
 	// The node for the next key	
 	BucketNode * 	next;	
+	// The next node in the free list of the bucket
+	BucketNode * 	next_free;
 	// NOTE. The items can be a list of items connected by the next pointer. 
 	VALUE_TYPE 		items;
 };
@@ -26,8 +29,12 @@ class BucketHeader {
 public:
 	void init();
 	void insert_item(KEY_TYPE key, VALUE_TYPE item, int part_id);
+	bool remove_item(KEY_TYPE key, VALUE_TYPE item);
 	void read_item(KEY_TYPE key, VALUE_TYPE * item, const char * tname);
 	BucketNode * 	first_node;
+	// Nodes of removed keys, reused by insert_item(). They are not freed
+	// because readers traverse the bucket without the latch.
+	BucketNode * 	free_nodes;
 	uint64_t 		node_cnt;
 	bool 			locked;
 };
@@ -44,6 +51,7 @@ public:
 					uint64_t bucket_cnt);
 	bool 		index_exist(KEY_TYPE key); // check if the key exist.
 	RC 			index_insert(KEY_TYPE key, VALUE_TYPE item, int part_id=-1);
+	RC 			index_remove(KEY_TYPE key, VALUE_TYPE item, int part_id=-1);
 	// the following call returns a single item
 	RC	 		index_read(KEY_TYPE key, VALUE_TYPE * item, int part_id=-1);	
 	RC	 		index_read(KEY_TYPE key, VALUE_TYPE * item,
@@ -0,0 +1,406 @@
+/*
+ * File:   index_hash_lf.h
+ *
+ * Lock-free resizable hash index: split-ordered lists, Shalev & Shavit,
+ * JACM 2006, over Michael's lock-free linked list, SPAA 2002.
+ *
+ * All the keys live in one sorted linked list, ordered by the bit-reversed
+ * hash of the key, and every bucket points to a dummy node in the list, so
+ * doubling the number of buckets only adds dummy nodes (lazily, the first
+ * time a new bucket is used) and never moves keys. The bucket array is a
+ * directory of segments allocated on demand. A node is unlinked with the
+ * usual mark-then-CAS of Michael's list and freed with epoch-based
+ * reclamation, once no thread may still be traversing it.
+ *
+ * As in the other indexes, the items of a key are a linked list of itemid_t;
+ * a new item is prepended with a CAS. Items are never freed by the index.
+ */
+#pragma once
+
+#include <atomic>
+#include <vector>
+#include "global.h"
+#include "helper.h"
+#include "index_base.h"
+
+class Index : public index_base {
+public:
+	Index() : nbuckets(0), nkeys(0), global_epoch(0) {}
+	~Index();
+
+	RC init(uint64_t bucket_cnt, int part_cnt);
+	RC init(int part_cnt, table_t * table, uint64_t bucket_cnt) {
+		init(bucket_cnt, part_cnt);
+		this->table = table;
+		return RCOK;
+	}
+
+	RC index_insert(KEY_TYPE key, VALUE_TYPE item, int part_id = -1);
+	RC index_remove(KEY_TYPE key, VALUE_TYPE item, int part_id = -1);
+	RC index_read(KEY_TYPE key, VALUE_TYPE * item, int part_id = -1) {
+		return index_read(key, item, part_id, 0);
+	}
+	RC index_read(KEY_TYPE key, VALUE_TYPE * item, int part_id, int thd_id);
+
+	void initThread(const int tid) {}
+	void deinitThread(const int tid) {}
+
+	void print_stats() {
+		printf("lock-free hash index %s: ~%llu keys, %llu buckets\n",
+		       index_name.c_str(), (unsigned long long) nkeys.load(),
+		       (unsigned long long) nbuckets.load());
+	}
+
+private:
+	static constexpr int      SEGMENT_BITS = 16;
+	static constexpr uint64_t SEGMENT_SIZE = 1ULL << SEGMENT_BITS;
+	static constexpr uint64_t MAX_SEGMENTS = 4096; //> Up to 2^28 buckets
+	static constexpr uint64_t LOAD_FACTOR  = 2;    //> Keys per bucket
+	static constexpr int      COUNT_BATCH  = 64;   //> Key count updates per thread
+	static constexpr int      RETIRE_SCAN  = 64;   //> Retires between epoch advances
+	static constexpr uint64_t QUIESCENT    = ~0ULL;
+
+	struct node_t {
+		uint64_t so_key; //> Split-order key: reversed hash, odd for regular nodes
+		KEY_TYPE key;
+		std::atomic<VALUE_TYPE> items;
+		std::atomic<uintptr_t> next; //> Low bit set: the node is deleted
+
+		node_t(uint64_t so_key_, KEY_TYPE key_) : so_key(so_key_), key(key_),
+		                                         items(NULL), next(0) {}
+	};
+
+	//> Set in the items of a node that lost its last item and is being
+	//> deleted, so that no item is added to it any more.
+	static VALUE_TYPE deleted_items() { return (VALUE_TYPE) 1; }
+
+	struct alignas(64) thread_data_t {
+		std::atomic<uint64_t> epoch; //> Announced epoch, or QUIESCENT
+		uint64_t local_epoch;
+		std::vector<node_t *> limbo[3];
+		uint64_t limbo_epoch[3];
+		int retires;
+		int64_t count_delta;
+	};
+
+	//> Keeps the calling thread in an epoch while it holds node pointers.
+	struct epoch_guard_t {
+		Index *index;
+		epoch_guard_t(Index *index_) : index(index_) { index->enter(); }
+		~epoch_guard_t() { index->leave(); }
+	};
+
+	std::atomic<std::atomic<node_t *> *> segments[MAX_SEGMENTS];
+	std::atomic<uint64_t> nbuckets;
+	std::atomic<uint64_t> nkeys;
+	std::atomic<uint64_t> global_epoch;
+	thread_data_t threads[MAX_THREADS_POW2];
+
+	static inline node_t *ptr(uintptr_t v) { return (node_t *) (v & ~(uintptr_t) 1); }
+	static inline bool is_marked(uintptr_t v) { return v & 1; }
+
+	static inline uint64_t reverse(uint64_t v) {
+		v = ((v >> 1) & 0x5555555555555555ULL) | ((v & 0x5555555555555555ULL) << 1);
+		v = ((v >> 2) & 0x3333333333333333ULL) | ((v & 0x3333333333333333ULL) << 2);
+		v = ((v >> 4) & 0x0F0F0F0F0F0F0F0FULL) | ((v & 0x0F0F0F0F0F0F0F0FULL) << 4);
+		return __builtin_bswap64(v);
+	}
+	//> The 64-bit finalizer of MurmurHash3; the MSB is left for the split order.
+	static inline uint64_t hash(KEY_TYPE key) {
+		uint64_t h = key;
+		h ^= h >> 33;
+		h *= 0xff51afd7ed558ccdULL;
+		h ^= h >> 33;
+		h *= 0xc4ceb9fe1a85ec53ULL;
+		h ^= h >> 33;
+		return h & ~(1ULL << 63);
+	}
+	static inline uint64_t so_regular(uint64_t h) { return reverse(h) | 1; }
+	static inline uint64_t so_dummy(uint64_t bucket) { return reverse(bucket); }
+
+	//> Regular nodes are ordered by key among equal split-order keys (i.e.,
+	//> keys whose hashes differ only in the MSB).
+	static inline bool before(node_t *n, uint64_t so_key, KEY_TYPE key) {
+		return n->so_key < so_key || (n->so_key == so_key && n->key < key);
+	}
+
+	void enter();
+	void leave();
+	void retire(node_t *node);
+	void try_advance_epoch();
+	void free_limbo(thread_data_t *t, int i);
+
+	std::atomic<node_t *> *bucket_slot(uint64_t bucket);
+	node_t *get_bucket(uint64_t bucket);
+	void count_keys(int64_t delta);
+	bool list_find(node_t *start, uint64_t so_key, KEY_TYPE key,
+	               node_t **pprev, node_t **pcurr);
+};
+
+/******************************************************************************/
+/* Epoch-based reclamation                                                    */
+/* A node retired in epoch e is freed once the global epoch has reached e+2,  */
+/* since every thread has left epoch e by then.                               */
+/******************************************************************************/
+
+inline void Index::enter()
+{
+	thread_data_t *t = &threads[tid];
+	uint64_t e = global_epoch.load();
+	t->epoch.store(e); //> seq_cst: visible before any node is read
+	if (e != t->local_epoch) {
+		t->local_epoch = e;
+		for (int i = 0; i < 3; i++)
+			if (t->limbo_epoch[i] + 2 <= e) free_limbo(t, i);
+	}
+}
+
+inline void Index::leave()
+{
+	threads[tid].epoch.store(QUIESCENT, std::memory_order_release);
+}
+
+inline void Index::free_limbo(thread_data_t *t, int i)
+{
+	for (node_t *n : t->limbo[i]) delete n;
+	t->limbo[i].clear();
+}
+
+inline void Index::retire(node_t *node)
+{
+	thread_data_t *t = &threads[tid];
+	int i = t->local_epoch % 3;
+	if (t->limbo_epoch[i] != t->local_epoch) {
+		//> Holds nodes of epoch local_epoch-3 or older
+		free_limbo(t, i);
+		t->limbo_epoch[i] = t->local_epoch;
+	}
+	t->limbo[i].push_back(node);
+	if (++t->retires % RETIRE_SCAN == 0) try_advance_epoch();
+}
+
+inline void Index::try_advance_epoch()
+{
+	uint64_t e = global_epoch.load();
+	for (int i = 0; i < MAX_THREADS_POW2; i++) {
+		uint64_t a = threads[i].epoch.load();
+		if (a != QUIESCENT && a != e) return;
+	}
+	global_epoch.compare_exchange_strong(e, e + 1);
+}
+
+/******************************************************************************/
+/* Buckets                                                                    */
+/******************************************************************************/
+
+inline std::atomic<Index::node_t *> *Index::bucket_slot(uint64_t bucket)
+{
+	std::atomic<node_t *> *seg = segments[bucket >> SEGMENT_BITS].load();
+	if (seg == NULL) {
+		std::atomic<node_t *> *new_seg = new std::atomic<node_t *>[SEGMENT_SIZE]();
+		if (segments[bucket >> SEGMENT_BITS].compare_exchange_strong(seg, new_seg))
+			seg = new_seg;
+		else
+			delete[] new_seg;
+	}
+	return &seg[bucket & (SEGMENT_SIZE - 1)];
+}
+
+//> Returns the dummy node of `bucket`, inserting it (after the dummy of its
+//> parent bucket, i.e., the bucket without its most significant bit) if this
+//> is the first time the bucket is used.
+inline Index::node_t *Index::get_bucket(uint64_t bucket)
+{
+	std::atomic<node_t *> *slot = bucket_slot(bucket);
+	node_t *dummy = slot->load();
+	if (dummy != NULL) return dummy;
+
+	uint64_t parent = bucket & ~(1ULL << (63 - __builtin_clzll(bucket)));
+	node_t *parent_dummy = get_bucket(parent);
+	uint64_t so_key = so_dummy(bucket);
+	node_t *new_dummy = new node_t(so_key, 0);
+	while (1) {
+		node_t *prev, *curr;
+		if (list_find(parent_dummy, so_key, 0, &prev, &curr)) {
+			delete new_dummy;
+			new_dummy = curr;
+			break;
+		}
+		new_dummy->next.store((uintptr_t) curr);
+		uintptr_t expected = (uintptr_t) curr;
+		if (prev->next.compare_exchange_strong(expected, (uintptr_t) new_dummy))
+			break;
+	}
+	slot->store(new_dummy);
+	return new_dummy;
+}
+
+//> The number of keys is updated in batches, to keep the threads off a
+//> shared counter; the buckets double when there are LOAD_FACTOR keys per
+//> bucket on average.
+inline void Index::count_keys(int64_t delta)
+{
+	thread_data_t *t = &threads[tid];
+	t->count_delta += delta;
+	if (t->count_delta < COUNT_BATCH && t->count_delta > -COUNT_BATCH) return;
+	uint64_t n = nkeys.fetch_add(t->count_delta) + t->count_delta;
+	t->count_delta = 0;
+	uint64_t nb = nbuckets.load();
+	if (n > nb * LOAD_FACTOR && nb < MAX_SEGMENTS * SEGMENT_SIZE)
+		nbuckets.compare_exchange_strong(nb, nb * 2);
+}
+
+/******************************************************************************/
+/* The list                                                                   */
+/******************************************************************************/
+
+//> Finds the first node not before (so_key, key), starting from the dummy
+//> `start`, and unlinks (and retires) the deleted nodes it passes by.
+//> Returns whether that node has exactly that key.
+inline bool Index::list_find(node_t *start, uint64_t so_key, KEY_TYPE key,
+                             node_t **pprev, node_t **pcurr)
+{
+retry:
+	node_t *prev = start;
+	node_t *curr = ptr(prev->next.load());
+	while (curr != NULL) {
+		uintptr_t next = curr->next.load();
+		if (is_marked(next)) {
+			uintptr_t expected = (uintptr_t) curr;
+			if (!prev->next.compare_exchange_strong(expected, (uintptr_t) ptr(next)))
+				goto retry;
+			retire(curr);
+			curr = ptr(next);
+			continue;
+		}
+		if (!before(curr, so_key, key)) break;
+		prev = curr;
+		curr = ptr(next);
+	}
+	*pprev = prev;
+	*pcurr = curr;
+	return curr != NULL && curr->so_key == so_key && curr->key == key;
+}
+
+/******************************************************************************/
+/* Index operations                                                           */
+/******************************************************************************/
+
+inline RC Index::init(uint64_t bucket_cnt, int part_cnt)
+{
+	uint64_t nb = 1;
+	while (nb < bucket_cnt && nb < MAX_SEGMENTS * SEGMENT_SIZE) nb *= 2;
+	for (uint64_t i = 0; i < MAX_SEGMENTS; i++) segments[i].store(NULL);
+	for (int i = 0; i < MAX_THREADS_POW2; i++) {
+		threads[i].epoch.store(QUIESCENT);
+		threads[i].local_epoch = 0;
+		for (int j = 0; j < 3; j++) threads[i].limbo_epoch[j] = 0;
+		threads[i].retires = 0;
+		threads[i].count_delta = 0;
+	}
+	nbuckets.store(nb);
+	bucket_slot(0)->store(new node_t(so_dummy(0), 0));
+	return RCOK;
+}
+
+inline Index::~Index()
+{
+	node_t *curr = ptr(bucket_slot(0)->load()->next.load());
+	delete bucket_slot(0)->load();
+	while (curr != NULL) {
+		node_t *next = ptr(curr->next.load());
+		delete curr;
+		curr = next;
+	}
+	for (int i = 0; i < MAX_THREADS_POW2; i++)
+		for (int j = 0; j < 3; j++) free_limbo(&threads[i], j);
+	for (uint64_t i = 0; i < MAX_SEGMENTS; i++) delete[] segments[i].load();
+}
+
+inline RC Index::index_insert(KEY_TYPE key, VALUE_TYPE item, int part_id)
+{
+	epoch_guard_t guard(this);
+	uint64_t h = hash(key);
+	uint64_t so_key = so_regular(h);
+	node_t *bucket = get_bucket(h & (nbuckets.load() - 1));
+	node_t *node = NULL;
+
+	while (1) {
+		node_t *prev, *curr;
+		if (list_find(bucket, so_key, key, &prev, &curr)) {
+			VALUE_TYPE head = curr->items.load();
+			while (head != deleted_items()) {
+				item->next = head;
+				if (curr->items.compare_exchange_weak(head, item)) {
+					delete node;
+					INCREMENT_NUM_INSERTS(tid);
+					return RCOK;
+				}
+			}
+			//> The node is being deleted: help to unlink it and retry
+			curr->next.fetch_or(1);
+			continue;
+		}
+		if (node == NULL) node = new node_t(so_key, key);
+		item->next = NULL;
+		node->items.store(item);
+		node->next.store((uintptr_t) curr);
+		uintptr_t expected = (uintptr_t) curr;
+		if (prev->next.compare_exchange_strong(expected, (uintptr_t) node))
+			break;
+	}
+	count_keys(1);
+	INCREMENT_NUM_INSERTS(tid);
+	return RCOK;
+}
+
+// Items other than the first one are unlinked with a plain store, so the
+// items of the same key must not be removed concurrently (insertions may).
+inline RC Index::index_remove(KEY_TYPE key, VALUE_TYPE item, int part_id)
+{
+	epoch_guard_t guard(this);
+	uint64_t h = hash(key);
+	uint64_t so_key = so_regular(h);
+	node_t *bucket = get_bucket(h & (nbuckets.load() - 1));
+	node_t *prev, *curr;
+
+	if (!list_find(bucket, so_key, key, &prev, &curr)) return ERROR;
+	VALUE_TYPE head = curr->items.load();
+	while (head == item) {
+		if (curr->items.compare_exchange_weak(head, item->next)) break;
+	}
+	if (head == deleted_items() || head == NULL) return ERROR;
+	if (head != item) {
+		VALUE_TYPE p = head;
+		while (p != NULL && p->next != item) p = p->next;
+		if (p == NULL) return ERROR;
+		p->next = item->next;
+		return RCOK;
+	}
+
+	//> The last item is gone: delete the node, unless one was just added
+	VALUE_TYPE expected = NULL;
+	if (curr->items.compare_exchange_strong(expected, deleted_items())) {
+		curr->next.fetch_or(1);
+		list_find(bucket, so_key, key, &prev, &curr);
+		count_keys(-1);
+	}
+	return RCOK;
+}
+
+inline RC Index::index_read(KEY_TYPE key, VALUE_TYPE * item, int part_id, int thd_id)
+{
+	epoch_guard_t guard(this);
+	uint64_t h = hash(key);
+	uint64_t so_key = so_regular(h);
+	node_t *bucket = get_bucket(h & (nbuckets.load() - 1));
+	node_t *prev, *curr;
+
+	*item = NULL;
+	if (list_find(bucket, so_key, key, &prev, &curr)) {
+		VALUE_TYPE head = curr->items.load();
+		if (head != deleted_items()) *item = head;
+	}
+	INCREMENT_NUM_READS(tid);
+	return RCOK;
+}
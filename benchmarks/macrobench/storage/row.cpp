@@ -22,7 +22,7 @@ row_t::init(table_t * host_table, uint64_t part_id, uint64_t row_id) {
 	this->table = host_table;
 	Catalog * schema = host_table->get_schema();
 	int tuple_size = schema->get_tuple_size();
-	data = (char *) _mm_malloc(sizeof(char) * tuple_size, ALIGNMENT);
+	data = (char *) mem_allocator.alloc(sizeof(char) * tuple_size, part_id);
 	return RCOK;
 }
 
@@ -30,7 +30,7 @@ void
 row_t::init(int size) 
 {
     manager = NULL;
-    data = (char *) _mm_malloc(size, ALIGNMENT);
+    data = (char *) mem_allocator.alloc(size, 0);
 }
 
 RC 
@@ -131,7 +131,7 @@ void row_t::copy(row_t * src) {
 }
 
 void row_t::free_row() {
-	free(data);
+	mem_allocator.free(data, 0);
 }
 
 RC row_t::get_row(access_t type, txn_man * txn, row_t *& row) {
@@ -21,7 +21,7 @@ RC table_t::get_new_row(row_t *& row, uint64_t part_id, uint64_t &row_id) {
 	RC rc = RCOK;
 	cur_tab_size ++;
 	
-	row = (row_t *) _mm_malloc(sizeof(row_t), ALIGNMENT);
+	row = (row_t *) mem_allocator.alloc(sizeof(row_t), part_id);
 	rc = row->init(this, part_id, row_id);
 	row->init_manager(row);
 
@@ -49,18 +49,26 @@ double g_read_perc = READ_PERC;
 double g_write_perc = WRITE_PERC;
 double g_zipf_theta = ZIPF_THETA;
 bool g_prt_lat_distr = PRT_LAT_DISTR;
+UInt64 g_warmup = WARMUP;
+UInt64 g_max_txn_per_part = MAX_TXN_PER_PART;
+bool g_first_part_local = FIRST_PART_LOCAL;
 UInt32 g_part_cnt = PART_CNT;
 UInt32 g_virtual_part_cnt = VIRTUAL_PART_CNT;
 UInt32 g_thread_cnt = THREAD_CNT;
 UInt64 g_synth_table_size = SYNTH_TABLE_SIZE;
 UInt32 g_req_per_query = REQ_PER_QUERY;
+UInt32 g_scan_len = SCAN_LEN;
+UInt32 g_scan_len_dist = SCAN_LEN_DIST;
 UInt32 g_field_per_tuple = FIELD_PER_TUPLE;
 UInt32 g_init_parallelism = INIT_PARALLELISM;
 
 UInt32 g_num_wh = NUM_WH;
 double g_perc_payment = PERC_PAYMENT;
+double g_perc_delivery = PERC_DELIVERY;
 bool g_wh_update = WH_UPDATE;
+bool g_tpcc_access_all = TPCC_ACCESS_ALL;
 char * output_file = NULL;
+char * results_file = NULL;
 
 map<string, string> g_params;
 
@@ -73,6 +73,9 @@ extern string g_thr_pinning_policy;
 extern bool g_part_alloc;
 extern bool g_mem_pad;
 extern bool g_prt_lat_distr;
+extern UInt64 g_warmup;
+extern UInt64 g_max_txn_per_part;
+extern bool g_first_part_local;
 extern UInt32 g_part_cnt;
 extern UInt32 g_virtual_part_cnt;
 extern UInt32 g_thread_cnt;
@@ -89,6 +92,7 @@ extern UInt32 g_ts_batch_num;
 extern map<string, string> g_params;
 
 #include "../../../../trevor_brown_ppopp20_interpolation_trees/common/papi/papi_util.h"
+#include "PerfCounters.h"
 
 // YCSB
 extern UInt32 g_cc_alg;
@@ -100,14 +104,19 @@ extern double g_write_perc;
 extern double g_zipf_theta;
 extern UInt64 g_synth_table_size;
 extern UInt32 g_req_per_query;
+extern UInt32 g_scan_len;
+extern UInt32 g_scan_len_dist;
 extern UInt32 g_field_per_tuple;
 extern UInt32 g_init_parallelism;
 
 // TPCC
 extern UInt32 g_num_wh;
 extern double g_perc_payment;
+extern double g_perc_delivery;
 extern bool g_wh_update;
+extern bool g_tpcc_access_all;
 extern char * output_file;
+extern char * results_file;
 extern UInt32 g_max_items;
 extern UInt32 g_cust_per_dist;
 
@@ -4,6 +4,7 @@
 #include <iostream>
 #include <stdint.h>
 #include "global.h"
+#include "Timer.h"
 
 
 /************************************************/
@@ -168,21 +169,9 @@ uint64_t get_part_id(void * addr);
 //uint64_t merge_idx_key(uint64_t key1, uint64_t key2, uint64_t key3);
 
 extern timespec * res;
+// in ns; the TSC, with its rate calibrated at startup, where it is invariant.
 inline uint64_t get_server_clock() {
-#if defined(__i386__)
-    uint64_t ret;
-    __asm__ __volatile__("rdtsc" : "=A" (ret));
-#elif defined(__x86_64__)
-    unsigned hi, lo;
-    __asm__ __volatile__ ("rdtsc" : "=a"(lo), "=d"(hi));
-    uint64_t ret = ( (uint64_t)lo)|( ((uint64_t)hi)<<32 );
-	ret = (uint64_t) ((double)ret / CPU_FREQ_GHZ);
-#else 
-	timespec * tp = new timespec;
-    clock_gettime(CLOCK_REALTIME, tp);
-    uint64_t ret = tp->tv_sec * 1000000000 + tp->tv_nsec;
-#endif
-    return ret;
+	return Timer::now_ns();
 }
 
 inline uint64_t get_sys_clock() {
@@ -29,6 +29,8 @@ int main(int argc, char *argv[])
 	thread_pinning::configurePolicy(g_thread_cnt, g_thr_pinning_policy);
 	
 	papi_init_program(g_thread_cnt);
+	PerfCounters::init(g_thread_cnt);
+	Timer::init();
 	mem_allocator.init(g_part_cnt, MEM_SIZE / g_part_cnt);
 	stats.init();
 	glob_manager = (Manager *) _mm_malloc(sizeof(Manager), ALIGNMENT);
@@ -91,7 +93,7 @@ int main(int argc, char *argv[])
 	for (uint32_t i = 0; i < thd_cnt; i++)
 		m_thds[i]->init(i, m_wl);
 
-	if (WARMUP > 0) {
+	if (g_warmup > 0) {
 		printf("WARMUP start!\n");
 		for (uint32_t i = 0; i < thd_cnt; i++)
 			pthread_create(&p_thds[i], NULL, f_warmup, (void *)((uint64_t)i));
@@ -148,6 +150,7 @@ void *f_real(void *id)
 	tid = __tid;
 	thread_pinning::bindThread(__tid);
 	papi_create_eventset(__tid);
+	PerfCounters::open(__tid);
 	#ifdef VERBOSE_1
 	cout<<"REAL: Assigned thread ID="<<tid<<std::endl;
 	#endif
@@ -16,6 +16,20 @@ void Manager::init() {
 	for (uint32_t i = 0; i < g_thread_cnt; i++) 
 		all_ts[i] = (ts_t *) _mm_malloc(sizeof(ts_t), ALIGNMENT);
 
+	_hw_ts_base = Timer::now();
+	_last_hw_ts = (ts_t **) _mm_malloc(sizeof(ts_t *) * g_thread_cnt, ALIGNMENT);
+	for (uint32_t i = 0; i < g_thread_cnt; i++) {
+		_last_hw_ts[i] = (ts_t *) _mm_malloc(CL_SIZE, CL_SIZE);
+		*_last_hw_ts[i] = 0;
+	}
+	// the clock-based timestamps are unique per thread, not consecutive
+	if (g_ts_batch_alloc && (g_ts_alloc == TS_HW || g_ts_alloc == TS_CLOCK)) {
+		printf("Timestamp batching is ignored with TS_HW and TS_CLOCK\n");
+		g_ts_batch_alloc = false;
+	}
+	if (g_ts_batch_alloc && g_ts_batch_num == 0)
+		g_ts_batch_alloc = false;
+
 	_all_txns = new txn_man * [g_thread_cnt];
 	for (UInt32 i = 0; i < g_thread_cnt; i++) {
 		*all_ts[i] = UINT64_MAX;
@@ -27,8 +41,6 @@ void Manager::init() {
 
 uint64_t 
 Manager::get_ts(uint64_t thread_id) {
-	if (g_ts_batch_alloc)
-		assert(g_ts_alloc == TS_CAS);
 	uint64_t time;
 //	uint64_t starttime = get_sys_clock();
 	switch(g_ts_alloc) {
@@ -38,13 +50,10 @@ Manager::get_ts(uint64_t thread_id) {
 		pthread_mutex_unlock( &ts_mutex );
 		break;
 	case TS_CAS :
-		if (g_ts_batch_alloc)
-			time = ATOM_FETCH_ADD((*timestamp), g_ts_batch_num);
-		else 
-			time = ATOM_FETCH_ADD((*timestamp), 1);
+		time = ATOM_FETCH_ADD((*timestamp), 1);
 		break;
 	case TS_HW :
-		assert(false);
+		time = get_hw_ts(thread_id);
 		break;
 	case TS_CLOCK :
 		time = get_sys_clock() * g_thread_cnt + thread_id;
@@ -56,6 +65,37 @@ Manager::get_ts(uint64_t thread_id) {
 	return time;
 }
 
+uint64_t 
+Manager::get_ts_lease(uint64_t thread_id, uint64_t count) {
+	uint64_t time;
+	switch(g_ts_alloc) {
+	case TS_MUTEX :
+		pthread_mutex_lock( &ts_mutex );
+		time = *timestamp + 1;
+		*timestamp += count;
+		pthread_mutex_unlock( &ts_mutex );
+		break;
+	case TS_CAS :
+		time = ATOM_FETCH_ADD((*timestamp), count);
+		break;
+	default :
+		assert(false);
+	}
+	return time;
+}
+
+// The TSC (see Timer) of the calling core times the number of threads, plus
+// the thread id. It is unique and increasing per thread, without any shared
+// write; across threads the order is as good as the synchronization of the
+// TSCs of the cores, which only needs to be loose for the CC algorithms.
+ts_t Manager::get_hw_ts(uint64_t thread_id) {
+	ts_t time = (Timer::now() - _hw_ts_base) * g_thread_cnt + thread_id;
+	if (time <= *_last_hw_ts[thread_id])
+		time = *_last_hw_ts[thread_id] + g_thread_cnt;
+	*_last_hw_ts[thread_id] = time;
+	return time;
+}
+
 ts_t Manager::get_min_ts(uint64_t tid) {
 	uint64_t now = get_sys_clock();
 	uint64_t last_time = _last_min_ts_time; 
@@ -11,6 +11,8 @@ public:
 	void 			init();
 	// returns the next timestamp.
 	ts_t			get_ts(uint64_t thread_id);
+	// returns the first of `count` consecutive timestamps (TS_MUTEX, TS_CAS).
+	ts_t			get_ts_lease(uint64_t thread_id, uint64_t count);
 
 	// For MVCC. To calculate the min active ts in the system
 	void 			add_ts(uint64_t thd_id, ts_t ts);
@@ -33,6 +35,10 @@ private:
 
 	pthread_mutex_t ts_mutex;
 	uint64_t *		timestamp;
+	// for TS_HW. The last timestamp of each thread, one per cache line.
+	ts_t			get_hw_ts(uint64_t thread_id);
+	uint64_t		_hw_ts_base;
+	ts_t ** 		_last_hw_ts;
 	pthread_mutex_t mutexes[BUCKET_CNT];
 	uint64_t 		hash(row_t * row);
 	ts_t volatile * volatile * volatile all_ts;
@@ -1,155 +1,104 @@
+#include <mm_malloc.h>
 #include "mem_alloc.h"
 #include "helper.h"
 #include "global.h"
 
-// Assume the data is strided across the L2 slices, stride granularity 
-// is the size of a page
+// The arenas of the calling thread, one per size class.
+static __thread Arena * thread_arenas = NULL;
+
 void mem_alloc::init(uint64_t part_cnt, uint64_t bytes_per_part) {
-//	if (g_thread_cnt < g_init_parallelism)
-//		_bucket_cnt = g_init_parallelism * 4 + 1;
-//	else
-//		_bucket_cnt = g_thread_cnt * 4 + 1;
-//	pid_arena = new std::pair<pthread_t, int>[_bucket_cnt];
-//	for (int i = 0; i < _bucket_cnt; i ++)
-//		pid_arena[i] = std::make_pair(0, 0);
-//
-//	if (THREAD_ALLOC) {
-//		assert( !g_part_alloc );
-//		init_thread_arena();
-//	}
+	if (THREAD_ALLOC)
+		assert( !g_part_alloc );
 }
 
-//void 
-//Arena::init(int arena_id, int size) {
-//	_buffer = NULL;
-//	_arena_id = arena_id;
-//	_size_in_buffer = 0;
-//	_head = NULL;
-//	_block_size = size;
-//}
-
-//void *
-//Arena::alloc() {
-//	FreeBlock * block;
-//	if (_head == NULL) {
-//		// not in the list. allocate from the buffer
-//		int size = (_block_size + sizeof(FreeBlock) + (MEM_ALLIGN - 1)) & ~(MEM_ALLIGN-1);
-//		if (_size_in_buffer < size) {
-//			_buffer = (char *) malloc(_block_size * 40960);
-//			_size_in_buffer = _block_size * 40960; // * 8;
-//		}
-//		block = (FreeBlock *)_buffer;
-//		block->size = _block_size;
-//		_size_in_buffer -= size;
-//		_buffer = _buffer + size;
-//	} else {
-//		block = _head;
-//		_head = _head->next;
-//	}
-//	return (void *) ((char *)block + sizeof(FreeBlock));
-//}
-//
-//void
-//Arena::free(void * ptr) {
-//	FreeBlock * block = (FreeBlock *)((UInt64)ptr - sizeof(FreeBlock));
-//	block->next = _head;
-//	_head = block;
-//}
-
-//void mem_alloc::init_thread_arena() {
-//	UInt32 buf_cnt = g_thread_cnt;
-//	if (buf_cnt < g_init_parallelism)
-//		buf_cnt = g_init_parallelism;
-//	_arenas = new Arena * [buf_cnt];
-//	for (UInt32 i = 0; i < buf_cnt; i++) {
-//		_arenas[i] = new Arena[SizeNum];
-//		for (int n = 0; n < SizeNum; n++) {
-//			assert(sizeof(Arena) == 128);
-//			_arenas[i][n].init(i, BlockSizes[n]);
-//		}
-//	}
-//}
+void
+Arena::init(int size_id) {
+	_buffer = NULL;
+	_size_in_buffer = 0;
+	_size_id = size_id;
+	_block_size = BlockSizes[size_id];
+	_head = NULL;
+}
 
-void mem_alloc::register_thread(int thd_id) {
-//	if (THREAD_ALLOC) {
-//		pthread_mutex_lock( &map_lock );
-//		pthread_t pid = pthread_self();
-//		int entry = pid % _bucket_cnt;
-//		while (pid_arena[ entry ].first != 0) {
-//			printf("conflict at entry %d (pid=%ld)\n", entry, pid);
-//			entry = (entry + 1) % _bucket_cnt;
-//		}
-//		pid_arena[ entry ].first = pid;
-//		pid_arena[ entry ].second = thd_id;
-//		pthread_mutex_unlock( &map_lock );
-//	}
+void *
+Arena::alloc() {
+	FreeBlock * block;
+	if (_head == NULL) {
+		// not in the list. allocate from the buffer
+		if (_size_in_buffer < (uint64_t) _block_size) {
+			_buffer = (char *) _mm_malloc(THREAD_ARENA_SIZE, CL_SIZE);
+			M_ASSERT(_buffer != NULL, "Arena: out of memory\n");
+			_size_in_buffer = THREAD_ARENA_SIZE;
+			// the header goes at the end of a cache line, before the block
+			if (_block_size >= CL_SIZE) {
+				_buffer += CL_SIZE - sizeof(FreeBlock);
+				_size_in_buffer -= CL_SIZE;
+			}
+		}
+		block = (FreeBlock *)_buffer;
+		block->size_id = _size_id;
+		_size_in_buffer -= _block_size;
+		_buffer = _buffer + _block_size;
+	} else {
+		block = _head;
+		_head = _head->next;
+	}
+	return (void *) (block + 1);
 }
 
-void mem_alloc::unregister() {
-//	if (THREAD_ALLOC) {
-//		pthread_mutex_lock( &map_lock );
-//		for (int i = 0; i < _bucket_cnt; i ++) {
-//			pid_arena[i].first = 0;
-//			pid_arena[i].second = 0;
-//		}
-//		pthread_mutex_unlock( &map_lock );
-//	}
+void
+Arena::free(FreeBlock * block) {
+	block->next = _head;
+	_head = block;
 }
 
-//int 
-//mem_alloc::get_arena_id() {
-//	int arena_id; 
-//	pthread_t pid = pthread_self();
-//	int entry = pid % _bucket_cnt;
-//	while (pid_arena[entry].first != pid) {
-//		if (pid_arena[entry].first == 0)
-//			break;
-//		entry = (entry + 1) % _bucket_cnt;
-//	}
-//	arena_id = pid_arena[entry].second;
-//	return arena_id;
-//}
-//
-//int 
-//mem_alloc::get_size_id(UInt32 size) {
-//	for (int i = 0; i < SizeNum; i++) {
-//		if (size <= BlockSizes[i]) 
-//			return i;
-//	}
-//    printf("size = %d\n", size);
-//	assert( false );
-//}
+Arena * mem_alloc::get_thread_arenas() {
+	if (thread_arenas == NULL) {
+		thread_arenas = (Arena *) _mm_malloc(sizeof(Arena) * SizeNum, CL_SIZE);
+		for (int n = 0; n < SizeNum; n++) {
+			assert(sizeof(Arena) == CL_SIZE);
+			thread_arenas[n].init(n);
+		}
+	}
+	return thread_arenas;
+}
 
+int
+mem_alloc::get_size_id(uint64_t size) {
+	for (int i = 0; i < SizeNum; i++) {
+		if (size + sizeof(FreeBlock) <= BlockSizes[i])
+			return i;
+	}
+	return -1;
+}
 
 void mem_alloc::free(void * ptr, uint64_t size) {
 	if (NO_FREE_B) {
-//	} else if (THREAD_ALLOC) {
-//		int arena_id = get_arena_id();
-//		FreeBlock * block = (FreeBlock *)((UInt64)ptr - sizeof(FreeBlock));
-//		int size = block->size;
-//		int size_id = get_size_id(size);
-//		_arenas[arena_id][size_id].free(ptr);
+	} else if (THREAD_ALLOC) {
+		FreeBlock * block = (FreeBlock *)ptr - 1;
+		if (block->size_id < 0)
+			_mm_free((char *)ptr - CL_SIZE);
+		else
+			get_thread_arenas()[block->size_id].free(block);
 	} else {
 		std::free(ptr);
 	}
 }
 
-//TODO the program should not access more than a PAGE
-// to guanrantee correctness
-// lock is used for consistency (multiple threads may alloc simultaneously and 
-// cause trouble)
+// Blocks larger than the largest size class come from _mm_malloc, with a
+// cache line in front of them for the header.
 void * mem_alloc::alloc(uint64_t size, uint64_t part_id) {
 	void * ptr;
-//    if (size > BlockSizes[SizeNum - 1])
-//        ptr = malloc(size);
-//	else if (THREAD_ALLOC && (warmup_finish || enable_thread_mem_pool)) {
-//		int arena_id = get_arena_id();
-//		int size_id = get_size_id(size);
-//		ptr = _arenas[arena_id][size_id].alloc();
-//	} else {
+	if (THREAD_ALLOC) {
+		int size_id = get_size_id(size);
+		if (size_id >= 0) {
+			ptr = get_thread_arenas()[size_id].alloc();
+		} else {
+			ptr = (char *) _mm_malloc(size + CL_SIZE, CL_SIZE) + CL_SIZE;
+			((FreeBlock *)ptr - 1)->size_id = -1;
+		}
+	} else {
 		ptr = malloc(size);
-//	}
+	}
 	return ptr;
 }
-
-
@@ -3,43 +3,43 @@
 #include "global.h"
 #include <map>
 
-const int SizeNum = 4;
-const UInt32 BlockSizes[] = {32, 64, 256, 1024};
+// Block sizes of the size classes, including the header of each block.
+// Blocks of CL_SIZE bytes or more are laid out so that the memory returned
+// is cache-line aligned.
+const int SizeNum = 9;
+const UInt32 BlockSizes[] = {32, 48, 64, 128, 256, 512, 1024, 2048, 4096};
 
+// The header of every block allocated with THREAD_ALLOC.
 typedef struct free_block {
-    int size;
+    int size_id; // -1 for blocks larger than the largest size class
     struct free_block* next;
 } FreeBlock;
 
+// The blocks of one size class of one thread: the free list, and the rest
+// of the last buffer of THREAD_ARENA_SIZE bytes, carved on demand.
 class Arena {
 public:
-	void init(int arena_id, int size);
+	void init(int size_id);
 	void * alloc();
-	void free(void * ptr);
+	void free(FreeBlock * block);
 private:
 	char * 		_buffer;
-	int 		_size_in_buffer;
-	int 		_arena_id;
+	uint64_t 	_size_in_buffer;
+	int 		_size_id;
 	int 		_block_size;
 	FreeBlock * _head;
-	char 		_pad[128 - sizeof(int)*3 - sizeof(void *)*2 - 8];
+	char 		_pad[CL_SIZE - sizeof(void *)*2 - sizeof(uint64_t) - sizeof(int)*2];
 };
 
+// With THREAD_ALLOC, every thread allocates from its own arenas, one per
+// size class, created the first time it allocates; a block is freed to the
+// arena of the thread that frees it. Otherwise this is malloc/free.
 class mem_alloc {
 public:
     void init(uint64_t part_cnt, uint64_t bytes_per_part);
-    void register_thread(int thd_id);
-    void unregister();
     void * alloc(uint64_t size, uint64_t part_id);
     void free(void * block, uint64_t size);
-	int get_arena_id();
 private:
-    void init_thread_arena();
-	int get_size_id(UInt32 size);
-	
-	// each thread has several arenas for different block size
-	Arena ** _arenas;
-	int _bucket_cnt;
-    std::pair<pthread_t, int>* pid_arena;//                     max_arena_id;
-    pthread_mutex_t         map_lock; // only used for pid_to_arena update
+	Arena * get_thread_arenas();
+	int get_size_id(uint64_t size);
 };
@@ -1,5 +1,6 @@
 #include "global.h"
 #include "helper.h"
+#include "MapStats.h"
 #include <string>
 
 void print_usage()
@@ -10,18 +11,23 @@ void print_usage()
 	printf("\t-tINT       ; THREAD_CNT\n");
 	printf("\t-qINT       ; QUERY_INTVL\n");
 	printf("\t-dINT       ; PRT_LAT_DISTR\n");
-	printf("\t-aINT       ; PART_ALLOC (0 or 1)\n");
+	printf("\t-aINT       ; PART_ALLOC (0 or 1, 1 only without THREAD_ALLOC)\n");
 	printf("\t-mINT       ; MEM_PAD (0 or 1)\n");
+	printf("\t-iINT       ; INIT_PARALLELISM\n");
+	printf("\t-WINT       ; WARMUP (transactions)\n");
+	printf("\t-NINT       ; MAX_TXN_PER_PART (transactions per thread)\n");
+	printf("\t-lINT       ; FIRST_PART_LOCAL (0 or 1)\n");
 	printf("\t-GaINT      ; ABORT_PENALTY (in ms)\n");
 	printf("\t-GcINT      ; CENTRAL_MAN\n");
-	printf("\t-GtINT      ; TS_ALLOC\n");
+	printf("\t-GtINT      ; TS_ALLOC (1: mutex, 2: cas, 3: hw, 4: clock)\n");
 	printf("\t-GkINT      ; KEY_ORDER\n");
 	printf("\t-GnINT      ; NO_DL\n");
 	printf("\t-GoINT      ; TIMEOUT\n");
 	printf("\t-GlINT      ; DL_LOOP_DETECT\n");
-	printf("\t-GbINT      ; TS_BATCH_ALLOC\n");
+	printf("\t-GbINT      ; TS_BATCH_ALLOC (per-thread leases of TS_BATCH_NUM timestamps)\n");
 	printf("\t-GuINT      ; TS_BATCH_NUM\n");
-	printf("\t-o STRING   ; output file\n\n");
+	printf("\t-o STRING   ; output file\n");
+	printf("\t-j STRING   ; JSON results file\n\n");
 
 	printf("  [Index Data structures]:\n");
 	printf("\t--data-structure=STRING  ; data structure type\n");
@@ -35,12 +41,16 @@ void print_usage()
 	printf("\t-zFLOAT     ; ZIPF_THETA\n");
 	printf("\t-sINT       ; SYNTH_TABLE_SIZE\n");
 	printf("\t-RINT       ; REQ_PER_QUERY\n");
+	printf("\t-SlINT      ; SCAN_LEN (the rest of READ_PERC + WRITE_PERC are scans)\n");
+	printf("\t-SdINT      ; SCAN_LEN_DIST (1: constant, 2: uniform, 3: zipfian)\n");
 	printf("\t-fINT       ; FIELD_PER_TUPLE\n\n");
 
 	printf("  [TPCC]:\n");
 	printf("\t-nINT       ; NUM_WH\n");
 	printf("\t-TpFLOAT    ; PERC_PAYMENT\n");
-	printf("\t-TuINT      ; WH_UPDATE\n\n");
+	printf("\t-TdFLOAT    ; PERC_DELIVERY\n");
+	printf("\t-TuINT      ; WH_UPDATE\n");
+	printf("\t-TaINT      ; TPCC_ACCESS_ALL\n\n");
 
 	printf("  [TEST]:\n");
 	printf("\t-Ar         ; Test READ_WRITE\n");
@@ -67,6 +77,10 @@ void parser(int argc, char * argv[])
 		else if (argv[i][1]=='a') g_part_alloc = atoi(&argv[i][2]);
 		else if (argv[i][1]=='m') g_mem_pad = atoi(&argv[i][2]);
 		else if (argv[i][1]=='q') g_query_intvl = atoi(&argv[i][2]);
+		else if (argv[i][1]=='i') g_init_parallelism = atoi(&argv[i][2]);
+		else if (argv[i][1]=='W') g_warmup = atol(&argv[i][2]);
+		else if (argv[i][1]=='N') g_max_txn_per_part = atol(&argv[i][2]);
+		else if (argv[i][1]=='l') g_first_part_local = atoi(&argv[i][2]);
 		else if (argv[i][1]=='c') g_part_per_txn = atoi(&argv[i][2]);
 		else if (argv[i][1]=='e') g_perc_multi_part = atof(&argv[i][2]);
 		else if (argv[i][1]=='r') g_read_perc = atof(&argv[i][2]);
@@ -90,15 +104,23 @@ void parser(int argc, char * argv[])
 			else if (argv[i][2]=='l') g_dl_loop_detect = atoi(&argv[i][3]);
 			else if (argv[i][2]=='b') g_ts_batch_alloc = atoi(&argv[i][3]);
 			else if (argv[i][2]=='u') g_ts_batch_num = atoi(&argv[i][3]);
+		} else if (argv[i][1]=='S') {
+			if (argv[i][2]=='l') g_scan_len = atoi(&argv[i][3]);
+			if (argv[i][2]=='d') g_scan_len_dist = atoi(&argv[i][3]);
 		} else if (argv[i][1]=='T') {
 			if (argv[i][2]=='p') g_perc_payment = atof(&argv[i][3]);
+			if (argv[i][2]=='d') g_perc_delivery = atof(&argv[i][3]);
 			if (argv[i][2]=='u') g_wh_update = atoi(&argv[i][3]);
+			if (argv[i][2]=='a') g_tpcc_access_all = atoi(&argv[i][3]);
 		} else if (argv[i][1]=='A') {
 			if (argv[i][2]=='r') g_test_case = READ_WRITE;
 			if (argv[i][2]=='c') g_test_case = CONFLICT;
 		} else if (argv[i][1]=='o') {
 			i++;
 			output_file = argv[i];
+		} else if (argv[i][1]=='j') {
+			i++;
+			results_file = argv[i];
 		} else if (argv[i][1]=='h') {
 			print_usage();
 			exit(0);
@@ -114,6 +136,16 @@ void parser(int argc, char * argv[])
 			assert(false);
 		}
 	}
+	// the internal events of the indexes are counted in per-thread slots
+	if (g_thread_cnt > MAP_STATS_MAX_THREADS) {
+		printf("At most %d threads are supported\n", MAP_STATS_MAX_THREADS);
+		exit(1);
+	}
+	// the per-thread arenas replace the per-partition allocation
+	if (THREAD_ALLOC && g_part_alloc) {
+		printf("PART_ALLOC (-a1) can not be used with THREAD_ALLOC\n");
+		exit(1);
+	}
 	g_init_parallelism = g_thread_cnt;
 	if (g_thread_cnt >= 22) g_init_parallelism = 8;
 }
@@ -68,7 +68,7 @@ void *Query_queue::threadInitQuery(void *This)
 /*************************************************/
 //     class Query_thd
 /*************************************************/
-#define CALC_REQUEST_COUNT (WARMUP / g_thread_cnt + MAX_TXN_PER_PART + 4)
+#define CALC_REQUEST_COUNT (g_warmup / g_thread_cnt + g_max_txn_per_part + 4)
 
 void Query_thd::init(workload *h_wl, int thread_id)
 {
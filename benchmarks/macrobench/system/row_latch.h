@@ -0,0 +1,52 @@
+#pragma once
+
+#include <stdint.h>
+#include <unistd.h>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+
+// The latch of a row manager, one word embedded in the manager instead of a
+// pthread mutex allocated for every row. A thread that finds it held spins
+// for a while and then sleeps on a futex, so the latch also behaves when
+// there are more threads than cores.
+class row_latch {
+public:
+	void init() { _word = FREE; }
+
+	void lock() {
+		uint32_t c = FREE;
+		if (__atomic_compare_exchange_n(&_word, &c, HELD, false,
+		                                __ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+			return;
+		for (int i = 0; i < SPIN_COUNT; i++) {
+			asm volatile("pause" ::: "memory");
+			c = FREE;
+			if (_word == FREE
+			    && __atomic_compare_exchange_n(&_word, &c, HELD, false,
+			                                   __ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+				return;
+		}
+		// From now on the holder must wake someone up when it unlocks.
+		while (__atomic_exchange_n(&_word, CONTENDED, __ATOMIC_ACQUIRE) != FREE)
+			syscall(SYS_futex, &_word, FUTEX_WAIT_PRIVATE, CONTENDED, NULL, NULL, 0);
+	}
+
+	bool try_lock() {
+		uint32_t c = FREE;
+		return __atomic_compare_exchange_n(&_word, &c, HELD, false,
+		                                   __ATOMIC_ACQUIRE, __ATOMIC_RELAXED);
+	}
+
+	void unlock() {
+		if (__atomic_exchange_n(&_word, FREE, __ATOMIC_RELEASE) == CONTENDED)
+			syscall(SYS_futex, &_word, FUTEX_WAKE_PRIVATE, 1, NULL, NULL, 0);
+	}
+
+private:
+	static const uint32_t FREE = 0;
+	static const uint32_t HELD = 1;
+	static const uint32_t CONTENDED = 2; // held, and there may be sleepers
+	static const int SPIN_COUNT = 128;
+
+	volatile uint32_t _word;
+};
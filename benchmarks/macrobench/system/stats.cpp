@@ -3,6 +3,9 @@
 #include "stats.h"
 #include "mem_alloc.h"
 #include "wl.h"
+#include "table.h"
+#include "JsonString.h"
+#include <algorithm>
 
 #define BILLION 1000000000UL
 
@@ -10,9 +13,9 @@ void Stats_thd::init(uint64_t thd_id)
 {
 	clear();
 	all_debug1 = (uint64_t *)
-		_mm_malloc(sizeof(uint64_t) * MAX_TXN_PER_PART, ALIGNMENT);
+		_mm_malloc(sizeof(uint64_t) * g_max_txn_per_part, ALIGNMENT);
 	all_debug2 = (uint64_t *)
-		_mm_malloc(sizeof(uint64_t) * MAX_TXN_PER_PART, ALIGNMENT);
+		_mm_malloc(sizeof(uint64_t) * g_max_txn_per_part, ALIGNMENT);
 }
 
 void Stats_thd::clear()
@@ -40,9 +43,11 @@ void Stats_tmp_index::clear()
 	timeContains = 0;
 	timeInsert = 0;
 	timeRangeQuery = 0;
+	timeRemove = 0;
 	numContains = 0;
 	numInsert = 0;
 	numRangeQuery = 0;
+	numRemove = 0;
 }
 
 void Stats_tmp::init()
@@ -119,9 +124,11 @@ void Stats::commit(uint64_t thd_id)
 		COMMIT_ACCUMULATE(timeContains);
 		COMMIT_ACCUMULATE(timeInsert);
 		COMMIT_ACCUMULATE(timeRangeQuery);
+		COMMIT_ACCUMULATE(timeRemove);
 		COMMIT_ACCUMULATE(numContains);
 		COMMIT_ACCUMULATE(numInsert);
 		COMMIT_ACCUMULATE(numRangeQuery);
+		COMMIT_ACCUMULATE(numRemove);
 		tmp_stats[thd_id]->init();
 	}
 }
@@ -184,16 +191,20 @@ void Stats::print(workload * wl)
 			LOAD_STAT(index, tid, timeInsert);
 			LOAD_STAT(index, tid, numRangeQuery);
 			LOAD_STAT(index, tid, timeRangeQuery);
+			LOAD_STAT(index, tid, numRemove);
+			LOAD_STAT(index, tid, timeRemove);
 			timeContains /= BILLION;
 			timeInsert /= BILLION;
 			timeRangeQuery /= BILLION;
-			uint64_t ixTotalOps = numContains + numInsert + numRangeQuery;
-			double ixTotalTime = timeContains + timeInsert + timeRangeQuery;
+			timeRemove /= BILLION;
+			uint64_t ixTotalOps = numContains + numInsert + numRangeQuery + numRemove;
+			double ixTotalTime = timeContains + timeInsert + timeRangeQuery + timeRemove;
 			double ixThroughput = ixTotalOps / (ixTotalTime / g_thread_cnt);
 			printf("Per-thread per-index stats: index=%s, thread=%d"
 			       ", numContains=%ld, timeContains=%f"
 			       ", numInsert=%ld, timeInsert=%f"
 			       ", numRangeQuery=%ld, timeRangeQuery=%f"
+			       ", numRemove=%ld, timeRemove=%f"
 			       ", totalOperations=%ld, totalTime=%f, throughput=%f\n"
 			       , index->index_name.c_str()
 			       , tid
@@ -203,6 +214,8 @@ void Stats::print(workload * wl)
 			       , timeInsert
 			       , numRangeQuery
 			       , timeRangeQuery
+			       , numRemove
+			       , timeRemove
 			       , ixTotalOps
 			       , ixTotalTime
 			       , ixThroughput);
@@ -219,6 +232,8 @@ void Stats::print(workload * wl)
 		double timeInsert = 0;
 		uint64_t numRangeQuery = 0;
 		double timeRangeQuery = 0;
+		uint64_t numRemove = 0;
+		double timeRemove = 0;
 		for (int tid=0;tid<g_thread_cnt;++tid) {
 			ACCUM_STAT(index, tid, numContains);
 			ACCUM_STAT(index, tid, timeContains);
@@ -226,18 +241,22 @@ void Stats::print(workload * wl)
 			ACCUM_STAT(index, tid, timeInsert);
 			ACCUM_STAT(index, tid, numRangeQuery);
 			ACCUM_STAT(index, tid, timeRangeQuery);
+			ACCUM_STAT(index, tid, numRemove);
+			ACCUM_STAT(index, tid, timeRemove);
 		}
 		timeContains /= BILLION;
 		timeInsert /= BILLION;
 		timeRangeQuery /= BILLION;
+		timeRemove /= BILLION;
 
-		uint64_t ixTotalOps = numContains + numInsert + numRangeQuery;
-		double ixTotalTime = timeContains + timeInsert + timeRangeQuery;
+		uint64_t ixTotalOps = numContains + numInsert + numRangeQuery + numRemove;
+		double ixTotalTime = timeContains + timeInsert + timeRangeQuery + timeRemove;
 		double ixThroughput = ixTotalOps / (ixTotalTime / g_thread_cnt);
 		printf("Per-index stats: index=%s"
 		       ", numContains=%ld, timeContains=%f"
 		       ", numInsert=%ld, timeInsert=%f"
 		       ", numRangeQuery=%ld, timeRangeQuery=%f"
+		       ", numRemove=%ld, timeRemove=%f"
 		       ", totalOps=%ld, totalTime=%f, throughput=%f\n"
 		       , index->index_name.c_str()
 		       , numContains
@@ -246,6 +265,8 @@ void Stats::print(workload * wl)
 		       , timeInsert
 		       , numRangeQuery
 		       , timeRangeQuery
+		       , numRemove
+		       , timeRemove
 		       , ixTotalOps
 		       , ixTotalTime
 		       , ixThroughput);
@@ -258,6 +279,8 @@ void Stats::print(workload * wl)
 	double timeInsert = 0;
 	uint64_t numRangeQuery = 0;
 	double timeRangeQuery = 0;
+	uint64_t numRemove = 0;
+	double timeRemove = 0;
 	for (auto it = wl->indexes.begin(); it != wl->indexes.end(); it++) {
 		Index * index = it->second;
 		for (int tid=0;tid<g_thread_cnt;++tid) {
@@ -267,17 +290,21 @@ void Stats::print(workload * wl)
 			ACCUM_STAT(index, tid, timeInsert);
 			ACCUM_STAT(index, tid, numRangeQuery);
 			ACCUM_STAT(index, tid, timeRangeQuery);
+			ACCUM_STAT(index, tid, numRemove);
+			ACCUM_STAT(index, tid, timeRemove);
 		}
 	}
 	timeContains /= BILLION;
 	timeInsert /= BILLION;
 	timeRangeQuery /= BILLION;
-	uint64_t ixTotalOps = numContains + numInsert + numRangeQuery;
-	double ixTotalTime = timeContains + timeInsert + timeRangeQuery;
+	timeRemove /= BILLION;
+	uint64_t ixTotalOps = numContains + numInsert + numRangeQuery + numRemove;
+	double ixTotalTime = timeContains + timeInsert + timeRangeQuery + timeRemove;
 	double ixThroughput = ixTotalOps / (ixTotalTime / g_thread_cnt);
 	printf("Aggregate index stats: "
 	       "numContains=%ld, timeContains=%f, numInsert=%ld, timeInsert=%f"
 	       ", numRangeQuery=%ld, timeRangeQuery=%f"
+	       ", numRemove=%ld, timeRemove=%f"
 	       ", totalOps=%ld, totalTime=%f, throughput=%f\n"
 	       , numContains
 	       , timeContains
@@ -285,10 +312,14 @@ void Stats::print(workload * wl)
 	       , timeInsert
 	       , numRangeQuery
 	       , timeRangeQuery
+	       , numRemove
+	       , timeRemove
 	       , ixTotalOps
 	       , ixTotalTime
 	       , ixThroughput);
 
+	print_table_stats(wl);
+
 	//> Print summary
 	printf("[summary] txn_cnt=%ld, abort_cnt=%ld"
 	       ", run_time=%f, time_wait=%f, time_ts_alloc=%f"
@@ -297,6 +328,7 @@ void Stats::print(workload * wl)
 	       ", time_query=%f, debug1=%f, debug2=%f, debug3=%f, debug4=%f, debug5=%f"
 	       ", ixNumContains=%ld, ixTimeContains=%f, ixNumInsert=%ld, ixTimeInsert=%f"
 	       ", ixNumRangeQuery=%ld, ixTimeRangeQuery=%f"
+	       ", ixNumRemove=%ld, ixTimeRemove=%f"
 	       ", ixTotalOps=%ld, ixTotalTime=%f, ixThroughput=%f"
 	       ", nthreads=%d, throughput=%f"
 	       ", node_size=%zd, descriptor_size=%zd"
@@ -326,6 +358,8 @@ void Stats::print(workload * wl)
 	       timeInsert,
 	       numRangeQuery,
 	       timeRangeQuery,
+	       numRemove,
+	       timeRemove,
 	       ixTotalOps,
 	       ixTotalTime,
 	       ixThroughput,
@@ -336,7 +370,164 @@ void Stats::print(workload * wl)
 
 	papi_print_counters( total_txn_cnt/(total_run_time / BILLION)*g_thread_cnt);
 
+	//> Hardware counters per committed transaction.
+	printf("Hardware counters (per txn):\n");
+	std::vector<unsigned long long> thread_txns(g_thread_cnt);
+	for (uint64_t tid = 0; tid < g_thread_cnt; tid ++)
+		thread_txns[tid] = _stats[tid]->txn_cnt;
+	PerfCounters::print(thread_txns.data(), total_txn_cnt);
+
 	if (g_prt_lat_distr) print_lat_distr();
+	if (results_file != NULL) write_results(wl);
+}
+
+//> Sums the stats of the indexes of each table, e.g. both ORDER-LINE indexes
+//> of TPC-C, and prints the tables by decreasing share of the index time.
+void Stats::print_table_stats(workload * wl)
+{
+	struct table_stats {
+		const char *name;
+		int nindexes;
+		uint64_t numOps;
+		double time;
+	};
+	std::vector<table_stats> tables;
+	double total_time = 0;
+	for (auto it = wl->indexes.begin(); it != wl->indexes.end(); it++) {
+		Index * index = it->second;
+		const char *tname = index->get_table()->get_table_name();
+		size_t t;
+		for (t = 0; t < tables.size(); t++)
+			if (!strcmp(tables[t].name, tname)) break;
+		if (t == tables.size()) tables.push_back({tname, 0, 0, 0});
+		tables[t].nindexes++;
+		for (int tid=0;tid<g_thread_cnt;++tid) {
+			Stats_tmp_index &s = _stats[tid]->stats_indexes[index->index_id];
+			tables[t].numOps += s.numContains + s.numInsert + s.numRangeQuery + s.numRemove;
+			tables[t].time += s.timeContains + s.timeInsert + s.timeRangeQuery + s.timeRemove;
+		}
+	}
+	for (size_t t = 0; t < tables.size(); t++)
+		total_time += tables[t].time;
+	std::sort(tables.begin(), tables.end(),
+	          [](const table_stats &a, const table_stats &b) { return a.time > b.time; });
+	for (size_t t = 0; t < tables.size(); t++)
+		printf("Per-table index stats: table=%s, indexes=%d"
+		       ", totalOps=%ld, totalTime=%f, timeShare=%.2f, avgLatencyNs=%.1f\n"
+		       , tables[t].name
+		       , tables[t].nindexes
+		       , tables[t].numOps
+		       , tables[t].time / BILLION
+		       , total_time > 0 ? tables[t].time / total_time * 100 : 0.0
+		       , tables[t].numOps ? tables[t].time / tables[t].numOps : 0.0);
+}
+
+//> Writes the configuration and the outcome of the run as a JSON document,
+//> in the same form as the microbenchmark's --results-file.
+void Stats::write_results(workload * wl)
+{
+	uint64_t total_txn_cnt = 0;
+	uint64_t total_abort_cnt = 0;
+	double total_run_time = 0;
+	for (uint64_t tid = 0; tid < g_thread_cnt; tid ++) {
+		total_txn_cnt += _stats[tid]->txn_cnt;
+		total_abort_cnt += _stats[tid]->abort_cnt;
+		total_run_time += _stats[tid]->run_time;
+	}
+
+	FILE *fp = fopen(results_file, "w");
+	if (fp == NULL) {
+		printf("Could not open results file %s\n", results_file);
+		return;
+	}
+
+	fprintf(fp, "{\n");
+	fprintf(fp, "  \"config\": {\n");
+	for (auto it = g_params.begin(); it != g_params.end(); it++)
+		fprintf(fp, "    %s: %s,\n", json_string(it->first).c_str(),
+		        json_string(it->second).c_str());
+#if WORKLOAD == YCSB
+	fprintf(fp, "    \"workload\": \"YCSB\",\n");
+	fprintf(fp, "    \"synth_table_size\": %lu,\n", g_synth_table_size);
+	fprintf(fp, "    \"read_perc\": %f,\n", g_read_perc);
+	fprintf(fp, "    \"write_perc\": %f,\n", g_write_perc);
+	fprintf(fp, "    \"zipf_theta\": %f,\n", g_zipf_theta);
+	fprintf(fp, "    \"req_per_query\": %u,\n", g_req_per_query);
+	fprintf(fp, "    \"scan_len\": %u,\n", g_scan_len);
+	fprintf(fp, "    \"scan_len_dist\": %u,\n", g_scan_len_dist);
+#elif WORKLOAD == TPCC
+	fprintf(fp, "    \"workload\": \"TPCC\",\n");
+	fprintf(fp, "    \"num_wh\": %u,\n", g_num_wh);
+	fprintf(fp, "    \"perc_payment\": %f,\n", g_perc_payment);
+	fprintf(fp, "    \"perc_delivery\": %f,\n", g_perc_delivery);
+	fprintf(fp, "    \"wh_update\": %s,\n", g_wh_update ? "true" : "false");
+	fprintf(fp, "    \"tpcc_access_all\": %s,\n", g_tpcc_access_all ? "true" : "false");
+#endif
+	fprintf(fp, "    \"first_part_local\": %s,\n", g_first_part_local ? "true" : "false");
+	fprintf(fp, "    \"warmup\": %lu,\n", g_warmup);
+	fprintf(fp, "    \"max_txn_per_part\": %lu,\n", g_max_txn_per_part);
+	fprintf(fp, "    \"cc_alg\": %u,\n", g_cc_alg);
+	fprintf(fp, "    \"ts_alloc\": %u,\n", g_ts_alloc);
+	fprintf(fp, "    \"ts_batch_num\": %u,\n", g_ts_batch_alloc ? g_ts_batch_num : 1);
+	fprintf(fp, "    \"num_threads\": %u\n", g_thread_cnt);
+	fprintf(fp, "  },\n");
+
+	fprintf(fp, "  \"threads\": [\n");
+	for (uint64_t tid = 0; tid < g_thread_cnt; tid ++)
+		fprintf(fp, "    { \"tid\": %lu, \"txn_cnt\": %lu, \"abort_cnt\": %lu }%s\n",
+		        tid, _stats[tid]->txn_cnt, _stats[tid]->abort_cnt,
+		        (tid + 1 < g_thread_cnt) ? "," : "");
+	fprintf(fp, "  ],\n");
+
+	fprintf(fp, "  \"indexes\": [\n");
+	for (auto it = wl->indexes.begin(); it != wl->indexes.end(); it++) {
+		Index * index = it->second;
+		uint64_t numContains = 0, numInsert = 0, numRangeQuery = 0, numRemove = 0;
+		double timeContains = 0, timeInsert = 0, timeRangeQuery = 0, timeRemove = 0;
+		for (int tid=0;tid<g_thread_cnt;++tid) {
+			ACCUM_STAT(index, tid, numContains);
+			ACCUM_STAT(index, tid, timeContains);
+			ACCUM_STAT(index, tid, numInsert);
+			ACCUM_STAT(index, tid, timeInsert);
+			ACCUM_STAT(index, tid, numRangeQuery);
+			ACCUM_STAT(index, tid, timeRangeQuery);
+			ACCUM_STAT(index, tid, numRemove);
+			ACCUM_STAT(index, tid, timeRemove);
+		}
+		fprintf(fp, "    { \"name\": %s, \"table\": %s"
+		        ", \"numContains\": %lu, \"timeContains\": %f"
+		        ", \"numInsert\": %lu, \"timeInsert\": %f"
+		        ", \"numRangeQuery\": %lu, \"timeRangeQuery\": %f"
+		        ", \"numRemove\": %lu, \"timeRemove\": %f }%s\n"
+		        , json_string(index->index_name).c_str()
+		        , json_string(index->get_table()->get_table_name()).c_str()
+		        , numContains, timeContains / BILLION
+		        , numInsert, timeInsert / BILLION
+		        , numRangeQuery, timeRangeQuery / BILLION
+		        , numRemove, timeRemove / BILLION
+		        , (std::next(it) != wl->indexes.end()) ? "," : "");
+	}
+	fprintf(fp, "  ],\n");
+
+	if (PerfCounters::available()) {
+		fprintf(fp, "  \"hw_counters_per_txn\": {");
+		for (int e = 0, first = 1; e < PerfCounters::NR_EVENTS; e++) {
+			if (!PerfCounters::available((PerfCounters::event_t)e)) continue;
+			fprintf(fp, "%s \"%s\": %.4f", first ? "" : ",", PerfCounters::event_name(e),
+			        total_txn_cnt ? (double)PerfCounters::total((PerfCounters::event_t)e)
+			                        / total_txn_cnt : 0.0);
+			first = 0;
+		}
+		fprintf(fp, " },\n");
+	}
+	fprintf(fp, "  \"txn_cnt\": %lu,\n", total_txn_cnt);
+	fprintf(fp, "  \"abort_cnt\": %lu,\n", total_abort_cnt);
+	fprintf(fp, "  \"run_time_sec\": %f,\n", total_run_time / BILLION);
+	fprintf(fp, "  \"throughput\": %f\n",
+	        total_txn_cnt/(total_run_time / BILLION)*g_thread_cnt);
+	fprintf(fp, "}\n");
+	fclose(fp);
+	printf("Results written to %s\n", results_file);
 }
 
 void Stats::print_lat_distr()
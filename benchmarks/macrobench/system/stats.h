@@ -10,9 +10,11 @@ public:
 	double timeContains;
 	double timeInsert;
 	double timeRangeQuery;
+	double timeRemove;
 	uint64_t numContains;
 	uint64_t numInsert;
 	uint64_t numRangeQuery;
+	uint64_t numRemove;
 };
 
 class Stats_thd {
@@ -77,5 +79,7 @@ public:
 	void commit(uint64_t thd_id);
 	void abort(uint64_t thd_id);
 	void print(workload *wl);
+	void print_table_stats(workload *wl);
+	void write_results(workload *wl);
 	void print_lat_distr();
 };
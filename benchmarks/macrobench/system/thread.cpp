@@ -17,6 +17,8 @@ void thread_t::init(uint64_t thd_id, workload *workload)
 {
 	_thd_id = thd_id;
 	_wl = workload;
+	_curr_ts = 0;
+	_lease_end = 0;
 	srand48_r((_thd_id + 1) * get_sys_clock(), &buffer);
 	_abort_buffer_size = ABORT_BUFFER_SIZE;
 	_abort_buffer = (AbortBufferEntry *) _mm_malloc(sizeof(AbortBufferEntry) * _abort_buffer_size, ALIGNMENT);
@@ -76,7 +78,6 @@ base_query * thread_t::get_next_query()
 
 RC thread_t::run()
 {
-	if (warmup_finish) mem_allocator.register_thread(_thd_id);
 	pthread_barrier_wait( &warmup_bar );
 
 //	set_affinity(get_thd_id());
@@ -94,6 +95,7 @@ RC thread_t::run()
 	UInt64 txn_cnt = 0;
 
 	papi_start_counters(get_thd_id());
+	PerfCounters::start(get_thd_id());
 
 	while (true) {
 		ts_t starttime = get_sys_clock();
@@ -118,6 +120,9 @@ RC thread_t::run()
 		}
 		#elif CC_ALG == VLL
 		vll_man.vllMainLoop(m_txn, m_query);
+		// The transaction is freed by whichever thread executes it, maybe
+		// later on, so the next query gets a txn_man of its own.
+		_wl->get_txn_man(m_txn, this);
 		#elif CC_ALG == MVCC || CC_ALG == HEKATON
 		glob_manager->add_ts(get_thd_id(), m_txn->get_ts());
 		#elif CC_ALG == OCC
@@ -182,18 +187,21 @@ RC thread_t::run()
 		}
 
 		if (rc == FINISH) {
+			PerfCounters::stop(get_thd_id());
 			papi_stop_counters(get_thd_id());
 			return rc;
 		}
 
-		if (!warmup_finish && txn_cnt >= WARMUP / g_thread_cnt) {
+		if (!warmup_finish && txn_cnt >= g_warmup / g_thread_cnt) {
 			stats.clear( get_thd_id() );
+			PerfCounters::stop(get_thd_id());
 			papi_stop_counters(get_thd_id());
 			return FINISH;
 		}
 
-		if (warmup_finish && txn_cnt >= MAX_TXN_PER_PART) {
-			assert(txn_cnt == MAX_TXN_PER_PART);
+		if (warmup_finish && txn_cnt >= g_max_txn_per_part) {
+			assert(txn_cnt == g_max_txn_per_part);
+			PerfCounters::stop(get_thd_id());
 			papi_stop_counters(get_thd_id());
 			return FINISH;
 		}
@@ -202,16 +210,16 @@ RC thread_t::run()
 	assert(false);
 }
 
+// With batch allocation the thread leases g_ts_batch_num consecutive
+// timestamps at a time, so the shared counter is touched once per lease.
 ts_t thread_t::get_next_ts()
 {
 	if (g_ts_batch_alloc) {
-		if (_curr_ts % g_ts_batch_num == 0) {
-			_curr_ts = glob_manager->get_ts(get_thd_id());
-			_curr_ts ++;
-		} else {
-			_curr_ts ++;
+		if (_curr_ts == _lease_end) {
+			_curr_ts = glob_manager->get_ts_lease(get_thd_id(), g_ts_batch_num);
+			_lease_end = _curr_ts + g_ts_batch_num;
 		}
-		return _curr_ts - 1;
+		return _curr_ts ++;
 	} else {
 		_curr_ts = glob_manager->get_ts(get_thd_id());
 		return _curr_ts;
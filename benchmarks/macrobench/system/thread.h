@@ -29,6 +29,7 @@ private:
 	uint64_t _host_cid;
 	uint64_t _cur_cid;
 	ts_t     _curr_ts;
+	ts_t     _lease_end; // of the timestamps leased with g_ts_batch_alloc
 	ts_t     get_next_ts();
 
 	drand48_data buffer;
@@ -88,12 +88,11 @@ void txn_man::cleanup(RC rc)
 			#if CC_ALG != HSTORE && CC_ALG != OCC
 //			mem_allocator.free(row->manager, 0);
 			#endif
-//			row->free_row();
 			if (row) {
-				free(row);
+				row->free_row();
+				mem_allocator.free(row, sizeof(row_t));
 				row = NULL;
 			}
-//			mem_allocator.free(row, sizeof(row));
 		}
 	}
 	row_cnt = 0;
@@ -165,7 +164,6 @@ void txn_man::insert_row(row_t * row, table_t * table)
 	insert_rows[insert_cnt ++] = row;
 }
 
-#ifdef USE_RANGE_QUERIES
 // perform range query over [low, high]
 // return number N of keys found
 // set results[0...N-1] to the values associated with these keys
@@ -180,9 +178,9 @@ int txn_man::index_range_query(Index *index, idx_key_t low, idx_key_t high,
 
 	INC_TMP_STATS(get_thd_id(), stats_indexes[index->index_id].numRangeQuery, 1);
 	INC_TMP_STATS(get_thd_id(), stats_indexes[index->index_id].timeRangeQuery, endtime - starttime);
+	INC_TMP_STATS(get_thd_id(), time_index, endtime - starttime);
 	return numResults;
 }
-#endif
 
 itemid_t *txn_man::index_read(Index * index, idx_key_t key, int part_id)
 {
@@ -219,6 +217,18 @@ void txn_man::index_insert(Index * index, uint64_t key, row_t * row, int64_t par
 	INC_TMP_STATS(get_thd_id(), time_index, endtime - starttime);
 }
 
+RC txn_man::index_remove(Index * index, uint64_t key, itemid_t * item, int64_t part_id)
+{
+	uint64_t starttime = get_sys_clock();
+	RC rc = index->index_remove(key, item, part_id);
+	uint64_t endtime = get_sys_clock();
+
+	INC_TMP_STATS(get_thd_id(), stats_indexes[index->index_id].numRemove, 1);
+	INC_TMP_STATS(get_thd_id(), stats_indexes[index->index_id].timeRemove, endtime - starttime);
+	INC_TMP_STATS(get_thd_id(), time_index, endtime - starttime);
+	return rc;
+}
+
 RC txn_man::finish(RC rc)
 {
 	#if CC_ALG == HSTORE
@@ -248,7 +258,8 @@ RC txn_man::finish(RC rc)
 
 void txn_man::release()
 {
+	// allocated in init() and get_row(), not by mem_allocator
 	for (int i = 0; i < num_accesses_alloc; i++)
-		mem_allocator.free(accesses[i], 0);
-	mem_allocator.free(accesses, 0);
+		_mm_free(accesses[i]);
+	_mm_free(accesses);
 }
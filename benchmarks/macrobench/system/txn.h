@@ -90,6 +90,7 @@ public:
 	itemid_t *		index_read(Index * index, idx_key_t key, int part_id);
 	void 			index_read(Index * index, idx_key_t key, int part_id, itemid_t ** item);
 	void                    index_insert(Index * index, uint64_t key, row_t * row, int64_t part_id);
+	RC                      index_remove(Index * index, uint64_t key, itemid_t * item, int64_t part_id);
 	row_t * 		get_row(row_t * row, access_t type);
 protected:	
 	void 			insert_row(row_t * row, table_t * table);
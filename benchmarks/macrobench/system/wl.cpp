@@ -6,6 +6,8 @@
 #include "all_indexes.h"
 #include "catalog.h"
 #include "mem_alloc.h"
+#include <algorithm>
+#include <queue>
 
 RC workload::init()
 {
@@ -94,7 +96,7 @@ RC workload::init_schema(std::string schema_file)
 			new(index) Index();
 			int part_cnt = (CENTRAL_INDEX) ? 1 : g_part_cnt;
 			if (tname=="ITEM") part_cnt = 1;
-			#ifdef IDX_HASH
+			#if defined IDX_HASH || defined IDX_HASH_LF
 			#   if WORKLOAD == YCSB
 			index->init(part_cnt, tables[tname], g_synth_table_size*2);
 			#   elif WORKLOAD == TPCC
@@ -121,20 +123,107 @@ void workload::index_insert(std::string index_name, uint64_t key, row_t *row)
 	index_insert(index, key, row);
 }
 
-void workload::index_insert(Index *index, uint64_t key, row_t *row, int64_t part_id)
+itemid_t * workload::new_item(row_t *row, uint64_t part_id)
 {
-	uint64_t pid = part_id;
-	if (part_id == -1) pid = get_part_id(row);
-	itemid_t * m_item = (itemid_t *)mem_allocator.alloc(sizeof(itemid_t), pid);
+	itemid_t * m_item = (itemid_t *)mem_allocator.alloc(sizeof(itemid_t), part_id);
 	m_item->init();
 	m_item->type = DT_row;
 	m_item->location = row;
 	m_item->valid = true;
+	return m_item;
+}
+
+void workload::index_insert(Index *index, uint64_t key, row_t *row, int64_t part_id)
+{
+	uint64_t pid = part_id;
+	if (part_id == -1) pid = get_part_id(row);
+	itemid_t * m_item = new_item(row, pid);
 
 	RC result = index->index_insert(key, m_item, pid);
 	assert(result == RCOK);
 }
 
+// Must be called before any row is loaded, while the indexes are empty.
+void workload::init_bulk_load(int nthreads)
+{
+	load_threads = nthreads;
+	pthread_barrier_init(&load_bar, NULL, nthreads);
+	bulk_indexes.assign(indexes.size(), NULL);
+	for (map<string,Index*>::iterator it = indexes.begin(); it!=indexes.end(); it++)
+		if (it->second->supports_bulk_load())
+			bulk_indexes[it->second->index_id] = it->second;
+	load_buffers.assign(nthreads, std::vector<load_buffer_t>(indexes.size()));
+}
+
+void workload::index_load(Index *index, uint64_t key, row_t *row, int64_t part_id)
+{
+	if (bulk_indexes[index->index_id] == NULL) {
+		index_insert(index, key, row, part_id);
+		return;
+	}
+	uint64_t pid = part_id;
+	if (part_id == -1) pid = get_part_id(row);
+	load_buffers[tid][index->index_id].push_back(std::make_pair(key, new_item(row, pid)));
+}
+
+// Each loading thread sorts its own buffers and then builds the indexes
+// with index_id % load_threads == tid.
+void workload::bulk_load_indexes()
+{
+	std::vector<load_buffer_t>& buffers = load_buffers[tid];
+	// by key only, so that the items of equal keys keep their insertion order
+	for (UInt32 i = 0; i < buffers.size(); i++)
+		std::stable_sort(buffers[i].begin(), buffers[i].end(),
+		          [](const load_buffer_t::value_type &a, const load_buffer_t::value_type &b)
+		          { return a.first < b.first; });
+	pthread_barrier_wait(&load_bar);
+
+	for (UInt32 i = tid; i < bulk_indexes.size(); i += load_threads)
+		if (bulk_indexes[i] != NULL)
+			bulk_load_index(bulk_indexes[i]);
+}
+
+// Merges the sorted buffers of all the loading threads and links the items
+// of equal keys in a list, as index_insert() would.
+void workload::bulk_load_index(Index *index)
+{
+	typedef load_buffer_t::iterator buf_it_t;
+	typedef std::pair<idx_key_t, int> heap_ent_t;
+	std::vector<buf_it_t> pos(load_threads);
+	std::priority_queue<heap_ent_t, std::vector<heap_ent_t>,
+	                    std::greater<heap_ent_t>> heap;
+	size_t nitems = 0;
+	for (int t = 0; t < load_threads; t++) {
+		load_buffer_t& buf = load_buffers[t][index->index_id];
+		pos[t] = buf.begin();
+		if (!buf.empty()) heap.push(heap_ent_t(buf.front().first, t));
+		nitems += buf.size();
+	}
+
+	std::vector<std::pair<KEY_TYPE, VALUE_TYPE>> kv_pairs;
+	kv_pairs.reserve(nitems);
+	while (!heap.empty()) {
+		int t = heap.top().second;
+		heap.pop();
+		idx_key_t key = pos[t]->first;
+		itemid_t * item = pos[t]->second;
+		if (!kv_pairs.empty() && kv_pairs.back().first == key) {
+			itemid_t * head = kv_pairs.back().second;
+			item->next = head->next;
+			head->next = item;
+		} else {
+			kv_pairs.push_back(std::make_pair(key, item));
+		}
+		if (++pos[t] != load_buffers[t][index->index_id].end())
+			heap.push(heap_ent_t(pos[t]->first, t));
+	}
+	for (int t = 0; t < load_threads; t++)
+		load_buffer_t().swap(load_buffers[t][index->index_id]);
+
+	RC result = index->index_bulk_load(kv_pairs);
+	assert(result == RCOK);
+}
+
 void workload::initThread(const int __tid)
 {
 	for (map<string,Index*>::iterator it = indexes.begin(); it!=indexes.end(); it++)
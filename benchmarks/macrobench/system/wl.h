@@ -39,5 +39,27 @@ public:
 protected:
 	void index_insert(std::string index_name, uint64_t key, row_t * row);
 	void index_insert(Index * index, uint64_t key, row_t * row, int64_t part_id = -1);
+
+	// Parallel loading with bulk index building. Loading threads 0 to
+	// nthreads-1 insert rows with index_load(), which buffers the items of
+	// the indexes that can be bulk-loaded and inserts the rest right away.
+	// When all of them are done, every loading thread calls
+	// bulk_load_indexes() to build its share of the buffered indexes.
+	void init_bulk_load(int nthreads);
+	void index_load(Index * index, uint64_t key, row_t * row, int64_t part_id = -1);
+	void bulk_load_indexes();
+	int load_threads;
+
+private:
+	typedef std::vector<std::pair<idx_key_t, itemid_t *>> load_buffer_t;
+
+	itemid_t * new_item(row_t * row, uint64_t part_id);
+	void bulk_load_index(Index * index);
+
+	pthread_barrier_t load_bar;
+	// Indexed by index_id; NULL for the indexes that are not bulk-loaded.
+	std::vector<Index *> bulk_indexes;
+	// The buffered items, by loading thread and index_id.
+	std::vector<std::vector<load_buffer_t>> load_buffers;
 };
 
@@ -11,25 +11,168 @@
 #define map_t Map<map_key_t, map_val_t>
 
 #include "Keygen.h"
+#include "PerfCounters.h"
 #include "key/key.h"
 #include "../../ds/map_factory.h"
 
 #include "clargs.h"
+#include "latency.h"
 #include "thread_data.h"
+#include "sampler.h"
+#include "scenario.h"
+#include "results.h"
 #include "aff.h"
+#include "trace.h"
+#include "opstream.h"
+
+#ifndef MAX_THREADS_POW2
+#	define MAX_THREADS_POW2 512
+#endif
+#include "papi/papi_util.h"
+#include "papi/papi_util_impl.h"
+
+pthread_barrier_t warmup_barrier, start_barrier;
+
+//> The trace that is replayed, if one is given with --trace-file.
+trace_t *trace = NULL;
+static const int trace_ops[TRACE_OP_END] = {
+	OPS_LOOKUP, OPS_INSERT, OPS_DELETE, OPS_RQUERY
+};
+
+//> The workload phases and the one that is currently executed. The master
+//> thread moves the benchmark threads to the next phase.
+scenario_t *scenario = NULL;
+volatile int cur_phase = 0;
+
+//> Produces the next operation, either from the trace or from the random
+//> generators of the current phase.
+static inline void next_op(trace_cursor_t *trace_cursor, KeyGenerator *keygen_choice,
+                           KeyGenerator *keygen, phase_t *phase, int *op,
+                           map_key_t *key, map_val_t *val,
+                           unsigned long long *rquery_len)
+{
+	if (trace) {
+		//> Get the next access from the trace.
+		uint64_t tkey, tval;
+		trace_next(trace_cursor, op, &tkey, &tval);
+		*op = trace_ops[*op];
+		KEY_GET(*key, tkey);
+		*val = (map_val_t)tval;
+		*rquery_len = tval;
+	} else {
+		//> Generate random number.
+		unsigned choice = (unsigned)keygen_choice->next() % 100;
+		uint64_t k = keygen->next();
+		//> Most phases are not shifted, so they skip the division.
+		if (phase->offset != 0) k = (k + phase->offset) % clargs.max_key;
+		KEY_GET(*key, k);
+		(*key)++; // To avoid having 0 key
+		*val = (map_val_t)*key;
+
+		if (choice < phase->lookup_frac)
+			*op = OPS_LOOKUP;
+		else if (choice < phase->lookup_frac + phase->rquery_frac)
+			*op = OPS_RQUERY;
+		else if (choice < phase->lookup_frac + phase->rquery_frac
+		                                     + phase->insert_frac)
+			*op = OPS_INSERT;
+		else
+			*op = OPS_DELETE;
+	}
+}
+
+//> Busy-waits until `ns`. Returns false if the run ended in the meantime.
+static inline bool wait_until(uint64_t ns, thread_data_t *data)
+{
+	while (now_ns() < ns) {
+#		if defined(WORKLOAD_TIME)
+		if (*(data->time_to_leave))
+			return false;
+#		endif
+		__asm__ __volatile__("pause" ::: "memory");
+	}
+	return true;
+}
+
+//> Inserts `nr_nodes` random keys from (min_key, max_key] using thread `tid`.
+static inline int map_warmup(map_t *map, int tid, int nr_nodes,
+                             unsigned long long min_key,
+                             unsigned long long max_key, unsigned int seed)
+{
+    int nodes_inserted = 0;
+	map_key_t key;
+	map_val_t ret;
+	KeyGeneratorUniform keygen(seed, max_key - min_key);
+
+    srand(seed);
+    while (nodes_inserted < nr_nodes) {
+		KEY_GET(key, min_key + keygen.next());
+		key++; // To avoid having 0 key
+
+		ret = map->insertIfAbsent(tid, key, (map_val_t)key);
+        nodes_inserted += (ret == NULL);
+    }
+
+    return nodes_inserted;
+}
+
+//> Parallel warmup. Each thread inserts its share of the initial keys in its
+//> own slice of the key space, so nodes are allocated by the thread (and on
+//> the NUMA node) that runs the benchmark on them.
+static inline int map_warmup_partition(map_t *map, int tid, int nthreads)
+{
+	unsigned long long min_key = (unsigned long long)tid * clargs.max_key / nthreads;
+	unsigned long long max_key = (unsigned long long)(tid + 1) * clargs.max_key / nthreads;
+	int nr_nodes = (unsigned long long)(tid + 1) * clargs.init_tree_size / nthreads -
+	               (unsigned long long)tid * clargs.init_tree_size / nthreads;
+
+	return map_warmup(map, tid, nr_nodes, min_key, max_key,
+	                  (tid + 1) * clargs.init_seed);
+}
+
+//> Generates the same set of keys that map_warmup() inserts for the whole key
+//> space and hands them to the map in sorted order.
+//> Returns false if the map does not support bulk-loading.
+static inline bool map_bulk_load(map_t *map, int nr_nodes,
+                                 unsigned long long max_key, unsigned int seed)
+{
+	std::vector<bool> present(max_key + 1, false);
+	std::vector<std::pair<map_key_t, map_val_t>> kv_pairs;
+	KeyGeneratorUniform keygen(seed, max_key);
+	map_key_t key;
+	int nodes_generated = 0;
+
+	while (nodes_generated < nr_nodes) {
+		unsigned long long k = keygen.next() + 1; // To avoid having 0 key
+		if (present[k]) continue;
+		present[k] = true;
+		nodes_generated++;
+	}
 
-pthread_barrier_t start_barrier;
+	kv_pairs.reserve(nr_nodes);
+	for (unsigned long long k=1; k <= max_key; k++) {
+		if (!present[k]) continue;
+		KEY_GET(key, k);
+		kv_pairs.push_back(std::make_pair(key, (map_val_t)key));
+	}
+
+	return map->bulkLoad(0, kv_pairs);
+}
 
 void *thread_fn(void *arg)
 {
 	thread_data_t *data = (thread_data_t *)arg;
 	int ret, tid = data->tid, cpu = data->cpu;
 	map_t *map = data->map;
-	unsigned choice;
+	int op, phase_id = -1;
+	phase_t *phase = NULL;
 	map_key_t key;
-#	if defined(WORKLOAD_FIXED)
-	int ops_performed = 0;
-#	endif
+	map_val_t val;
+	unsigned long long rquery_len = 10000;
+	trace_cursor_t trace_cursor = trace_cursor_t();
+	ArrivalGenerator *arrivals = NULL;
+	uint64_t intended_ns = 0;
+	opstream_t *stream = NULL;
 	
 	//> Set affinity.
 	setaffinity_oncpu(cpu);
@@ -37,44 +180,99 @@ void *thread_fn(void *arg)
 	//> Initialize per thread Map data.
 	map->initThread(tid);
 
+	//> Parallel map warmup, on this thread's cpu.
+	if (!strcmp(clargs.warmup_mode, "par"))
+		map_warmup_partition(map, tid, clargs.num_threads);
+	pthread_barrier_wait(&warmup_barrier);
+
 	//> Initialize random number generators
 	int seed = (tid + 1) * clargs.thread_seed;
-	KeyGenerator *keygen = new KeyGeneratorUniform(seed, clargs.max_key);
+	KeyGenerator *keygen = NULL;
 	KeyGenerator *keygen_choice = new KeyGeneratorUniform(seed, UINT_MAX);
 
+	//> Get this thread's part of the trace ready, before the measurements.
+	if (trace)
+		trace_cursor_init(trace, tid, &trace_cursor);
+
+	//> Fixed-work mode, generate all the operations of this thread now, so
+	//> that the generation is not measured.
+	if (clargs.nr_operations) {
+		phase_id = 0;
+		phase = &scenario->phases[phase_id];
+		keygen = phase_keygen_new(phase, seed + phase_id, clargs.max_key);
+		stream = opstream_new(data->nr_operations);
+		for (unsigned long long i=0; i < data->nr_operations; i++) {
+			next_op(&trace_cursor, keygen_choice, keygen, phase, &op, &key, &val,
+			        &rquery_len);
+			opstream_push(stream, op, key, val, rquery_len);
+		}
+	}
+
+	//> Open-loop mode, each thread gets an equal share of the target rate.
+	if (clargs.arrival_rate)
+		arrivals = new ArrivalGenerator(!strcmp(clargs.arrivals, "poisson"),
+		                   (double)clargs.arrival_rate / clargs.num_threads, seed);
+
+	papi_create_eventset(tid);
+	PerfCounters::open(tid);
+
 	//> Wait for the master to give the starting signal.
 	pthread_barrier_wait(&start_barrier);
+	papi_start_counters(tid);
+	PerfCounters::start(tid);
+
+	//> The first arrivals of the threads are spread over one inter-arrival
+	//> gap, so that fixed-rate arrivals of different threads do not coincide.
+	if (arrivals)
+		arrivals->start(now_ns() + (uint64_t)(arrivals->mean_gap() * tid /
+		                                      clargs.num_threads));
 
 	//> Critical section.
 	while (1) {
-#		if defined(WORKLOAD_FIXED)
-		if (ops_performed >= data->nr_operations - 1)
-			break;
-		ops_performed = data->operations_performed[OPS_TOTAL];
-#		elif defined(WORKLOAD_TIME)
-		if (*(data->time_to_leave))
-			break;
-#		endif
+		if (stream) {
+			if (!opstream_next(stream, &op, &key, &val, &rquery_len))
+				break;
+		} else {
+#			if defined(WORKLOAD_TIME)
+			if (*(data->time_to_leave))
+				break;
+#			endif
+
+			//> Move to the next phase of the scenario, if the master said so.
+			if (phase_id != cur_phase) {
+				phase_id = cur_phase;
+				phase = &scenario->phases[phase_id];
+				delete keygen;
+				keygen = phase_keygen_new(phase, seed + phase_id, clargs.max_key);
+			}
+
+			next_op(&trace_cursor, keygen_choice, keygen, phase, &op, &key, &val,
+			        &rquery_len);
+		}
 
-		//> Generate random number.
-		choice = (unsigned)keygen_choice->next() % 100;
-		KEY_GET(key, keygen->next());
-		key++; // To avoid having 0 key
+		//> In open-loop mode, wait for the intended start of the operation.
+		if (arrivals) {
+			intended_ns = arrivals->next();
+			if (!wait_until(intended_ns, data))
+				break;
+		}
 
 		data->operations_performed[OPS_TOTAL]++;
 
-		//> Perform operation on the RBT based on choice.
-		if (choice < clargs.lookup_frac) {
+		//> Perform operation on the RBT based on op.
+		if (op == OPS_LOOKUP) {
 			//> Lookup
 			data->operations_performed[OPS_LOOKUP]++;
 			ret = map->contains(tid, key);
 			data->operations_succeeded[OPS_LOOKUP] += ret;
-		} else if (choice < clargs.lookup_frac + clargs.rquery_frac) {
+		} else if (op == OPS_RQUERY) {
 			//> Range-Query
 			data->operations_performed[OPS_RQUERY]++;
-			map_key_t key2 = key + 10000;
+			map_key_t key2 = key + rquery_len;
 			std::vector<std::pair<map_key_t, map_val_t>> kv_pairs;
 			ret = map->rangeQuery(tid, key, key2, kv_pairs);
+			//> -1 if the data structure does not support range queries.
+			if (ret < 0) ret = 0;
 			data->operations_succeeded[OPS_RQUERY] += ret;
 //		} else {
 //			//> Update
@@ -91,15 +289,14 @@ void *thread_fn(void *arg)
 //				exit(1);
 //			}
 //		}
-		} else if (choice < clargs.lookup_frac + clargs.rquery_frac
-		                                       + clargs.insert_frac) {
+		} else if (op == OPS_INSERT) {
 			//> Insertion
 			data->operations_performed[OPS_INSERT]++;
 			map_val_t retp;
-			retp = map->insertIfAbsent(tid, key, (map_val_t)key);
+			retp = map->insertIfAbsent(tid, key, val);
 			ret = (retp == NULL);
 			data->operations_succeeded[OPS_INSERT] += ret;
-			if (retp) assert(retp == (map_val_t)key);
+			if (retp && !trace) assert(retp == (map_val_t)key);
 		} else {
 			//> Deletion
 			data->operations_performed[OPS_DELETE]++;
@@ -107,32 +304,19 @@ void *thread_fn(void *arg)
 			retp = map->remove(tid, key);
 			ret = retp.second;
 			data->operations_succeeded[OPS_DELETE] += ret;
-			if (retp.first) assert(retp.first == (map_val_t)key);
+			if (retp.first && !trace) assert(retp.first == (map_val_t)key);
 		}
+		if (arrivals)
+			latency_hist_record(data->latency, now_ns() - intended_ns);
 		data->operations_succeeded[OPS_TOTAL] += ret;
 	}
 
-	return NULL;
-}
-
-static inline int map_warmup(map_t *map, int nr_nodes, int max_key,
-                             unsigned int seed)
-{
-    int nodes_inserted = 0;
-	map_key_t key;
-	map_val_t ret;
-	KeyGeneratorUniform keygen(seed, max_key);
-
-    srand(seed);
-    while (nodes_inserted < nr_nodes) {
-		KEY_GET(key, keygen.next());
-		key++; // To avoid having 0 key
+	PerfCounters::stop(tid);
+	papi_stop_counters(tid);
 
-		ret = map->insertIfAbsent(0, key, (map_val_t)key);
-        nodes_inserted += (ret == NULL);
-    }
+	if (stream) opstream_free(stream);
 
-    return nodes_inserted;
+	return NULL;
 }
 
 int main(int argc, char **argv)
@@ -143,6 +327,7 @@ int main(int argc, char **argv)
 	unsigned int ncpus, *cpus;
 	int time_to_leave = 0;
 	Timer warmup_timer;
+	bool par_warmup;
 	map_t *map;
 
 	//> Read command line arguments
@@ -150,30 +335,76 @@ int main(int argc, char **argv)
 	clargs_print();
 	nthreads = clargs.num_threads;
 
+	//> The workload phases. Without a scenario file the command line
+	//> arguments give a single phase.
+#	if defined(WORKLOAD_TIME)
+	if (clargs.scenario_file) {
+		scenario = scenario_load(clargs.scenario_file, clargs.max_key);
+		scenario_print(scenario);
+		log_info("\n");
+	} else {
+		scenario = scenario_single_phase(clargs.run_time_sec, clargs.lookup_frac,
+		                                 clargs.rquery_frac, clargs.insert_frac);
+	}
+#	else
+	scenario = scenario_single_phase(0, clargs.lookup_frac, clargs.rquery_frac,
+	                                 clargs.insert_frac);
+#	endif
+
+	//> Map the trace file, so that it is read before any measurement.
+	if (clargs.trace_file) {
+		trace = trace_open(clargs.trace_file, nthreads);
+		trace_print(trace);
+		log_info("\n");
+	}
 
-	//> Initialize the Map data structure.
+
+	//> Initialize the Map data structure. The node allocation policy has to be
+	//> in place before the map allocates its first node.
+	NodeAllocator::set_pages(clargs.pages);
+	NodeAllocator::set_policy(clargs.alloc_policy);
+	if (clargs.memory_stats) NodeAllocator::count_live();
 	std::string map_type(clargs.ds_name);
 	std::string sync_type(clargs.sync_type);
 	map = createMap<map_key_t, map_val_t>(map_type, sync_type);
 	log_info("Benchmark\n");
 	log_info("=======================\n");
-	log_info("  Key size: %u\n", sizeof(map_key_t));
+	log_info("  Key size: %zu\n", sizeof(map_key_t));
 	log_info("  MAP implementation: %s\n", map->name());
+	Timer::init();
 
 	//> Initialize the warmup thread.
 	int warmup_core = 0;
 	setaffinity_oncpu(warmup_core);
 	map->initThread(0);
 
-	//> Map warmup.
-	log_info("\n");
-	log_info("Tree initialization (at core %d)...\n", warmup_core);
-	warmup_timer.start();
-	map_warmup(map, clargs.init_tree_size, clargs.max_key, clargs.init_seed);
-	warmup_timer.stop();
-	log_info("Initialization finished in %.2lf sec\n", warmup_timer.report_sec());
+	//> Map warmup. The parallel warmup is performed by the benchmark threads
+	//> themselves, as soon as they are spawned.
+	par_warmup = !strcmp(clargs.warmup_mode, "par");
+	if (!strcmp(clargs.warmup_mode, "bulk")) {
+		log_info("\n");
+		log_info("Tree initialization with bulk-load (at core %d)...\n", warmup_core);
+		warmup_timer.start();
+		if (!map_bulk_load(map, clargs.init_tree_size, clargs.max_key,
+		                   clargs.init_seed)) {
+			log_info("Bulk-load is not supported, inserting keys one by one...\n");
+			map_warmup(map, 0, clargs.init_tree_size, 0, clargs.max_key,
+			           clargs.init_seed);
+		}
+		warmup_timer.stop();
+		log_info("Initialization finished in %.2lf sec\n", warmup_timer.report_sec());
+	} else if (!par_warmup) {
+		log_info("\n");
+		log_info("Tree initialization (at core %d)...\n", warmup_core);
+		warmup_timer.start();
+		map_warmup(map, 0, clargs.init_tree_size, 0, clargs.max_key,
+		           clargs.init_seed);
+		warmup_timer.stop();
+		log_info("Initialization finished in %.2lf sec\n", warmup_timer.report_sec());
+	}
 
-	//> Initialize the starting barrier.
+	//> Initialize the warmup and starting barriers.
+	pthread_barrier_init(&warmup_barrier, NULL, nthreads+1);
 	pthread_barrier_init(&start_barrier, NULL, nthreads+1);
 	
 	//> Initialize the vectors that hold the thread references and data.
@@ -186,18 +417,39 @@ int main(int argc, char **argv)
 	get_mtconf_options(&ncpus, &cpus);
 	mt_conf_print(ncpus, cpus);
 
+	if (par_warmup) {
+		log_info("\n");
+		log_info("Tree initialization (in parallel by %d threads)...\n", nthreads);
+		warmup_timer.start();
+	}
+
+	papi_init_program(nthreads);
+	PerfCounters::init(nthreads);
+
 	//> Initialize per thread data and spawn threads.
 	for (i=0; i < nthreads; i++) {
 		int cpu = cpus[i];
 		threads_data[i] = thread_data_new(i, cpu, map);
-#		ifdef WORKLOAD_FIXED
-		threads_data[i]->nr_operations = clargs.nr_operations / nthreads;
-#		elif defined(WORKLOAD_TIME)
+		threads_data[i]->latency = latency_hist_new();
+		threads_data[i]->nr_operations = opstream_thread_ops(clargs.nr_operations,
+		                                                     i, nthreads);
+#		if defined(WORKLOAD_TIME)
 		threads_data[i]->time_to_leave = &time_to_leave;
 #		endif
 		pthread_create(&threads[i], NULL, thread_fn, threads_data[i]);
 	}
 
+	//> Wait until all threads finish the warmup.
+	pthread_barrier_wait(&warmup_barrier);
+	if (par_warmup) {
+		warmup_timer.stop();
+		log_info("Initialization finished in %.2lf sec\n", warmup_timer.report_sec());
+	}
+
+	//> The internal events of the warmup are not reported with the run's.
+	MapStats warmup_map_stats;
+	map->stats(&warmup_map_stats);
+
 	//> Wait until all threads go to the starting point.
 	pthread_barrier_wait(&start_barrier);
 
@@ -205,9 +457,28 @@ int main(int argc, char **argv)
 	Timer wall_timer;
 	wall_timer.start();
 
+	sampler_t *sampler = NULL;
+	if (clargs.sample_ms)
+		sampler = sampler_start(threads_data.data(), nthreads, clargs.sample_ms);
+
 #	if defined(WORKLOAD_TIME)
-	sleep(clargs.run_time_sec);
-	time_to_leave = 1;
+	//> Run the phases one after the other and keep the operations that were
+	//> performed up to the end of each one. In fixed-work mode the threads
+	//> stop on their own.
+	int nphases = clargs.nr_operations ? 0 : scenario->phases.size();
+	std::vector<unsigned long long> phase_ops(nphases + 1);
+	std::vector<uint64_t> phase_ns(nphases + 1);
+	phase_ns[0] = now_ns();
+	phase_ops[0] = total_ops_performed(threads_data.data(), nthreads);
+	for (int p=0; p < nphases; p++) {
+		uint64_t end_ns = phase_ns[p] +
+		                  (uint64_t)(scenario->phases[p].duration_sec * 1e9);
+		sleep_until_ns(end_ns);
+		phase_ns[p+1] = now_ns();
+		phase_ops[p+1] = total_ops_performed(threads_data.data(), nthreads);
+		if (p + 1 < nphases) cur_phase = p + 1;
+	}
+	if (!clargs.nr_operations) time_to_leave = 1;
 #	endif
 
 	//> Join threads.
@@ -216,6 +487,8 @@ int main(int argc, char **argv)
 
 	//> Stop wall_timer.
 	wall_timer.stop();
+	if (sampler)
+		sampler_stop(sampler);
 
 	//> Print thread statistics.
 	thread_data_t *total_data = thread_data_new(-1, -1, NULL);
@@ -258,5 +531,110 @@ int main(int argc, char **argv)
 	        total_data->operations_succeeded[OPS_INSERT] - 
 	        total_data->operations_succeeded[OPS_DELETE]);
 
+	//> Keep everything that goes to the results file.
+	results_t results;
+	results.map_name = map->name();
+	results.nthreads = nthreads;
+	results.threads_data = threads_data.data();
+	results.total_data = total_data;
+	results.time_elapsed = time_elapsed;
+	results.throughput = throughput_usec;
+	results.validation = validation;
+	results.expected_size = clargs.init_tree_size +
+	                        total_data->operations_succeeded[OPS_INSERT] -
+	                        total_data->operations_succeeded[OPS_DELETE];
+	results.latency = NULL;
+	results.scenario = NULL;
+	results.memory = NULL;
+	results.map_stats = NULL;
+
+#	if defined(WORKLOAD_TIME)
+	//> Print the throughput of every phase of the scenario.
+	if (clargs.scenario_file) {
+		log_info("\n");
+		log_info("Per-phase throughput\n");
+		log_info("=======================\n");
+		for (int p=0; p < nphases; p++) {
+			double phase_throughput = (phase_ops[p+1] - phase_ops[p]) * 1000.0 /
+			                          (phase_ns[p+1] - phase_ns[p]);
+			log_info("  %3d: %7.3lf Ops/usec  (%s)\n", p, phase_throughput,
+			         scenario->phases[p].desc);
+			results.phase_throughput.push_back(phase_throughput);
+		}
+		results.scenario = scenario;
+	}
+#	endif
+
+	//> Print the latencies of the open-loop mode.
+	if (clargs.arrival_rate) {
+		latency_hist_t *total_latency = latency_hist_new();
+		for (i=0; i < nthreads; i++)
+			latency_hist_add(threads_data[i]->latency, total_latency);
+		log_info("\n");
+		log_info("Open-loop latency (from intended start)\n");
+		log_info("=======================\n");
+		log_info("  Target rate (Ops/usec): %7.3lf (%s arrivals)\n",
+		         clargs.arrival_rate / 1000000.0, clargs.arrivals);
+		log_info("  Achieved rate (Ops/usec): %7.3lf\n", throughput_usec);
+		if (throughput_usec < 0.95 * clargs.arrival_rate / 1000000.0)
+			log_warning("  WARNING: the target rate was not sustained, the map "
+			            "is past saturation\n");
+		latency_hist_print(total_latency);
+		results.latency = total_latency;
+	}
+
+	if (sampler) {
+		log_info("\n");
+		log_info("Throughput time series (Mops/sec, every %u msec)\n",
+		         clargs.sample_ms);
+		log_info("=======================\n");
+		sampler_write(sampler, clargs.sample_file);
+	}
+
+	//> Print the hardware counters, per thread and in total.
+	log_info("\n");
+	log_info("Hardware counters (per operation)\n");
+	log_info("=======================\n");
+	std::vector<unsigned long long> thread_ops(nthreads);
+	for (i=0; i < nthreads; i++)
+		thread_ops[i] = threads_data[i]->operations_performed[OPS_TOTAL];
+	PerfCounters::print(thread_ops.data(), total_data->operations_performed[OPS_TOTAL]);
+
+	log_info("\n");
+	NodeAllocator::print_distribution();
+
+	//> Print the memory footprint of the map.
+	MemoryStats memory_stats;
+	if (clargs.memory_stats) {
+		map->memoryStats(&memory_stats);
+		if (!memory_stats.walked()) memory_stats.keys = results.expected_size;
+		log_info("\n");
+		memory_stats.print();
+		results.memory = &memory_stats;
+	}
+
+	//> Print the internal events of the map (failed CASes, restarts, ...).
+	MapStats map_stats;
+	map->stats(&map_stats);
+	map_stats.subtract(warmup_map_stats);
+	log_info("\n");
+	log_info("Internal events\n");
+	log_info("=======================\n");
+	map_stats.print(total_data->operations_performed[OPS_TOTAL]);
+	results.map_stats = &map_stats;
+
+	if (clargs.results_file) {
+		log_info("\n");
+		results_write(&results, clargs.results_file);
+	}
+
+#	ifdef USE_PAPI
+	log_info("\n");
+	log_info("PAPI counters (per operation)\n");
+	log_info("=======================\n");
+	papi_print_counters(total_data->operations_performed[OPS_TOTAL]);
+	papi_deinit_program();
+#	endif
+
 	return 0;
 }
@@ -5,8 +5,10 @@
 #include <unistd.h>
 #include <assert.h>
 #include <getopt.h>
+#include <string.h>
 
 #include "Log.h"
+#include "MapStats.h"
 
 /**
  * The interface provided
@@ -26,11 +28,21 @@ typedef struct {
 
 	char *ds_name;
 	char *sync_type;
+	char *warmup_mode;
+	char *alloc_policy;
+	char *pages;
+	char *trace_file;
+	unsigned long long arrival_rate;
+	char *arrivals;
+	unsigned int sample_ms;
+	char *sample_file;
+	char *results_file;
+	int memory_stats;
+	unsigned long long nr_operations; //> 0 for a timed run
 
 #	ifdef WORKLOAD_TIME
 	int run_time_sec;
-#	elif defined(WORKLOAD_FIXED)
-	int nr_operations;
+	char *scenario_file;
 #	endif
 } clargs_t;
 
@@ -47,13 +59,25 @@ typedef struct {
 #define ARGUMENT_DEFAULT_THREAD_SEED 128
 #define ARGUMENT_DEFAULT_DS_NAME "bst-unb-ext"
 #define ARGUMENT_DEFAULT_SYNC_TYPE "Sequential"
+#define ARGUMENT_DEFAULT_WARMUP_MODE "seq"
+#define ARGUMENT_DEFAULT_ALLOC_POLICY "malloc"
+#define ARGUMENT_DEFAULT_PAGES "small"
+#define ARGUMENT_DEFAULT_TRACE_FILE NULL
+#define ARGUMENT_DEFAULT_ARRIVAL_RATE 0
+#define ARGUMENT_DEFAULT_ARRIVALS "poisson"
+#define ARGUMENT_DEFAULT_SAMPLE_MS 0
+#define ARGUMENT_DEFAULT_SAMPLE_FILE NULL
+#define ARGUMENT_DEFAULT_RESULTS_FILE NULL
+#define ARGUMENT_DEFAULT_MEMORY_STATS 0
 #ifdef WORKLOAD_TIME
+#define ARGUMENT_DEFAULT_NR_OPERATIONS 0
 #define ARGUMENT_DEFAULT_RUN_TIME_SEC 5
+#define ARGUMENT_DEFAULT_SCENARIO_FILE NULL
 #elif defined WORKLOAD_FIXED
 #define ARGUMENT_DEFAULT_NR_OPERATIONS 1000000
 #endif
 
-static char *opt_string = "ht:s:m:i:l:q:r:e:j:o:d:f:";
+static char *opt_string = "ht:s:m:i:l:q:r:e:j:o:d:f:w:a:p:T:R:A:S:O:J:MP:";
 static struct option long_options[] = {
 	{ "help",            no_argument,       NULL, 'h' },
 	{ "num-threads",     required_argument, NULL, 't' },
@@ -66,11 +90,21 @@ static struct option long_options[] = {
 	{ "thread-seed",     required_argument, NULL, 'j' },
 	{ "ds-name",         required_argument, NULL, 'd' },
 	{ "sync-type",       required_argument, NULL, 'f' },
-
-#	if defined(WORKLOAD_FIXED)
+	{ "warmup-mode",     required_argument, NULL, 'w' },
+	{ "alloc-policy",    required_argument, NULL, 'a' },
+	{ "pages",           required_argument, NULL, 'p' },
+	{ "trace-file",      required_argument, NULL, 'T' },
+	{ "arrival-rate",    required_argument, NULL, 'R' },
+	{ "arrivals",        required_argument, NULL, 'A' },
+	{ "sample-ms",       required_argument, NULL, 'S' },
+	{ "sample-file",     required_argument, NULL, 'O' },
+	{ "results-file",    required_argument, NULL, 'J' },
+	{ "memory-stats",    no_argument,       NULL, 'M' },
 	{ "nr-operations",   required_argument, NULL, 'o' },
-#	elif defined(WORKLOAD_TIME)
+
+#	if defined(WORKLOAD_TIME)
 	{ "run-time-sec",    required_argument, NULL, 'r' },
+	{ "scenario",        required_argument, NULL, 'P' },
 #	endif
 
 	{ NULL, 0, NULL, 0 }
@@ -87,10 +121,20 @@ static clargs_t clargs = {
 	ARGUMENT_DEFAULT_THREAD_SEED,
 	ARGUMENT_DEFAULT_DS_NAME,
 	ARGUMENT_DEFAULT_SYNC_TYPE,
+	ARGUMENT_DEFAULT_WARMUP_MODE,
+	ARGUMENT_DEFAULT_ALLOC_POLICY,
+	ARGUMENT_DEFAULT_PAGES,
+	ARGUMENT_DEFAULT_TRACE_FILE,
+	ARGUMENT_DEFAULT_ARRIVAL_RATE,
+	ARGUMENT_DEFAULT_ARRIVALS,
+	ARGUMENT_DEFAULT_SAMPLE_MS,
+	ARGUMENT_DEFAULT_SAMPLE_FILE,
+	ARGUMENT_DEFAULT_RESULTS_FILE,
+	ARGUMENT_DEFAULT_MEMORY_STATS,
+	ARGUMENT_DEFAULT_NR_OPERATIONS,
 #	ifdef WORKLOAD_TIME
-	ARGUMENT_DEFAULT_RUN_TIME_SEC
-#	elif defined(WORKLOAD_FIXED)
-	ARGUMENT_DEFAULT_NR_OPERATIONS
+	ARGUMENT_DEFAULT_RUN_TIME_SEC,
+	ARGUMENT_DEFAULT_SCENARIO_FILE
 #	endif
 };
 
@@ -119,13 +163,49 @@ static void clargs_print_usage(char *progname)
 	         ARGUMENT_DEFAULT_DS_NAME);
 	log_info("    -f,--sync-type  the synchronization mechanism to be used [%s]\n",
 	         ARGUMENT_DEFAULT_SYNC_TYPE);
+	log_info("    -w,--warmup-mode  how the initial tree is built [%s]\n",
+	         ARGUMENT_DEFAULT_WARMUP_MODE);
+	log_info("         seq:  one thread at core 0 inserts all keys\n");
+	log_info("         par:  the benchmark threads insert a partition of the key space each\n");
+	log_info("         bulk: bulk-load the sorted keys if the map supports it, else seq\n");
+	log_info("    -a,--alloc-policy  NUMA placement of the map nodes [%s]\n",
+	         ARGUMENT_DEFAULT_ALLOC_POLICY);
+	log_info("         malloc:      plain malloc, pages land where they are first touched\n");
+	log_info("         first-touch: per-thread arena chunks, local to the allocating thread\n");
+	log_info("         interleave:  arena pages interleaved across all NUMA nodes\n");
+	log_info("         per-socket:  one arena per NUMA node, used by the threads of that node\n");
+	log_info("    -p,--pages  pages that back the node arena [%s]\n",
+	         ARGUMENT_DEFAULT_PAGES);
+	log_info("         small:     4KB pages\n");
+	log_info("         thp:       2MB transparent huge pages (madvise)\n");
+	log_info("         hugetlbfs: 2MB pages from the hugetlbfs pool\n");
+	log_info("    -T,--trace-file  replay the accesses of this trace file instead of\n");
+	log_info("                     the lookup/rquery/insert fractions [none]\n");
+	log_info("    -R,--arrival-rate  open-loop mode: aggregate target rate in ops/sec,\n");
+	log_info("                       0 for closed-loop [%d]\n",
+	         ARGUMENT_DEFAULT_ARRIVAL_RATE);
+	log_info("    -A,--arrivals  arrival process of the open-loop mode [%s]\n",
+	         ARGUMENT_DEFAULT_ARRIVALS);
+	log_info("         poisson: exponentially distributed inter-arrival times\n");
+	log_info("         fixed:   evenly spaced arrivals\n");
+	log_info("    -S,--sample-ms  sample the throughput every that many msec,\n");
+	log_info("                    0 to disable [%d]\n", ARGUMENT_DEFAULT_SAMPLE_MS);
+	log_info("    -O,--sample-file  write the samples to this file, as JSON if it\n");
+	log_info("                      ends in .json and as CSV otherwise [stdout]\n");
+	log_info("    -J,--results-file  write the results as JSON if the file ends in\n");
+	log_info("                       .json, else append them as a CSV row [none]\n");
+	log_info("    -M,--memory-stats  count the live node memory and report the memory\n");
+	log_info("                       footprint of the map [off]\n");
+	log_info("    -o,--nr-operations  fixed-work mode: number of operations, split among\n");
+	log_info("                        the threads and generated before the run (see\n");
+	log_info("                        opstream.h), 0 for a timed run [%d]\n",
+	         ARGUMENT_DEFAULT_NR_OPERATIONS);
 
 #	ifdef WORKLOAD_TIME
 	log_info("    -r,--run-time-sec execution time [%d sec]\n",
 	        ARGUMENT_DEFAULT_RUN_TIME_SEC);
-#	elif defined(WORKLOAD_FIXED)
-	log_info("    -o,--nr-operations number of operations to execute [%d]\n",
-	        ARGUMENT_DEFAULT_NR_OPERATIONS);
+	log_info("    -P,--scenario  run the phases of this scenario file (see scenario.h)\n");
+	log_info("                   instead of -r and the lookup/rquery/insert fractions\n");
 #	endif
 }
 
@@ -174,13 +254,45 @@ static void clargs_init(int argc, char **argv)
 		case 'f':
 			clargs.sync_type = optarg;
 			break;
+		case 'w':
+			clargs.warmup_mode = optarg;
+			break;
+		case 'a':
+			clargs.alloc_policy = optarg;
+			break;
+		case 'p':
+			clargs.pages = optarg;
+			break;
+		case 'T':
+			clargs.trace_file = optarg;
+			break;
+		case 'R':
+			clargs.arrival_rate = strtoull(optarg, NULL, 10);
+			break;
+		case 'A':
+			clargs.arrivals = optarg;
+			break;
+		case 'S':
+			clargs.sample_ms = atoi(optarg);
+			break;
+		case 'O':
+			clargs.sample_file = optarg;
+			break;
+		case 'J':
+			clargs.results_file = optarg;
+			break;
+		case 'M':
+			clargs.memory_stats = 1;
+			break;
+		case 'o':
+			clargs.nr_operations = strtoull(optarg, NULL, 10);
+			break;
 #		ifdef WORKLOAD_TIME
 		case 'r':
 			clargs.run_time_sec = atoi(optarg);
 			break;
-#		elif defined(WORKLOAD_FIXED)
-		case 'o':
-			clargs.nr_operations = atoi(optarg);
+		case 'P':
+			clargs.scenario_file = optarg;
 			break;
 #		endif
 		default:
@@ -191,6 +303,41 @@ static void clargs_init(int argc, char **argv)
 
 	/* Sanity checks. */
 	assert(clargs.lookup_frac + clargs.rquery_frac + clargs.insert_frac <= 100);
+	assert(clargs.init_tree_size <= clargs.max_key);
+	if (strcmp(clargs.warmup_mode, "seq") && strcmp(clargs.warmup_mode, "par") &&
+	    strcmp(clargs.warmup_mode, "bulk")) {
+		log_error("Wrong warmup mode provided: %s\n", clargs.warmup_mode);
+		clargs_print_usage(argv[0]);
+		exit(1);
+	}
+	if (strcmp(clargs.alloc_policy, "malloc") && strcmp(clargs.alloc_policy, "first-touch") &&
+	    strcmp(clargs.alloc_policy, "interleave") && strcmp(clargs.alloc_policy, "per-socket")) {
+		log_error("Wrong allocation policy provided: %s\n", clargs.alloc_policy);
+		clargs_print_usage(argv[0]);
+		exit(1);
+	}
+	if (strcmp(clargs.pages, "small") && strcmp(clargs.pages, "thp") &&
+	    strcmp(clargs.pages, "hugetlbfs")) {
+		log_error("Wrong pages provided: %s\n", clargs.pages);
+		clargs_print_usage(argv[0]);
+		exit(1);
+	}
+	if (clargs.num_threads > MAP_STATS_MAX_THREADS) {
+		log_error("At most %d threads are supported\n", MAP_STATS_MAX_THREADS);
+		exit(1);
+	}
+	if (strcmp(clargs.arrivals, "poisson") && strcmp(clargs.arrivals, "fixed")) {
+		log_error("Wrong arrivals provided: %s\n", clargs.arrivals);
+		clargs_print_usage(argv[0]);
+		exit(1);
+	}
+#	ifdef WORKLOAD_TIME
+	if (clargs.nr_operations && clargs.scenario_file) {
+		log_error("A scenario cannot be run in fixed-work mode\n");
+		clargs_print_usage(argv[0]);
+		exit(1);
+	}
+#	endif
 }
 
 static void clargs_print()
@@ -207,11 +354,28 @@ static void clargs_print()
 	log_info("  thread_seed: %d\n", clargs.thread_seed);
 	log_info("  ds_name: %s\n", clargs.ds_name);
 	log_info("  sync_type: %s\n", clargs.sync_type);
+	log_info("  warmup_mode: %s\n", clargs.warmup_mode);
+	log_info("  alloc_policy: %s\n", clargs.alloc_policy);
+	log_info("  pages: %s\n", clargs.pages);
+	log_info("  trace_file: %s\n", clargs.trace_file ? clargs.trace_file : "none");
+	if (clargs.arrival_rate)
+		log_info("  arrival_rate: %llu ops/sec (%s)\n", clargs.arrival_rate,
+		         clargs.arrivals);
+	else
+		log_info("  arrival_rate: closed-loop\n");
+	if (clargs.sample_ms)
+		log_info("  sample_ms: %u (to %s)\n", clargs.sample_ms,
+		         clargs.sample_file ? clargs.sample_file : "stdout");
+	log_info("  results_file: %s\n", clargs.results_file ? clargs.results_file : "none");
+	log_info("  memory_stats: %s\n", clargs.memory_stats ? "on" : "off");
+	if (clargs.nr_operations)
+		log_info("  nr_operations: %llu (fixed-work)\n", clargs.nr_operations);
 
 #	ifdef WORKLOAD_TIME
-	log_info("  run_time_sec: %d\n", clargs.run_time_sec);
-#	elif defined(WORKLOAD_FIXED)
-	log_info("  nr_operations: %d\n", clargs.nr_operations);
+	if (!clargs.nr_operations) {
+		log_info("  run_time_sec: %d\n", clargs.run_time_sec);
+		log_info("  scenario: %s\n", clargs.scenario_file ? clargs.scenario_file : "none");
+	}
 #	endif
 
 	log_info("\n");
@@ -0,0 +1,176 @@
+#pragma once
+
+/**
+ * Open-loop load generation and latency recording.
+ *
+ * In open-loop mode every thread issues its operations at predefined arrival
+ * times (fixed-rate or Poisson), instead of issuing the next one as soon as
+ * the previous one returns. The latency of an operation is measured from its
+ * intended arrival time, so the time an operation spends waiting behind a
+ * slow predecessor is accounted for (i.e., no coordinated omission).
+ **/
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <algorithm>
+
+#include "Log.h"
+#include "Keygen.h"
+#include "Timer.h"
+
+//> The TSC where available, so that timing an operation costs nanoseconds.
+static inline uint64_t now_ns()
+{
+	return Timer::now_ns();
+}
+
+//> Sleeps until now_ns() reaches `ns`. As now_ns() is not necessarily
+//> CLOCK_MONOTONIC, this sleeps for the time that is left in steps.
+static inline void sleep_until_ns(uint64_t ns)
+{
+	struct timespec left;
+	for (uint64_t t = now_ns(); t < ns; t = now_ns()) {
+		left.tv_sec = (ns - t) / 1000000000ULL;
+		left.tv_nsec = (ns - t) % 1000000000ULL;
+		nanosleep(&left, NULL);
+	}
+}
+
+/**
+ * Log-linear histogram of latencies in nanoseconds. Values below 2^SUB_BITS
+ * have a bucket of their own and larger values are grouped by their most
+ * significant bit into 2^SUB_BITS sub-buckets, so every value is known with a
+ * relative error of less than 2^-SUB_BITS.
+ **/
+#define LATENCY_SUB_BITS 5
+#define LATENCY_SUB_BUCKETS (1 << LATENCY_SUB_BITS)
+#define LATENCY_BUCKETS ((64 - LATENCY_SUB_BITS + 1) * LATENCY_SUB_BUCKETS)
+
+typedef struct {
+	uint64_t count, sum, max;
+	uint64_t buckets[LATENCY_BUCKETS];
+} latency_hist_t;
+
+/**
+ * The interface provided
+ **/
+static latency_hist_t *latency_hist_new();
+static inline void latency_hist_record(latency_hist_t *hist, uint64_t ns);
+static void latency_hist_add(latency_hist_t *src, latency_hist_t *dst);
+static uint64_t latency_hist_percentile(latency_hist_t *hist, double p);
+static void latency_hist_print(latency_hist_t *hist);
+
+static inline int latency_bucket(uint64_t v)
+{
+	if (v < LATENCY_SUB_BUCKETS) return v;
+	int msb = 63 - __builtin_clzll(v);
+	int shift = msb - LATENCY_SUB_BITS;
+	return ((shift + 1) << LATENCY_SUB_BITS) +
+	       ((v >> shift) & (LATENCY_SUB_BUCKETS - 1));
+}
+
+//> The largest value that falls in bucket `b`.
+static inline uint64_t latency_bucket_max(int b)
+{
+	if (b < LATENCY_SUB_BUCKETS) return b;
+	int shift = (b >> LATENCY_SUB_BITS) - 1;
+	uint64_t sub = (b & (LATENCY_SUB_BUCKETS - 1)) | LATENCY_SUB_BUCKETS;
+	return ((sub + 1) << shift) - 1;
+}
+
+static latency_hist_t *latency_hist_new()
+{
+	latency_hist_t *hist = new latency_hist_t();
+	memset(hist, 0, sizeof(*hist));
+	return hist;
+}
+
+static inline void latency_hist_record(latency_hist_t *hist, uint64_t ns)
+{
+	hist->count++;
+	hist->sum += ns;
+	if (ns > hist->max) hist->max = ns;
+	hist->buckets[latency_bucket(ns)]++;
+}
+
+static void latency_hist_add(latency_hist_t *src, latency_hist_t *dst)
+{
+	dst->count += src->count;
+	dst->sum += src->sum;
+	if (src->max > dst->max) dst->max = src->max;
+	for (int i=0; i < LATENCY_BUCKETS; i++)
+		dst->buckets[i] += src->buckets[i];
+}
+
+//> Returns the (upper bound of the) latency below which p% of the samples lie.
+static uint64_t latency_hist_percentile(latency_hist_t *hist, double p)
+{
+	uint64_t target = (uint64_t)ceil(hist->count * p / 100.0), seen = 0;
+
+	if (target == 0) target = 1;
+	for (int i=0; i < LATENCY_BUCKETS; i++) {
+		seen += hist->buckets[i];
+		if (seen >= target)
+			return std::min(latency_bucket_max(i), hist->max);
+	}
+	return hist->max;
+}
+
+static void latency_hist_print(latency_hist_t *hist)
+{
+	static const double percentiles[] = { 50, 90, 99, 99.9, 99.99 };
+
+	if (hist->count == 0) {
+		log_info("  No operations recorded\n");
+		return;
+	}
+	log_info("  Operations: %llu\n", (unsigned long long)hist->count);
+	log_info("  Mean (usec): %10.2lf\n", hist->sum / (double)hist->count / 1000.0);
+	for (unsigned i=0; i < sizeof(percentiles) / sizeof(percentiles[0]); i++)
+		log_info("  p%-5g (usec): %10.2lf\n", percentiles[i],
+		         latency_hist_percentile(hist, percentiles[i]) / 1000.0);
+	log_info("  Max (usec): %11.2lf\n", hist->max / 1000.0);
+}
+
+/**
+ * Generates the intended arrival times of one thread's operations, for an
+ * average rate of `rate` operations per second.
+ **/
+class ArrivalGenerator {
+public:
+	ArrivalGenerator(bool poisson, double rate, uint64_t seed)
+	{
+		this->poisson = poisson;
+		this->mean_gap_ns = 1000000000.0 / rate;
+		this->rng.set_seed(seed);
+		this->next_ns = 0;
+	}
+
+	//> Sets the intended start time of the first operation.
+	void start(uint64_t start_ns) { next_ns = start_ns; }
+
+	double mean_gap() { return mean_gap_ns; }
+
+	//> Returns the intended start time of the next operation.
+	uint64_t next()
+	{
+		uint64_t ret = (uint64_t)next_ns;
+		double gap = mean_gap_ns;
+		if (poisson) {
+			//> Exponential inter-arrival times, u is in [0,1).
+			double u = (rng.next() >> 11) * (1.0 / 9007199254740992.0);
+			gap = -log(1.0 - u) * mean_gap_ns;
+		}
+		next_ns += gap;
+		return ret;
+	}
+
+private:
+	bool poisson;
+	double mean_gap_ns;
+	double next_ns;
+	RandomFNV1A rng;
+};
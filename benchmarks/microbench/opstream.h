@@ -0,0 +1,94 @@
+#pragma once
+
+/**
+ * Pregenerated operation streams for the fixed-work mode.
+ *
+ * With --nr-operations every thread performs a fixed number of operations
+ * instead of running for a fixed time. Before the start barrier each thread
+ * generates its whole stream of operations (the type, key and value of each
+ * one) into a buffer, with the same generators and seeds that the timed mode
+ * uses on the fly, and the measured loop only reads the next record. So the
+ * random number generation is not measured and, for the same seeds and number
+ * of threads, every run performs exactly the same operations, whatever the
+ * data structure.
+ *
+ * The buffer takes sizeof(opstream_rec_t) bytes per operation and is allocated
+ * and filled by the thread that replays it, i.e., on its own NUMA node.
+ **/
+
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "Log.h"
+
+typedef struct {
+	map_key_t key;
+	map_val_t val;
+	uint64_t rquery_len; //> Trace records carry 64-bit lengths.
+	uint8_t op;
+} opstream_rec_t;
+
+typedef struct {
+	opstream_rec_t *recs;
+	unsigned long long nr_recs;
+	unsigned long long next;
+} opstream_t;
+
+/**
+ * The interface provided
+ **/
+static opstream_t *opstream_new(unsigned long long nr_recs);
+static inline void opstream_push(opstream_t *stream, int op, map_key_t key,
+                                 map_val_t val, unsigned long long rquery_len);
+static inline bool opstream_next(opstream_t *stream, int *op, map_key_t *key,
+                                 map_val_t *val, unsigned long long *rquery_len);
+static void opstream_free(opstream_t *stream);
+
+//> Operations of thread `tid` when `nr_operations` are split among `nthreads`.
+static inline unsigned long long opstream_thread_ops(unsigned long long nr_operations,
+                                                     int tid, int nthreads)
+{
+	return nr_operations * (tid + 1) / nthreads - nr_operations * tid / nthreads;
+}
+
+static opstream_t *opstream_new(unsigned long long nr_recs)
+{
+	opstream_t *stream = new opstream_t();
+	stream->recs = (opstream_rec_t *)malloc(nr_recs * sizeof(opstream_rec_t));
+	if (nr_recs && !stream->recs) {
+		log_error("opstream: could not allocate %llu operations\n", nr_recs);
+		exit(1);
+	}
+	stream->nr_recs = 0;
+	stream->next = 0;
+	return stream;
+}
+
+static inline void opstream_push(opstream_t *stream, int op, map_key_t key,
+                                 map_val_t val, unsigned long long rquery_len)
+{
+	opstream_rec_t *rec = &stream->recs[stream->nr_recs++];
+	rec->key = key;
+	rec->val = val;
+	rec->rquery_len = rquery_len;
+	rec->op = op;
+}
+
+//> Returns false when the stream has been exhausted.
+static inline bool opstream_next(opstream_t *stream, int *op, map_key_t *key,
+                                 map_val_t *val, unsigned long long *rquery_len)
+{
+	if (stream->next == stream->nr_recs) return false;
+	opstream_rec_t *rec = &stream->recs[stream->next++];
+	*op = rec->op;
+	*key = rec->key;
+	*val = rec->val;
+	*rquery_len = rec->rquery_len;
+	return true;
+}
+
+static void opstream_free(opstream_t *stream)
+{
+	free(stream->recs);
+	delete stream;
+}
@@ -0,0 +1,238 @@
+#pragma once
+
+/**
+ * Machine-readable results of a microbenchmark run.
+ *
+ * With --results-file the outcome of the run is written, next to the usual
+ * log, either as a JSON document (if the filename ends in ".json") or as a
+ * CSV row (otherwise). CSV rows are appended, with a header line when the file
+ * is new, so a sweep over many configurations can share one file. The JSON
+ * document also carries the per-thread counters, the latency percentiles of
+ * the open-loop mode, the per-phase throughput of a scenario, the hardware
+ * counters per operation, the memory footprint of the map by node type and
+ * the internal events of the map.
+ * `scripts/sweep.py` drives such sweeps and compares them to a baseline.
+ **/
+
+#include <stdio.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <vector>
+
+#include "Log.h"
+#include "MemoryStats.h"
+#include "MapStats.h"
+#include "PerfCounters.h"
+#include "JsonString.h"
+#include "latency.h"
+#include "scenario.h"
+#include "thread_data.h"
+#include "sampler.h" //> For sampler_op_names
+
+typedef struct {
+	const char *map_name;
+	int nthreads;
+	thread_data_t **threads_data;
+	thread_data_t *total_data;
+	double time_elapsed;
+	double throughput;    //> Ops/usec
+	bool validation;
+	unsigned long long expected_size;
+	latency_hist_t *latency; //> NULL in closed-loop mode.
+	scenario_t *scenario;    //> NULL without a scenario file.
+	MemoryStats *memory;
+	MapStats *map_stats;
+	std::vector<double> phase_throughput;
+} results_t;
+
+/**
+ * The interface provided
+ **/
+static void results_write(results_t *res, const char *filename);
+
+static const double results_percentiles[] = { 50, 90, 99, 99.9, 99.99 };
+#define RESULTS_NR_PERCENTILES \
+	(sizeof(results_percentiles) / sizeof(results_percentiles[0]))
+
+static void results_write_counters(thread_data_t *d, FILE *fp)
+{
+	fprintf(fp, "{ \"tid\": %d, \"cpu\": %d", d->tid, d->cpu);
+	for (int op=0; op < OPS_END; op++)
+		fprintf(fp, ", \"%s\": [%llu, %llu]", sampler_op_names[op],
+		        d->operations_performed[op], d->operations_succeeded[op]);
+	fprintf(fp, " }");
+}
+
+static void results_write_json(results_t *res, FILE *fp)
+{
+	fprintf(fp, "{\n");
+	fprintf(fp, "  \"config\": {\n");
+	fprintf(fp, "    \"ds_name\": %s,\n", json_string(clargs.ds_name).c_str());
+	fprintf(fp, "    \"sync_type\": %s,\n", json_string(clargs.sync_type).c_str());
+	fprintf(fp, "    \"map_name\": %s,\n", json_string(res->map_name).c_str());
+	fprintf(fp, "    \"key_size\": %zu,\n", sizeof(map_key_t));
+	fprintf(fp, "    \"num_threads\": %u,\n", clargs.num_threads);
+	fprintf(fp, "    \"init_tree_size\": %u,\n", clargs.init_tree_size);
+	fprintf(fp, "    \"max_key\": %u,\n", clargs.max_key);
+	fprintf(fp, "    \"lookup_frac\": %u,\n", clargs.lookup_frac);
+	fprintf(fp, "    \"rquery_frac\": %u,\n", clargs.rquery_frac);
+	fprintf(fp, "    \"insert_frac\": %u,\n", clargs.insert_frac);
+	fprintf(fp, "    \"init_seed\": %u,\n", clargs.init_seed);
+	fprintf(fp, "    \"thread_seed\": %u,\n", clargs.thread_seed);
+	fprintf(fp, "    \"warmup_mode\": %s,\n", json_string(clargs.warmup_mode).c_str());
+	fprintf(fp, "    \"alloc_policy\": %s,\n", json_string(clargs.alloc_policy).c_str());
+	fprintf(fp, "    \"pages\": %s,\n", json_string(clargs.pages).c_str());
+	fprintf(fp, "    \"trace_file\": %s,\n", json_string(clargs.trace_file).c_str());
+	fprintf(fp, "    \"arrival_rate\": %llu,\n", clargs.arrival_rate);
+	fprintf(fp, "    \"arrivals\": %s,\n", json_string(clargs.arrivals).c_str());
+#	ifdef WORKLOAD_TIME
+	fprintf(fp, "    \"scenario\": %s,\n", json_string(clargs.scenario_file).c_str());
+	fprintf(fp, "    \"run_time_sec\": %d,\n", clargs.run_time_sec);
+#	endif
+	fprintf(fp, "    \"nr_operations\": %llu\n", clargs.nr_operations);
+	fprintf(fp, "  },\n");
+
+	//> [performed, succeeded] operations of every type.
+	fprintf(fp, "  \"threads\": [\n");
+	for (int i=0; i < res->nthreads; i++) {
+		fprintf(fp, "    ");
+		results_write_counters(res->threads_data[i], fp);
+		fprintf(fp, "%s\n", (i + 1 < res->nthreads) ? "," : "");
+	}
+	fprintf(fp, "  ],\n");
+	fprintf(fp, "  \"total\": ");
+	results_write_counters(res->total_data, fp);
+	fprintf(fp, ",\n");
+
+	fprintf(fp, "  \"time_elapsed_sec\": %.6lf,\n", res->time_elapsed);
+	fprintf(fp, "  \"throughput_mops\": %.6lf,\n", res->throughput);
+	fprintf(fp, "  \"validation\": %s,\n", res->validation ? "true" : "false");
+	fprintf(fp, "  \"expected_size\": %llu,\n", res->expected_size);
+
+	if (res->latency && res->latency->count > 0) {
+		fprintf(fp, "  \"latency_usec\": { \"mean\": %.3lf",
+		        res->latency->sum / (double)res->latency->count / 1000.0);
+		for (unsigned i=0; i < RESULTS_NR_PERCENTILES; i++)
+			fprintf(fp, ", \"p%g\": %.3lf", results_percentiles[i],
+			        latency_hist_percentile(res->latency, results_percentiles[i]) / 1000.0);
+		fprintf(fp, ", \"max\": %.3lf },\n", res->latency->max / 1000.0);
+	}
+
+	if (res->scenario) {
+		fprintf(fp, "  \"phases\": [\n");
+		for (size_t p=0; p < res->phase_throughput.size(); p++)
+			fprintf(fp, "    { \"desc\": %s, \"throughput_mops\": %.6lf }%s\n",
+			        json_string(res->scenario->phases[p].desc).c_str(),
+			        res->phase_throughput[p],
+			        (p + 1 < res->phase_throughput.size()) ? "," : "");
+		fprintf(fp, "  ],\n");
+	}
+
+	if (PerfCounters::available()) {
+		unsigned long long ops = res->total_data->operations_performed[OPS_TOTAL];
+		fprintf(fp, "  \"hw_counters_per_op\": {");
+		for (int e=0, first=1; e < PerfCounters::NR_EVENTS; e++) {
+			if (!PerfCounters::available((PerfCounters::event_t)e)) continue;
+			fprintf(fp, "%s \"%s\": %.4lf", first ? "" : ",", PerfCounters::event_name(e),
+			        ops ? (double)PerfCounters::total((PerfCounters::event_t)e) / ops : 0.0);
+			first = 0;
+		}
+		fprintf(fp, " },\n");
+	}
+
+	fprintf(fp, "  \"memory\": {\n");
+	fprintf(fp, "    \"alloc_policy\": %s,\n", json_string(NodeAllocator::policy_name()).c_str());
+	fprintf(fp, "    \"pages\": %s", json_string(NodeAllocator::pages_name()).c_str());
+	if (res->memory) {
+		MemoryStats *mem = res->memory;
+		fprintf(fp, ",\n    \"node_types\": [");
+		for (size_t i=0; i < mem->node_types.size(); i++)
+			fprintf(fp, "%s\n      { \"name\": %s, \"size\": %zu, \"count\": %llu }",
+			        i ? "," : "", json_string(mem->node_types[i].name).c_str(),
+			        mem->node_types[i].size,
+			        mem->node_types[i].count);
+		fprintf(fp, "%s],\n", mem->node_types.empty() ? "" : "\n    ");
+		fprintf(fp, "    \"keys\": %llu,\n", mem->keys);
+		fprintf(fp, "    \"allocated_bytes\": %llu,\n", mem->allocated_bytes());
+		if (mem->walked()) {
+			fprintf(fp, "    \"reachable_bytes\": %llu,\n", mem->reachable_bytes());
+			fprintf(fp, "    \"retired_bytes\": %llu,\n", mem->retired_bytes());
+		}
+		fprintf(fp, "    \"bytes_per_key\": %.2lf", mem->bytes_per_key());
+	}
+	fprintf(fp, "\n  }");
+
+	//> Only the events that the data structure counts.
+	if (res->map_stats) {
+		fprintf(fp, ",\n  \"map_stats\": {");
+		for (int s=0, first=1; s < MAP_NR_STATS; s++) {
+			if (res->map_stats->counts[s] == 0) continue;
+			fprintf(fp, "%s \"%s\": %llu", first ? "" : ",", MapStats::name(s),
+			        res->map_stats->counts[s]);
+			first = 0;
+		}
+		fprintf(fp, " }");
+	}
+	fprintf(fp, "\n");
+	fprintf(fp, "}\n");
+}
+
+static void results_write_csv(results_t *res, FILE *fp, bool header)
+{
+	if (header) {
+		fprintf(fp, "ds_name,sync_type,num_threads,init_tree_size,max_key,"
+		            "lookup_frac,rquery_frac,insert_frac,warmup_mode,alloc_policy,"
+		            "pages,arrival_rate,time_elapsed_sec,throughput_mops,"
+		            "validation,expected_size");
+		for (int op=1; op < OPS_END; op++)
+			fprintf(fp, ",%s_performed,%s_succeeded", sampler_op_names[op],
+			        sampler_op_names[op]);
+		for (unsigned i=0; i < RESULTS_NR_PERCENTILES; i++)
+			fprintf(fp, ",p%g_usec", results_percentiles[i]);
+		fprintf(fp, ",allocated_bytes,bytes_per_key");
+		fprintf(fp, "\n");
+	}
+
+	fprintf(fp, "%s,%s,%u,%u,%u,%u,%u,%u,%s,%s,%s,%llu,%.6lf,%.6lf,%d,%llu",
+	        clargs.ds_name, clargs.sync_type, clargs.num_threads,
+	        clargs.init_tree_size, clargs.max_key, clargs.lookup_frac,
+	        clargs.rquery_frac, clargs.insert_frac, clargs.warmup_mode,
+	        clargs.alloc_policy, clargs.pages, clargs.arrival_rate,
+	        res->time_elapsed, res->throughput, res->validation,
+	        res->expected_size);
+	for (int op=1; op < OPS_END; op++)
+		fprintf(fp, ",%llu,%llu", res->total_data->operations_performed[op],
+		        res->total_data->operations_succeeded[op]);
+	for (unsigned i=0; i < RESULTS_NR_PERCENTILES; i++) {
+		if (res->latency && res->latency->count > 0)
+			fprintf(fp, ",%.3lf",
+			        latency_hist_percentile(res->latency, results_percentiles[i]) / 1000.0);
+		else
+			fprintf(fp, ",");
+	}
+	if (res->memory)
+		fprintf(fp, ",%llu,%.2lf", res->memory->allocated_bytes(),
+		        res->memory->bytes_per_key());
+	else
+		fprintf(fp, ",,");
+	fprintf(fp, "\n");
+}
+
+static void results_write(results_t *res, const char *filename)
+{
+	size_t len = strlen(filename);
+	bool json = (len >= 5 && !strcmp(filename + len - 5, ".json"));
+	struct stat st;
+	bool header = (stat(filename, &st) != 0 || st.st_size == 0);
+	FILE *fp;
+
+	fp = fopen(filename, json ? "w" : "a");
+	if (!fp) {
+		log_error("results: could not open %s\n", filename);
+		return;
+	}
+	if (json) results_write_json(res, fp);
+	else      results_write_csv(res, fp, header);
+	fclose(fp);
+	log_info("Results written to %s\n", filename);
+}
@@ -0,0 +1,188 @@
+#pragma once
+
+/**
+ * Time-series sampling of the benchmark threads' operation counters.
+ *
+ * A sampler thread wakes up every `interval_ms` milliseconds and snapshots
+ * the operations_performed counters of all the threads. The samples are kept
+ * in memory and written out, as CSV or JSON, after the run, so the time series
+ * shows warm-up transients, dips caused by background work (rebuilds,
+ * consolidation, maintenance threads) and the steady state.
+ **/
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+#include <vector>
+
+#include "Log.h"
+#include "latency.h" //> For now_ns()
+#include "thread_data.h"
+
+typedef struct {
+	thread_data_t **threads_data;
+	int nthreads;
+	unsigned int interval_ms;
+	uint64_t start_ns;
+	volatile int stop;
+	pthread_t thread;
+
+	//> Sample i was taken at times[i] ns after the start and its counters are
+	//> counts[(i * nthreads + tid) * OPS_END + op].
+	std::vector<uint64_t> times;
+	std::vector<unsigned long long> counts;
+} sampler_t;
+
+/**
+ * The interface provided
+ **/
+static sampler_t *sampler_start(thread_data_t **threads_data, int nthreads,
+                                unsigned int interval_ms);
+static void sampler_stop(sampler_t *sampler);
+static void sampler_write(sampler_t *sampler, const char *filename);
+
+static void sampler_snapshot(sampler_t *sampler, uint64_t t_ns)
+{
+	sampler->times.push_back(t_ns);
+	for (int i=0; i < sampler->nthreads; i++) {
+		volatile unsigned long long *ops =
+		                  sampler->threads_data[i]->operations_performed;
+		for (int op=0; op < OPS_END; op++)
+			sampler->counts.push_back((unsigned long long)ops[op]);
+	}
+}
+
+static void *sampler_fn(void *arg)
+{
+	sampler_t *sampler = (sampler_t *)arg;
+	uint64_t next_ns = sampler->start_ns;
+
+	while (1) {
+		//> Absolute deadlines, so that the samples do not drift.
+		next_ns += sampler->interval_ms * 1000000ULL;
+		sleep_until_ns(next_ns);
+		if (sampler->stop)
+			break;
+		sampler_snapshot(sampler, now_ns() - sampler->start_ns);
+	}
+	return NULL;
+}
+
+static sampler_t *sampler_start(thread_data_t **threads_data, int nthreads,
+                                unsigned int interval_ms)
+{
+	sampler_t *sampler = new sampler_t();
+
+	sampler->threads_data = threads_data;
+	sampler->nthreads = nthreads;
+	sampler->interval_ms = interval_ms;
+	sampler->stop = 0;
+	//> Room for a few minutes of samples, so the sampler does not reallocate.
+	sampler->times.reserve(4096);
+	sampler->counts.reserve(4096 * nthreads * OPS_END);
+	sampler->start_ns = now_ns();
+	sampler_snapshot(sampler, 0);
+	pthread_create(&sampler->thread, NULL, sampler_fn, sampler);
+	return sampler;
+}
+
+//> Must be called after the benchmark threads have stopped. The last sample
+//> covers the (shorter) interval up to this call.
+static void sampler_stop(sampler_t *sampler)
+{
+	uint64_t t_ns = now_ns() - sampler->start_ns;
+
+	sampler->stop = 1;
+	pthread_join(sampler->thread, NULL);
+	if (t_ns > sampler->times.back())
+		sampler_snapshot(sampler, t_ns);
+}
+
+//> The operations performed so far by all the threads. Read while they run.
+static unsigned long long total_ops_performed(thread_data_t **threads_data,
+                                              int nthreads)
+{
+	unsigned long long ops = 0;
+	for (int i=0; i < nthreads; i++)
+		ops += *(volatile unsigned long long *)
+		         &threads_data[i]->operations_performed[OPS_TOTAL];
+	return ops;
+}
+
+//> Throughput (Mops/sec) of `op` between samples i-1 and i, for thread `tid`
+//> or all the threads if tid is -1.
+static double sampler_throughput(sampler_t *sampler, int i, int tid, int op)
+{
+	unsigned long long ops = 0;
+	int first = (tid < 0) ? 0 : tid, last = (tid < 0) ? sampler->nthreads : tid + 1;
+
+	for (int t=first; t < last; t++)
+		ops += sampler->counts[(i * sampler->nthreads + t) * OPS_END + op] -
+		       sampler->counts[((i-1) * sampler->nthreads + t) * OPS_END + op];
+	return ops * 1000.0 / (sampler->times[i] - sampler->times[i-1]);
+}
+
+static const char *sampler_op_names[OPS_END] = {
+	"total", "lookup", "rquery", "insert", "delete"
+};
+
+static void sampler_write_csv(sampler_t *sampler, FILE *fp)
+{
+	fprintf(fp, "time_ms");
+	for (int op=0; op < OPS_END; op++)
+		fprintf(fp, ",%s_mops", sampler_op_names[op]);
+	for (int t=0; t < sampler->nthreads; t++)
+		fprintf(fp, ",thread%d_mops", t);
+	fprintf(fp, "\n");
+
+	for (size_t i=1; i < sampler->times.size(); i++) {
+		fprintf(fp, "%.1lf", sampler->times[i] / 1000000.0);
+		for (int op=0; op < OPS_END; op++)
+			fprintf(fp, ",%.4lf", sampler_throughput(sampler, i, -1, op));
+		for (int t=0; t < sampler->nthreads; t++)
+			fprintf(fp, ",%.4lf", sampler_throughput(sampler, i, t, OPS_TOTAL));
+		fprintf(fp, "\n");
+	}
+}
+
+static void sampler_write_json(sampler_t *sampler, FILE *fp)
+{
+	fprintf(fp, "{\n  \"interval_ms\": %u,\n  \"nthreads\": %d,\n",
+	        sampler->interval_ms, sampler->nthreads);
+	fprintf(fp, "  \"unit\": \"Mops/sec\",\n  \"samples\": [\n");
+	for (size_t i=1; i < sampler->times.size(); i++) {
+		fprintf(fp, "    { \"time_ms\": %.1lf", sampler->times[i] / 1000000.0);
+		for (int op=0; op < OPS_END; op++)
+			fprintf(fp, ", \"%s\": %.4lf", sampler_op_names[op],
+			        sampler_throughput(sampler, i, -1, op));
+		fprintf(fp, ", \"per_thread\": [");
+		for (int t=0; t < sampler->nthreads; t++)
+			fprintf(fp, "%s%.4lf", t ? ", " : "",
+			        sampler_throughput(sampler, i, t, OPS_TOTAL));
+		fprintf(fp, "] }%s\n", (i + 1 < sampler->times.size()) ? "," : "");
+	}
+	fprintf(fp, "  ]\n}\n");
+}
+
+//> Writes the time series to `filename`, as JSON if it ends in ".json" and as
+//> CSV otherwise. With a NULL filename the CSV goes to stdout.
+static void sampler_write(sampler_t *sampler, const char *filename)
+{
+	FILE *fp = stdout;
+	size_t len = filename ? strlen(filename) : 0;
+	bool json = (len >= 5 && !strcmp(filename + len - 5, ".json"));
+
+	if (filename && !(fp = fopen(filename, "w"))) {
+		log_error("sampler: could not open %s\n", filename);
+		return;
+	}
+	if (json) sampler_write_json(sampler, fp);
+	else      sampler_write_csv(sampler, fp);
+	if (filename) {
+		fclose(fp);
+		log_info("Time series of %zu samples written to %s\n",
+		         sampler->times.size() - 1, filename);
+	}
+}
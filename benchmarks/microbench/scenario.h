@@ -0,0 +1,219 @@
+#pragma once
+
+/**
+ * Phased workload scenarios.
+ *
+ * A scenario is a sequence of phases that are executed one after the other on
+ * the same map, without rebuilding it. A scenario file has one phase per line,
+ * given as `name=value` pairs:
+ *
+ *   # read-heavy on a uniform key space, then a write-heavy burst on a hot
+ *   # range that moves to the middle of the key space
+ *   duration=5 lookup=90 insert=5
+ *   duration=2 lookup=20 insert=40 dist=hot:0.1:0.9 offset=100000
+ *   duration=5 lookup=90 insert=5 dist=zipf:0.99
+ *
+ *   duration  phase duration in seconds (may be fractional)     [required]
+ *   lookup, rquery, insert
+ *             operation mix in %, the rest are deletions         [0]
+ *   dist      key distribution                                   [uniform]
+ *               uniform
+ *               zipf:<theta>       zipfian with theta in (0,1), key 0 hottest
+ *               hot:<keys>:<ops>   fraction <ops> of the accesses go to the
+ *                                  first fraction <keys> of the key space
+ *   offset    the keys of the distribution are shifted by offset (modulo
+ *             the key space), which moves the hot keys around    [0]
+ *
+ * Without a scenario file, the benchmark runs a single phase built from the
+ * command line arguments.
+ **/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+#include "Log.h"
+#include "Keygen.h"
+
+typedef enum {
+	DIST_UNIFORM = 0,
+	DIST_ZIPF,
+	DIST_HOT
+} key_dist_t;
+
+typedef struct {
+	double duration_sec;
+	unsigned lookup_frac, rquery_frac, insert_frac;
+	key_dist_t dist;
+	double dist_param1, dist_param2;
+	double zetan; //> Precomputed for the zipfian distribution.
+	unsigned long long offset;
+	char desc[128];
+} phase_t;
+
+typedef struct {
+	const char *filename;
+	std::vector<phase_t> phases;
+} scenario_t;
+
+/**
+ * The interface provided
+ **/
+static scenario_t *scenario_load(const char *filename, unsigned long long max_key);
+static scenario_t *scenario_single_phase(double duration_sec, unsigned lookup_frac,
+                                         unsigned rquery_frac, unsigned insert_frac);
+static KeyGenerator *phase_keygen_new(phase_t *phase, uint64_t seed,
+                                      unsigned long long max_key);
+static void scenario_print(scenario_t *scenario);
+
+static void phase_set_desc(phase_t *phase)
+{
+	char dist[48];
+
+	if (phase->dist == DIST_ZIPF)
+		snprintf(dist, sizeof(dist), "zipf:%g", phase->dist_param1);
+	else if (phase->dist == DIST_HOT)
+		snprintf(dist, sizeof(dist), "hot:%g:%g", phase->dist_param1,
+		         phase->dist_param2);
+	else
+		snprintf(dist, sizeof(dist), "uniform");
+	snprintf(phase->desc, sizeof(phase->desc), "%gs %u/%u/%u/%u %s+%llu",
+	         phase->duration_sec, phase->lookup_frac, phase->rquery_frac,
+	         phase->insert_frac, 100 - phase->lookup_frac - phase->rquery_frac -
+	         phase->insert_frac, dist, phase->offset);
+}
+
+static void scenario_parse_error(const char *filename, int lineno, const char *msg,
+                                 const char *token)
+{
+	log_error("%s:%d: %s: %s\n", filename, lineno, msg, token);
+	exit(1);
+}
+
+static scenario_t *scenario_load(const char *filename, unsigned long long max_key)
+{
+	scenario_t *scenario = new scenario_t();
+	char line[1024];
+	int lineno = 0;
+	FILE *fp;
+
+	fp = fopen(filename, "r");
+	if (!fp) {
+		log_error("scenario: could not open %s\n", filename);
+		exit(1);
+	}
+	scenario->filename = filename;
+
+	while (fgets(line, sizeof(line), fp)) {
+		phase_t phase;
+		char *token, *saveptr;
+
+		lineno++;
+		if (strchr(line, '#')) *strchr(line, '#') = '\0';
+
+		memset(&phase, 0, sizeof(phase));
+		phase.dist = DIST_UNIFORM;
+		token = strtok_r(line, " \t\r\n", &saveptr);
+		if (!token) continue;
+		for (; token; token = strtok_r(NULL, " \t\r\n", &saveptr)) {
+			char *value = strchr(token, '=');
+			if (!value) scenario_parse_error(filename, lineno, "expected name=value", token);
+			*value++ = '\0';
+
+			if (!strcmp(token, "duration")) {
+				phase.duration_sec = atof(value);
+			} else if (!strcmp(token, "lookup")) {
+				phase.lookup_frac = atoi(value);
+			} else if (!strcmp(token, "rquery")) {
+				phase.rquery_frac = atoi(value);
+			} else if (!strcmp(token, "insert")) {
+				phase.insert_frac = atoi(value);
+			} else if (!strcmp(token, "offset")) {
+				phase.offset = strtoull(value, NULL, 10);
+			} else if (!strcmp(token, "dist")) {
+				if (!strcmp(value, "uniform")) {
+					phase.dist = DIST_UNIFORM;
+				} else if (sscanf(value, "zipf:%lf", &phase.dist_param1) == 1) {
+					phase.dist = DIST_ZIPF;
+					if (phase.dist_param1 <= 0 || phase.dist_param1 >= 1)
+						scenario_parse_error(filename, lineno,
+						                     "zipf theta must be in (0,1)", value);
+				} else if (sscanf(value, "hot:%lf:%lf", &phase.dist_param1,
+				                  &phase.dist_param2) == 2) {
+					phase.dist = DIST_HOT;
+					if (phase.dist_param1 <= 0 || phase.dist_param1 > 1 ||
+					    phase.dist_param2 < 0 || phase.dist_param2 > 1)
+						scenario_parse_error(filename, lineno,
+						                     "hot fractions must be in [0,1]", value);
+				} else {
+					scenario_parse_error(filename, lineno, "unknown distribution", value);
+				}
+			} else {
+				scenario_parse_error(filename, lineno, "unknown field", token);
+			}
+		}
+
+		if (phase.duration_sec <= 0)
+			scenario_parse_error(filename, lineno, "missing or wrong", "duration");
+		if (phase.lookup_frac + phase.rquery_frac + phase.insert_frac > 100)
+			scenario_parse_error(filename, lineno, "operation mix exceeds", "100%");
+		phase.offset %= max_key;
+		if (phase.dist == DIST_ZIPF)
+			phase.zetan = KeyGeneratorZipfFast::zeta(max_key, phase.dist_param1);
+		phase_set_desc(&phase);
+		scenario->phases.push_back(phase);
+	}
+	fclose(fp);
+
+	if (scenario->phases.empty()) {
+		log_error("scenario: %s has no phases\n", filename);
+		exit(1);
+	}
+	return scenario;
+}
+
+static scenario_t *scenario_single_phase(double duration_sec, unsigned lookup_frac,
+                                         unsigned rquery_frac, unsigned insert_frac)
+{
+	scenario_t *scenario = new scenario_t();
+	phase_t phase;
+
+	memset(&phase, 0, sizeof(phase));
+	phase.duration_sec = duration_sec;
+	phase.lookup_frac = lookup_frac;
+	phase.rquery_frac = rquery_frac;
+	phase.insert_frac = insert_frac;
+	phase.dist = DIST_UNIFORM;
+	phase_set_desc(&phase);
+	scenario->filename = NULL;
+	scenario->phases.push_back(phase);
+	return scenario;
+}
+
+//> Returns a generator of keys in [0, max_key) that follow the phase's
+//> distribution, before the phase's offset is applied.
+static KeyGenerator *phase_keygen_new(phase_t *phase, uint64_t seed,
+                                      unsigned long long max_key)
+{
+	switch (phase->dist) {
+	case DIST_ZIPF:
+		return new KeyGeneratorZipfFast(seed, max_key, phase->dist_param1,
+		                                phase->zetan);
+	case DIST_HOT:
+		return new KeyGeneratorHotspot(seed, max_key, phase->dist_param1,
+		                               phase->dist_param2);
+	default:
+		return new KeyGeneratorUniform(seed, max_key);
+	}
+}
+
+static void scenario_print(scenario_t *scenario)
+{
+	log_info("Scenario\n");
+	log_info("=======================\n");
+	log_info("  File: %s\n", scenario->filename);
+	log_info("  Phases (duration lookup/rquery/insert/delete dist+offset):\n");
+	for (size_t i=0; i < scenario->phases.size(); i++)
+		log_info("  %3zu: %s\n", i, scenario->phases[i].desc);
+}
@@ -0,0 +1,72 @@
+#!/usr/bin/env python3
+
+##
+## Converts a text access trace to the binary format that is replayed by
+## `x.microbench --trace-file` (see trace.h).
+##
+## Every line of the text trace is `op key [value]`, where op is one of
+## lookup/insert/delete/rquery (or just l/i/d/r). With --with-tid every line
+## starts with the id of the thread that performed the access, and the trace
+## gets one partition per thread, in increasing order of thread id. An insert
+## may not store 0 (its value, or else its key), which the maps take for
+## NO_VALUE.
+##
+## usage: mktrace.py [--with-tid] input.txt output.trace
+##
+
+import sys, struct
+
+OPS = { 'l': 0, 'lookup': 0, 'i': 1, 'insert': 1,
+        'd': 2, 'delete': 2, 'r': 3, 'rquery': 3 }
+
+def parse(fname, with_tid):
+	partitions = dict()
+	has_values = False
+	for lineno, line in enumerate(open(fname), 1):
+		fields = line.split()
+		if not fields or fields[0].startswith('#'):
+			continue
+		tid = 0
+		if with_tid:
+			tid = int(fields[0])
+			fields = fields[1:]
+		if len(fields) not in (2, 3) or fields[0].lower() not in OPS:
+			sys.exit("%s:%d: wrong line: %s" % (fname, lineno, line.strip()))
+		op = OPS[fields[0].lower()]
+		key = int(fields[1])
+		value = int(fields[2]) if len(fields) == 3 else None
+		if op == OPS['insert'] and (key if value is None else value) == 0:
+			sys.exit("%s:%d: insert of value 0: %s" % (fname, lineno, line.strip()))
+		has_values = has_values or value is not None
+		partitions.setdefault(tid, []).append((op, key, value))
+	return [partitions[tid] for tid in sorted(partitions)], has_values
+
+def write(fname, partitions, has_values):
+	nr_records = sum(len(p) for p in partitions)
+	record_size = 17 if has_values else 9
+	out = open(fname, 'wb')
+	out.write(struct.pack('<8sIIIIQ', b'MAPTRACE', 1, record_size,
+	                      len(partitions), 0, nr_records))
+	for p in partitions:
+		out.write(struct.pack('<Q', len(p)))
+	for p in partitions:
+		for (op, key, value) in p:
+			if has_values:
+				## The values that trace.h uses for records without one.
+				if value is None: value = 10000 if op == 3 else key
+				out.write(struct.pack('<BQQ', op, key, value))
+			else:
+				out.write(struct.pack('<BQ', op, key))
+	out.close()
+	print("%s: %d records, %d partitions" % (fname, nr_records, len(partitions)))
+
+if __name__ == '__main__':
+	args = sys.argv[1:]
+	with_tid = '--with-tid' in args
+	args = [a for a in args if a != '--with-tid']
+	if len(args) != 2:
+		sys.exit("usage: %s [--with-tid] input.txt output.trace" % sys.argv[0])
+	partitions, has_values = parse(args[0], with_tid)
+	if not partitions:
+		sys.exit("%s: no accesses found" % args[0])
+	write(args[1], partitions, has_values)
@@ -0,0 +1,142 @@
+#!/usr/bin/env python3
+
+##
+## Sweeps the microbenchmark over data structures x sync types x threads x
+## workloads, collects the JSON results of every run (see results.h) into one
+## file and, given a baseline file from an earlier sweep, prints a comparison
+## table and exits with 1 if any configuration regressed.
+##
+## usage: sweep.py [--bin ./x.microbench.ullong] [--ds bst-unb-ext,treap]
+##                 [--sync none,cg-spinlock] [--threads 1,2,4]
+##                 [--workloads 100_0_0,50_25_25] [--size 100000]
+##                 [--runtime 5] [--repeat 3] [--out results.json]
+##                 [--baseline baseline.json] [--threshold 5]
+##                 [-- extra microbench arguments]
+##
+## A workload is lookup_insert_delete percentages, as in run.sh.
+## Data structures and sync types that the factory does not know (see
+## ds/map_factory.h) are reported and skipped.
+##
+
+import sys, os, json, subprocess, tempfile, argparse
+
+def config_key(c):
+	return "%s/%s t=%d wl=%s s=%d" % (c['ds'], c['sync'], c['threads'],
+	                                  c['workload'], c['size'])
+
+def median(values):
+	values = sorted(values)
+	n = len(values)
+	return values[n//2] if n % 2 else (values[n//2-1] + values[n//2]) / 2.0
+
+def run_one(args, ds, sync, t, wl, extra):
+	lookup, insert, delete = [int(x) for x in wl.split('_')]
+	fd, res_file = tempfile.mkstemp(suffix='.json')
+	os.close(fd)
+	cmd = [args.bin, '-d', ds, '-f', sync, '-t', str(t),
+	       '-s', str(args.size), '-m', str(2 * args.size),
+	       '-l', str(lookup), '-i', str(insert), '-r', str(args.runtime),
+	       '-J', res_file] + extra
+	out = ''
+	try:
+		out = subprocess.run(cmd, stdout=subprocess.PIPE, stderr=subprocess.STDOUT,
+		                     timeout=args.timeout).stdout.decode(errors='replace')
+		with open(res_file) as f:
+			return json.load(f), None
+	except subprocess.TimeoutExpired:
+		return None, "timeout"
+	except (IOError, ValueError):
+		if 'Wrong data structure type' in out:
+			return None, "unknown data structure"
+		if 'Wrong sync type' in out:
+			return None, "unknown sync type"
+		return None, "no results (crashed?)"
+	finally:
+		os.remove(res_file)
+
+def main():
+	parser = argparse.ArgumentParser(description='Microbenchmark sweep and comparison')
+	parser.add_argument('--bin', default='./x.microbench.ullong')
+	parser.add_argument('--ds', default='bst-unb-ext')
+	parser.add_argument('--sync', default='none')
+	parser.add_argument('--threads', default='1')
+	parser.add_argument('--workloads', default='100_0_0,50_25_25')
+	parser.add_argument('--size', type=int, default=100000)
+	parser.add_argument('--runtime', type=int, default=5)
+	parser.add_argument('--repeat', type=int, default=1)
+	parser.add_argument('--timeout', type=int, default=300)
+	parser.add_argument('--out', default='results.json')
+	parser.add_argument('--baseline', default=None)
+	parser.add_argument('--threshold', type=float, default=5.0,
+	                    help='regression threshold in %% of the baseline throughput')
+	argv = sys.argv[1:]
+	extra = []
+	if '--' in argv:
+		extra = argv[argv.index('--')+1:]
+		argv = argv[:argv.index('--')]
+	args = parser.parse_args(argv)
+
+	if args.baseline and not os.path.exists(args.baseline):
+		sys.exit("baseline file %s does not exist" % args.baseline)
+
+	configs = [dict(ds=ds, sync=sync, threads=int(t), workload=wl, size=args.size)
+	           for ds in args.ds.split(',')
+	           for sync in args.sync.split(',')
+	           for t in args.threads.split(',')
+	           for wl in args.workloads.split(',')]
+
+	results = []
+	for i, c in enumerate(configs):
+		sys.stdout.write("[%d/%d] %s ... " % (i+1, len(configs), config_key(c)))
+		sys.stdout.flush()
+		runs, error = [], None
+		for r in range(args.repeat):
+			res, error = run_one(args, c['ds'], c['sync'], c['threads'],
+			                     c['workload'], extra)
+			if res is None: break
+			runs.append(res)
+		if error:
+			print("skipped: %s" % error)
+			continue
+		entry = dict(c)
+		entry['throughput_mops'] = median([r['throughput_mops'] for r in runs])
+		entry['validation'] = all(r['validation'] for r in runs)
+		entry['runs'] = runs
+		results.append(entry)
+		print("%.3f Mops/sec%s" % (entry['throughput_mops'],
+		                           "" if entry['validation'] else " (VALIDATION FAILED)"))
+
+	with open(args.out, 'w') as f:
+		json.dump(results, f, indent=1)
+	print("\n%d results written to %s" % (len(results), args.out))
+
+	if not args.baseline:
+		return 0
+
+	with open(args.baseline) as f:
+		baseline = dict((config_key(e), e) for e in json.load(f))
+
+	regressions = 0
+	print("\nComparison against %s (threshold %.1f%%)" % (args.baseline, args.threshold))
+	print("%-60s %10s %10s %8s  %s" % ("config", "baseline", "current", "delta", ""))
+	for e in results:
+		key = config_key(e)
+		if key not in baseline:
+			print("%-60s %10s %10.3f %8s  new" % (key, "-", e['throughput_mops'], "-"))
+			continue
+		base = baseline[key]['throughput_mops']
+		delta = 100.0 * (e['throughput_mops'] - base) / base if base > 0 else 0.0
+		status = ""
+		if delta < -args.threshold:
+			status = "REGRESSION"
+			regressions += 1
+		if not e['validation']:
+			status += " VALIDATION FAILED"
+			regressions += 1
+		print("%-60s %10.3f %10.3f %+7.1f%%  %s" % (key, base, e['throughput_mops'],
+		                                            delta, status))
+	print("\n%d regression(s)" % regressions)
+	return 1 if regressions else 0
+
+if __name__ == '__main__':
+	sys.exit(main())
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <cstring>
+#include <cstdlib>
 
 #define CACHE_LINE_SIZE 64
 
@@ -20,9 +21,9 @@ typedef struct {
 	
 	map_t *map;
 
-#	if defined(WORKLOAD_FIXED)
-	int nr_operations;
-#	elif defined(WORKLOAD_TIME)
+	//> Fixed-work mode, the operations this thread performs.
+	unsigned long long nr_operations;
+#	if defined(WORKLOAD_TIME)
 	int *time_to_leave;
 #	endif
 
@@ -31,13 +32,17 @@ typedef struct {
 
 	void *map_tdata;
 
-	char padding[2*CACHE_LINE_SIZE - 3*sizeof(int) - 2*sizeof(void *) -
+	//> Latencies from the intended start of each operation (open-loop mode).
+	latency_hist_t *latency;
+
+	char padding[2*CACHE_LINE_SIZE - 3*sizeof(int) - 3*sizeof(void *) -
 	                               2*OPS_END*sizeof(unsigned long long)];
 } __attribute__((aligned(CACHE_LINE_SIZE))) thread_data_t;
 
 static inline thread_data_t *thread_data_new(int tid, int cpu, map_t *map)
 {
-	thread_data_t *ret = new thread_data_t();
+	// aligned_alloc, since new ignores the cache line alignment before C++17
+	thread_data_t *ret = (thread_data_t *)aligned_alloc(CACHE_LINE_SIZE, sizeof(*ret));
 
 	memset(ret, 0, sizeof(*ret));
 	ret->tid = tid;
@@ -73,9 +78,7 @@ static inline void thread_data_add(thread_data_t *d1, thread_data_t *d2,
 {
 	int i = 0;
 
-#	if defined(WORKLOAD_FIXED)
 	dest->nr_operations = d1->nr_operations + d2->nr_operations;
-#	endif
 
 	for (i=0; i < OPS_END; i++) {
 		dest->operations_performed[i] = d1->operations_performed[i] + 
@@ -0,0 +1,256 @@
+#pragma once
+
+/**
+ * Replay of captured access traces.
+ *
+ * A trace file is a binary file with the following layout (little-endian):
+ *
+ *   trace_header_t                        (32 bytes)
+ *   uint64_t partition_records[nr_partitions]
+ *   records                               (nr_records * record_size bytes)
+ *
+ * Each record is `op` (1 byte, one of TRACE_OP_*) followed by `key` (8 bytes)
+ * and, if record_size is 17, by `value` (8 bytes). For range queries the value
+ * is the length of the range. Without a value, inserts store the key itself
+ * and range queries have a length of TRACE_DEFAULT_RQUERY_LEN. An insert may
+ * not store 0, since the maps take a NULL value for NO_VALUE. With 32-bit keys
+ * (MAP_KEY_TYPE_INT), the keys must fit an int.
+ *
+ * The records of partition i follow those of partition i-1, so a trace
+ * captured from N threads can be replayed with each benchmark thread driving
+ * the accesses of one of them. If the number of partitions does not match the
+ * number of threads, all the records are split evenly among the threads.
+ *
+ * The file is mmapped and prefaulted, and each thread touches its own part of
+ * it before the measurements start, so reading the trace stays off the
+ * measured path. `scripts/mktrace.py` creates such a file from a text trace.
+ **/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <limits.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "Log.h"
+
+#define TRACE_MAGIC "MAPTRACE"
+#define TRACE_VERSION 1
+#define TRACE_DEFAULT_RQUERY_LEN 10000
+
+enum {
+	TRACE_OP_LOOKUP = 0,
+	TRACE_OP_INSERT,
+	TRACE_OP_DELETE,
+	TRACE_OP_RQUERY,
+	TRACE_OP_END
+};
+
+typedef struct {
+	char magic[8];
+	uint32_t version;
+	uint32_t record_size;   //> 9 (op, key) or 17 (op, key, value)
+	uint32_t nr_partitions;
+	uint32_t unused;
+	uint64_t nr_records;
+} trace_header_t;
+
+typedef struct {
+	const char *filename;
+	char *map;
+	size_t map_sz;
+	trace_header_t *header;
+	uint64_t *partition_records;
+	const char *records;
+	unsigned int nr_threads;
+	bool use_partitions; //> Whether thread i replays partition i.
+} trace_t;
+
+//> The part of the trace that is replayed by one thread.
+typedef struct {
+	const char *records;
+	uint64_t nr_records;
+	uint64_t next;
+	uint32_t record_size;
+	uint64_t wraps; //> How many times the whole part has been replayed.
+} trace_cursor_t;
+
+/**
+ * The interface provided
+ **/
+static trace_t *trace_open(const char *filename, unsigned int nr_threads);
+static void trace_cursor_init(trace_t *trace, int tid, trace_cursor_t *cursor);
+static inline void trace_next(trace_cursor_t *cursor, int *op,
+                              uint64_t *key, uint64_t *value);
+static void trace_print(trace_t *trace);
+
+static trace_t *trace_open(const char *filename, unsigned int nr_threads)
+{
+	trace_t *trace = new trace_t();
+	struct stat st;
+	size_t records_off;
+	int fd;
+
+	fd = open(filename, O_RDONLY);
+	if (fd < 0 || fstat(fd, &st) < 0) {
+		log_error("trace: could not open %s\n", filename);
+		exit(1);
+	}
+	if ((size_t)st.st_size < sizeof(trace_header_t)) {
+		log_error("trace: %s is too small to be a trace file\n", filename);
+		exit(1);
+	}
+
+	trace->filename = filename;
+	trace->map_sz = st.st_size;
+	trace->map = (char *)mmap(NULL, trace->map_sz, PROT_READ,
+	                          MAP_PRIVATE | MAP_POPULATE, fd, 0);
+	close(fd);
+	if (trace->map == MAP_FAILED) {
+		log_error("trace: could not mmap %s\n", filename);
+		exit(1);
+	}
+	madvise(trace->map, trace->map_sz, MADV_WILLNEED);
+
+	trace->header = (trace_header_t *)trace->map;
+	if (memcmp(trace->header->magic, TRACE_MAGIC, 8) ||
+	    trace->header->version != TRACE_VERSION) {
+		log_error("trace: %s is not a version %d trace file\n", filename,
+		          TRACE_VERSION);
+		exit(1);
+	}
+	if (trace->header->record_size != 9 && trace->header->record_size != 17) {
+		log_error("trace: wrong record size %u\n", trace->header->record_size);
+		exit(1);
+	}
+
+	records_off = sizeof(trace_header_t) +
+	              trace->header->nr_partitions * sizeof(uint64_t);
+	if (trace->map_sz < records_off ||
+	    (trace->map_sz - records_off) / trace->header->record_size <
+	                                       trace->header->nr_records) {
+		log_error("trace: %s is truncated\n", filename);
+		exit(1);
+	}
+	trace->partition_records = (uint64_t *)(trace->map + sizeof(trace_header_t));
+	trace->records = trace->map + records_off;
+	if (trace->header->nr_records == 0) {
+		log_error("trace: %s contains no records\n", filename);
+		exit(1);
+	}
+
+	trace->nr_threads = nr_threads;
+	trace->use_partitions = (trace->header->nr_partitions == nr_threads);
+	if (trace->use_partitions) {
+		uint64_t sum = 0;
+		for (unsigned int i=0; i < nr_threads; i++) {
+			if (trace->partition_records[i] == 0) {
+				log_error("trace: partition %u is empty\n", i);
+				exit(1);
+			}
+			sum += trace->partition_records[i];
+		}
+		if (sum != trace->header->nr_records) {
+			log_error("trace: partitions do not add up to %llu records\n",
+			          (unsigned long long)trace->header->nr_records);
+			exit(1);
+		}
+	} else {
+		if (trace->header->nr_records < nr_threads) {
+			log_error("trace: fewer records than threads\n");
+			exit(1);
+		}
+		if (trace->header->nr_partitions > 1)
+			log_warning("trace: %u partitions for %u threads, "
+			            "splitting the records evenly\n",
+			            trace->header->nr_partitions, nr_threads);
+	}
+
+	return trace;
+}
+
+static void trace_cursor_init(trace_t *trace, int tid, trace_cursor_t *cursor)
+{
+	uint64_t first = 0, nr;
+
+	if (trace->use_partitions) {
+		for (int i=0; i < tid; i++)
+			first += trace->partition_records[i];
+		nr = trace->partition_records[tid];
+	} else {
+		first = trace->header->nr_records * tid / trace->nr_threads;
+		nr = trace->header->nr_records * (tid + 1) / trace->nr_threads - first;
+	}
+
+	cursor->record_size = trace->header->record_size;
+	cursor->records = trace->records + first * cursor->record_size;
+	cursor->nr_records = nr;
+	cursor->next = 0;
+	cursor->wraps = 0;
+
+	//> Check the records of this part. This also touches all of its pages, so
+	//> that the replay does not fault.
+	for (uint64_t i=0; i < nr; i++) {
+		const char *rec = cursor->records + i * cursor->record_size;
+		unsigned char op = rec[0];
+		uint64_t value;
+		if (op >= TRACE_OP_END) {
+			log_error("trace: wrong op %u in record %llu\n", op,
+			          (unsigned long long)(first + i));
+			exit(1);
+		}
+#		if defined(MAP_KEY_TYPE_INT)
+		//> The keys of this build are 32-bit ints.
+		uint64_t key;
+		memcpy(&key, rec + 1, sizeof(uint64_t));
+		if (key > INT_MAX) {
+			log_error("trace: key %llu does not fit a 32-bit key in record %llu\n",
+			          (unsigned long long)key, (unsigned long long)(first + i));
+			exit(1);
+		}
+#		endif
+		//> The value of an insert is the key when the record has no value.
+		memcpy(&value, rec + (cursor->record_size == 17 ? 9 : 1), sizeof(uint64_t));
+		if (op == TRACE_OP_INSERT && value == 0) {
+			log_error("trace: insert of value 0 in record %llu\n",
+			          (unsigned long long)(first + i));
+			exit(1);
+		}
+	}
+}
+
+//> Returns the next access of the cursor's part, starting over when the whole
+//> part has been replayed.
+static inline void trace_next(trace_cursor_t *cursor, int *op,
+                              uint64_t *key, uint64_t *value)
+{
+	const char *rec = cursor->records + cursor->next * cursor->record_size;
+
+	*op = (unsigned char)rec[0];
+	memcpy(key, rec + 1, sizeof(uint64_t));
+	if (cursor->record_size == 17)   memcpy(value, rec + 9, sizeof(uint64_t));
+	else if (*op == TRACE_OP_RQUERY) *value = TRACE_DEFAULT_RQUERY_LEN;
+	else                             *value = *key;
+
+	if (++cursor->next == cursor->nr_records) {
+		cursor->next = 0;
+		cursor->wraps++;
+	}
+}
+
+static void trace_print(trace_t *trace)
+{
+	log_info("Trace\n");
+	log_info("=======================\n");
+	log_info("  File: %s (%.2lf MB)\n", trace->filename,
+	         trace->map_sz / 1024.0 / 1024.0);
+	log_info("  Records: %llu (%s values)\n",
+	         (unsigned long long)trace->header->nr_records,
+	         trace->header->record_size == 17 ? "with" : "without");
+	log_info("  Partitions: %u (%s)\n", trace->header->nr_partitions,
+	         trace->use_partitions ? "one per thread" : "split evenly");
+}
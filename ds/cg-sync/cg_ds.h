@@ -46,50 +46,50 @@ public:
 	bool contains(const int tid, const K& key)
 	{
 		bool ret;
-		sync_mechanism->cs_enter_ro();
+		sync_mechanism->cs_enter_ro(tid);
 		ret = protected_data_structure->contains(tid, key);
-		sync_mechanism->cs_exit();
+		sync_mechanism->cs_exit(tid);
 		return ret;
 	}
 
 	const std::pair<V,bool> find(const int tid, const K& key)
 	{
-		sync_mechanism->cs_enter_ro();
+		sync_mechanism->cs_enter_ro(tid);
 		std::pair<V, bool> ret = protected_data_structure->find(tid, key);
-		sync_mechanism->cs_exit();
+		sync_mechanism->cs_exit(tid);
 		return ret;
 	}
 
 	int rangeQuery(const int tid, const K& lo, const K& hi,
-	               std::vector<std::pair<K,V>> kv_pairs)
+	               std::vector<std::pair<K,V>>& kv_pairs)
 	{
-		sync_mechanism->cs_enter_ro();
+		sync_mechanism->cs_enter_ro(tid);
 		int ret = protected_data_structure->rangeQuery(tid, lo, hi, kv_pairs);
-		sync_mechanism->cs_exit();
+		sync_mechanism->cs_exit(tid);
 		return ret;
 	}
 
 	const V insert(const int tid, const K& key, const V& val)
 	{
-		sync_mechanism->cs_enter_rw();
+		sync_mechanism->cs_enter_rw(tid);
 		const V ret = protected_data_structure->insert(tid, key, val);
-		sync_mechanism->cs_exit();
+		sync_mechanism->cs_exit(tid);
 		return ret;
 	}
 
 	const V insertIfAbsent(const int tid, const K& key, const V& val)
 	{
-		sync_mechanism->cs_enter_rw();
+		sync_mechanism->cs_enter_rw(tid);
 		const V ret = protected_data_structure->insertIfAbsent(tid, key, val);
-		sync_mechanism->cs_exit();
+		sync_mechanism->cs_exit(tid);
 		return ret;
 	}
 
 	const std::pair<V,bool> remove(const int tid, const K& key)
 	{
-		sync_mechanism->cs_enter_rw();
+		sync_mechanism->cs_enter_rw(tid);
 		std::pair<V, bool> ret = protected_data_structure->remove(tid, key);
-		sync_mechanism->cs_exit();
+		sync_mechanism->cs_exit(tid);
 		return ret;
 	}
 
@@ -98,6 +98,27 @@ public:
 		return protected_data_structure->validate();
 	}
 
+	unsigned long long size()
+	{
+		return protected_data_structure->size();
+	}
+
+	void memoryStats(MemoryStats *stats)
+	{
+		protected_data_structure->memoryStats(stats);
+	}
+
+	void stats(MapStats *stats)
+	{
+		sync_mechanism->stats(stats);
+		protected_data_structure->stats(stats);
+	}
+
+	bool bulkLoad(const int tid, const std::vector<std::pair<K,V>>& kv_pairs)
+	{
+		return protected_data_structure->bulkLoad(tid, kv_pairs);
+	}
+
 	char *name()
 	{
 		char *baseds = protected_data_structure->name();
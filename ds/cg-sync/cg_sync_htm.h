@@ -13,8 +13,10 @@ public:
 		pthread_spin_init(&fallback_lock, PTHREAD_PROCESS_SHARED);
 	}
 
-	void cs_enter_rw() { tx_start(); }
-	void cs_exit() { tx_end(); }
+	void cs_enter_rw(const int tid) { tx_start(tid); }
+	void cs_exit(const int tid) { tx_end(tid); }
+
+	void stats(MapStats *stats) { counters.add_to(stats); }
 
 	char *name() { return (char *)"CG-HTM"; }
 
@@ -22,12 +24,13 @@ private:
 
 	pthread_spinlock_t fallback_lock;
 	const int num_retries = 10;
+	MapCounters counters;
 
-	inline void tx_start();
-	inline void tx_end();
+	inline void tx_start(const int tid);
+	inline void tx_end(const int tid);
 };
 
-inline void cg_sync_htm::tx_start()
+inline void cg_sync_htm::tx_start(const int tid)
 {
 	int status = 0;
 	int aborts = num_retries;
@@ -39,6 +42,7 @@ inline void cg_sync_htm::tx_start()
 			;
 
 //		tdata->tx_starts++;
+		counters.inc(tid, MAP_STAT_TX_STARTS);
 
 		status = _xbegin();
 		if (_XBEGIN_STARTED == (unsigned)status) {
@@ -49,6 +53,7 @@ inline void cg_sync_htm::tx_start()
 
 		/* Abort comes here. */
 //		tdata->tx_aborts++;
+		counters.inc(tid, MAP_STAT_TX_ABORTS);
 
 //		if (status & _XABORT_CAPACITY) {
 //			tdata->tx_aborts_per_reason[TX_ABORT_CAPACITY]++;
@@ -61,6 +66,7 @@ inline void cg_sync_htm::tx_start()
 //		}
 
 		if (--aborts <= 0) {
+			counters.inc(tid, MAP_STAT_FALLBACKS);
 			pthread_spin_lock(&fallback_lock);
 			return;
 		}
@@ -70,7 +76,7 @@ inline void cg_sync_htm::tx_start()
 	return;
 }
 
-inline void cg_sync_htm::tx_end()
+inline void cg_sync_htm::tx_end(const int tid)
 {
 //	tx_thread_data_t *tdata = thread_data;
 
@@ -1,11 +1,16 @@
 #pragma once
 
+#include "MapStats.h"
+
 class cg_sync {
 public:
 	
-	virtual void cs_enter_rw() = 0;
-	virtual void cs_enter_ro() { cs_enter_rw(); };
-	virtual void cs_exit() = 0;
+	virtual void cs_enter_rw(const int tid) = 0;
+	virtual void cs_enter_ro(const int tid) { cs_enter_rw(tid); };
+	virtual void cs_exit(const int tid) = 0;
+
+	//> Adds the internal events of the mechanism (e.g., aborts) to `stats`.
+	virtual void stats(MapStats *stats) {};
 
 	virtual char *name() = 0;
 };
@@ -12,8 +12,8 @@ public:
 		pthread_spin_init(&lock, PTHREAD_PROCESS_SHARED);
 	}
 
-	void cs_enter_rw() { pthread_spin_lock(&lock); }
-	void cs_exit() { pthread_spin_unlock(&lock); }
+	void cs_enter_rw(const int tid) { pthread_spin_lock(&lock); }
+	void cs_exit(const int tid) { pthread_spin_unlock(&lock); }
 
 	char *name() { return (char *)"CG-SPINLOCK"; }
 
@@ -30,9 +30,9 @@ public:
 		pthread_rwlock_init(&lock, NULL);
 	}
 
-	void cs_enter_rw() { pthread_rwlock_wrlock(&lock); }
-	void cs_enter_ro() { pthread_rwlock_rdlock(&lock); }
-	void cs_exit() { pthread_rwlock_unlock(&lock); }
+	void cs_enter_rw(const int tid) { pthread_rwlock_wrlock(&lock); }
+	void cs_enter_ro(const int tid) { pthread_rwlock_rdlock(&lock); }
+	void cs_exit(const int tid) { pthread_rwlock_unlock(&lock); }
 
 	char *name() { return (char *)"CG-RWLOCK"; }
 
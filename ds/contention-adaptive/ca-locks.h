@@ -40,6 +40,8 @@ private:
 	//> This is a route CA node.
 	class caRouteNode : public caNode {
 	public:
+		NODE_ALLOCATOR_OPERATORS
+
 		K key;
 		caNode *left, *right;
 		pthread_spinlock_t lock_;
@@ -59,6 +61,8 @@ private:
 	//> This is the base CA node, which points to a sequential data structure.
 	class caBaseNode : public caNode {
 	public:
+		NODE_ALLOCATOR_OPERATORS
+
 		Map<K,V> *root; //> this points to the sequential data structure
 		long long int lock_statistics;
 		pthread_spinlock_t lock_;
@@ -110,6 +114,7 @@ private:
 		}
 	} tdata_t;
 	tdata_t *tdata_array[88];
+	MapCounters counters;
 
 private:
 	node_t *root;
@@ -180,13 +185,13 @@ private:
 		return (base_node_t *)node;
 	}
 
-	//> Called with bnode locked
-	void split(base_node_t *bnode, route_node_t *parent)
+	//> Called with bnode locked. Returns whether bnode was split.
+	bool split(base_node_t *bnode, route_node_t *parent)
 	{
 		base_node_t *left_bnode, *right_bnode;
 		route_node_t *new_rnode;
 	
-		if (bnode->root->size() < 10) return;
+		if (bnode->root->size() < 10) return false;
 	
 		left_bnode = new base_node_t(-1, NULL);
 		right_bnode = new base_node_t(-1, NULL);
@@ -205,10 +210,11 @@ private:
 		} else {
 			root = new_rnode;
 		}
+		return true;
 	}
 
-	//> Called with bnode locked
-	void join(base_node_t *bnode, route_node_t *parent, route_node_t *gparent)
+	//> Called with bnode locked. Returns whether bnode was joined with its neighbour.
+	bool join(base_node_t *bnode, route_node_t *parent, route_node_t *gparent)
 	{
 		base_node_t *new_bnode;
 		base_node_t *lmost_base, *rmost_base;
@@ -216,7 +222,7 @@ private:
 		route_node_t *rmparent, *rmgparent; //> Right-most's parent and grandparent
 		node_t *sibling;
 	
-		if (parent == NULL) return;
+		if (parent == NULL) return false;
 	
 		new_bnode = new base_node_t(-1, NULL);
 	
@@ -230,10 +236,10 @@ private:
 	
 			//> Try to lock lmost_base and check if valid
 			if (lmost_base->trylock() != 0) {
-				return;
+				return false;
 			} else if (lmost_base->is_valid() == 0) {
 				lmost_base->unlock();
-				return;
+				return false;
 			}
 	
 			//> Unlink bnode
@@ -252,6 +258,7 @@ private:
 				lmparent->right = (node_t *)new_bnode;
 			lmost_base->is_valid_ = 0;
 			lmost_base->unlock();
+			return true;
 		} else if (parent->right == (node_t *)bnode) {
 			sibling = parent->left;
 	
@@ -262,10 +269,10 @@ private:
 	
 			//> Try to lock rmost_base and check if valid
 			if (rmost_base->trylock() != 0) {
-				return;
+				return false;
 			} else if (rmost_base->is_valid() == 0) {
 				rmost_base->unlock();
-				return;
+				return false;
 			}
 	
 			//> Unlink bnode
@@ -284,7 +291,9 @@ private:
 				rmparent->right = (node_t *)new_bnode;
 			rmost_base->is_valid_ = 0;
 			rmost_base->unlock();
+			return true;
 		}
+		return false;
 	}
 
 	//> Called with bnode locked
@@ -292,11 +301,11 @@ private:
 	                     route_node_t *gparent, tdata_t *tdata)
 	{
 		if (bnode->lock_statistics > STAT_LOCK_HIGH_CONTENTION_LIMIT) {
-			split(bnode, parent);
+			if (split(bnode, parent)) counters.inc(tdata->tid, MAP_STAT_SPLITS);
 			bnode->lock_statistics = 0;
 //			tdata->splits++;
 		} else if (bnode->lock_statistics < STAT_LOCK_LOW_CONTENTION_LIMIT) {
-			join(bnode, parent, gparent);
+			if (join(bnode, parent, gparent)) counters.inc(tdata->tid, MAP_STAT_JOINS);
 			bnode->lock_statistics = 0;
 //			tdata->joins++;
 		}
@@ -323,6 +332,20 @@ private:
 		}
 	}
 
+	void memory_stats_rec(node_t *n, MemoryStats *stats)
+	{
+		if (n->is_route()) {
+			route_node_t *rnode = (route_node_t *)n;
+			stats->add_nodes("ca-route", sizeof(route_node_t), 1);
+			memory_stats_rec(rnode->left, stats);
+			memory_stats_rec(rnode->right, stats);
+		} else {
+			base_node_t *bnode = (base_node_t *)n;
+			stats->add_nodes("ca-base", sizeof(base_node_t), 1);
+			bnode->root->memoryStats(stats);
+		}
+	}
+
 	int bst_violations;
 	int total_nodes, route_nodes, base_nodes, invalid_nodes;
 	int total_keys, base_keys;
@@ -368,6 +391,16 @@ public:
 		print_helper_rec(root, 0);
 	}
 
+	void memoryStats(MemoryStats *stats)
+	{
+		if (root) memory_stats_rec(root, stats);
+	}
+
+	void stats(MapStats *stats)
+	{
+		counters.add_to(stats);
+	}
+
 	bool do_contains(const int tid, const K& key, tdata_t *tdata)
 	{
 		int ret = 0;
@@ -471,8 +504,8 @@ public:
 		return -1;
 	}
 
-	bool do_rangeQuery(const int tid, const K& low, const K& hi,
-	                   std::vector<std::pair<K,V>> kv_pairs, tdata_t *tdata)
+	int do_rangeQuery(const int tid, const K& low, const K& hi,
+	                   std::vector<std::pair<K,V>>& kv_pairs, tdata_t *tdata)
 	{
 		int nbase_nodes;
 		int nkeys = 0;
@@ -481,9 +514,12 @@ public:
 			nbase_nodes = rquery_get_base_nodes(low, hi, tdata);
 		} while (nbase_nodes == -1);
 
-		//> Get appropriate keys from each base node and unlock it
+		//> Get appropriate keys from each base node and unlock it.
+		//> -1 if the sequential data structure does not support range queries.
 		for (int i=0; i < nbase_nodes; i++) {
-			nkeys += tdata->rquery_bnodes[i]->root->rangeQuery(tid, low, hi, kv_pairs);
+			int ret = tdata->rquery_bnodes[i]->root->rangeQuery(tid, low, hi, kv_pairs);
+			if (ret < 0) nkeys = -1;
+			else if (nkeys >= 0) nkeys += ret;
 			tdata->rquery_bnodes[i]->unlock();
 		}
 
@@ -638,7 +674,7 @@ public:
 	}
 
 	int rangeQuery(const int tid, const K& low, const K& hi,
-	                     std::vector<std::pair<K,V>> kv_pairs)
+	                     std::vector<std::pair<K,V>>& kv_pairs)
 	{
 		tdata_t *tdata = tdata_array[tid];
 		return do_rangeQuery(tid, low, hi, kv_pairs, tdata);
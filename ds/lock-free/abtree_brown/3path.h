@@ -12,6 +12,9 @@
 
 using namespace std;
 
+// bst_brown defines its own versions of these
+#undef ABORT_STATE_INIT
+#undef STATE_GET_HIGHEST_INDEX_REACHED
 /* 2-bit state | 5-bit highest index reached | 24-bit frozen flags for each element of nodes[] on which a freezing CAS was performed = total 31 bits (highest bit unused) */
 #define ABORT_STATE_INIT(i, flags) (abtree_SCXRecord<DEGREE,K>::STATE_ABORTED | ((i)<<2) | ((flags)<<7))
 #define STATE_GET_FLAGS(state) ((state) & 0x7FFFFF80)
@@ -162,6 +165,8 @@ struct abtree_SCXRecord {
 
 template <int DEGREE, typename K>
 struct abtree_Node {
+    NODE_ALLOCATOR_OPERATORS
+
     abtree_SCXRecord<DEGREE,K> * volatile scxRecord;
     volatile int leaf;
     volatile int marked;
@@ -270,7 +275,7 @@ public:
 	const std::pair<V,bool> find(const int tid, const K& key);
 	int                     rangeQuery(const int tid,
 	                                   const K& lo, const K& hi,
-	                                   std::vector<std::pair<K,V>> kv_pairs);
+	                                   std::vector<std::pair<K,V>>& kv_pairs);
 
 	const V                 insert(const int tid, const K& key, const V& val);
 	const V                 insertIfAbsent(const int tid, const K& key,
@@ -442,8 +447,7 @@ private:
 	    kvpair<K,V> tosort[DEGREE+1];
 	
 	    int attempts = MAX_FAST_HTM_RETRIES;
-	TXN1: (0);
-	    int status = _xbegin();
+	    unsigned status = _xbegin();
 	    if (status == _XBEGIN_STARTED) {
 	        if (numFallback > 0) 
 				_xabort(ABORT_PROCESS_ON_FALLBACK);
@@ -538,7 +542,6 @@ private:
 	            }
 	        }
 	    } else {
-	aborthere:
 	        if (info) info->lastAbort = status;
 	//        IF_ALWAYS_RETRY_WHEN_BIT_SET if (status & _XABORT_RETRY) { this->counters->pathFail[info->path]->inc(tid); this->counters->htmRetryAbortRetried[info->path]->inc(tid); goto TXN1; }
 	        return false;
@@ -547,8 +550,8 @@ private:
 
 	bool insert_middle(wrapper_info<DEGREE,K> * const info, const int tid, const K& key, const V& val, const bool onlyIfAbsent, bool * const shouldRebalance, V * const result)
 	{
-	tXN1: int attempts = MAX_FAST_HTM_RETRIES;
-	    int status = _xbegin();
+	int attempts = MAX_FAST_HTM_RETRIES;
+	    unsigned status = _xbegin();
 	    if (status == _XBEGIN_STARTED) {
 	        abtree_Node<DEGREE,K> * p = root;
 	        abtree_Node<DEGREE,K> * l = (abtree_Node<DEGREE,K> *) root->ptrs[0];
@@ -703,7 +706,6 @@ private:
 	//        reclaimMemoryAfterSCX(tid, info, true);
 			return retval;
 	    } else {
-	aborthere:
 	        if (info) info->lastAbort = status;
 	//        IF_ALWAYS_RETRY_WHEN_BIT_SET if (status & _XABORT_RETRY) { this->counters->pathFail[info->path]->inc(tid); this->counters->htmRetryAbortRetried[info->path]->inc(tid); goto TXN1; }
 	        return false;
@@ -874,8 +876,7 @@ private:
 	    kvpair<K,V> tosort[DEGREE+1];
 	
 	    int attempts = MAX_FAST_HTM_RETRIES;
-	TXN1: (0);
-	    int status = _xbegin();
+	    unsigned status = _xbegin();
 	    if (status == _XBEGIN_STARTED) {
 	        if (numFallback > 0) 
 				_xabort(ABORT_PROCESS_ON_FALLBACK);
@@ -907,7 +908,6 @@ private:
             _xend();
 			return true;
 	    } else {
-	aborthere:
 	        if (info) info->lastAbort = status;
 	//        IF_ALWAYS_RETRY_WHEN_BIT_SET if (status & _XABORT_RETRY) { this->counters->pathFail[info->path]->inc(tid); this->counters->htmRetryAbortRetried[info->path]->inc(tid); goto TXN1; }
 	        return false;
@@ -917,8 +917,8 @@ private:
 	bool erase_middle(wrapper_info<DEGREE,K> * const info, const int tid,
 	                  const K& key, V& val, bool * const shouldRebalance)
 	{
-	TXN1: int attempts = MAX_FAST_HTM_RETRIES;
-	    int status = _xbegin();
+	int attempts = MAX_FAST_HTM_RETRIES;
+	    unsigned status = _xbegin();
 	    if (status == _XBEGIN_STARTED) {
 	        abtree_Node<DEGREE,K> * p = root;
 	        abtree_Node<DEGREE,K> * l = (abtree_Node<DEGREE,K> *) root->ptrs[0];
@@ -986,7 +986,6 @@ private:
 				return true;
 	        }
 	    } else {
-	aborthere:
 	        if (info) info->lastAbort = status;
 	//        IF_ALWAYS_RETRY_WHEN_BIT_SET if (status & _XABORT_RETRY) { this->counters->pathFail[info->path]->inc(tid); this->counters->htmRetryAbortRetried[info->path]->inc(tid); goto TXN1; }
 	        return false;
@@ -1074,8 +1073,8 @@ private:
 //	        x[rem+7] = 0; // force page to load
 //	    }
 	    
-	TXN1: int attempts = MAX_FAST_HTM_RETRIES;
-	    int status = _xbegin();
+	int attempts = MAX_FAST_HTM_RETRIES;
+	    unsigned status = _xbegin();
 	    if (status == _XBEGIN_STARTED) {
 	        if (numFallback > 0) { _xabort(ABORT_PROCESS_ON_FALLBACK); }
 	        abtree_Node<DEGREE,K> * gp = root;
@@ -1155,7 +1154,6 @@ private:
 	        cout<<"IMPOSSIBLE"<<endl;
 	        exit(-1);
 	    } else {
-	aborthere:
 	        if (info) info->lastAbort = status;
 	//        IF_ALWAYS_RETRY_WHEN_BIT_SET if (status & _XABORT_RETRY) { this->counters->pathFail[info->path]->inc(tid); this->counters->htmRetryAbortRetried[info->path]->inc(tid); goto TXN1; }
 	        return false;
@@ -1173,8 +1171,8 @@ private:
 //	        x[rem+7] = 0; // force page to load
 //	    }
 	    
-	TXN1: int attempts = MAX_FAST_HTM_RETRIES;
-	    int status = _xbegin();
+	int attempts = MAX_FAST_HTM_RETRIES;
+	    unsigned status = _xbegin();
 	    if (status == _XBEGIN_STARTED) {
 	        if (numFallback > 0) { _xabort(ABORT_PROCESS_ON_FALLBACK); }
 	
@@ -1256,7 +1254,6 @@ private:
 	            return false; // continue fixing violations
 	        }
 	    } else {
-	aborthere:
 	//        IF_ALWAYS_RETRY_WHEN_BIT_SET if (status & _XABORT_RETRY) { this->counters->pathFail[info->path]->inc(tid); this->counters->htmRetryAbortRetried[info->path]->inc(tid); goto TXN1; }
 	        if (info) info->lastAbort = status;
 	        return false;
@@ -2508,9 +2505,9 @@ const std::pair<V,bool> ABTREE_BROWN_3PATH_FUNCT::find(const int tid, const K& k
 
 ABTREE_BROWN_3PATH_TEMPL
 int ABTREE_BROWN_3PATH_FUNCT::rangeQuery(const int tid, const K& lo, const K& hi,
-                      std::vector<std::pair<K,V>> kv_pairs)
+                      std::vector<std::pair<K,V>>& kv_pairs)
 {
-	return 0;
+	return -1;
 }
 
 ABTREE_BROWN_3PATH_TEMPL
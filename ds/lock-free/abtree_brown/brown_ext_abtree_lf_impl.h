@@ -79,7 +79,7 @@ public:
 	const std::pair<V,bool> find(const int tid, const K& key);
 	int                     rangeQuery(const int tid,
 	                                   const K& lo, const K& hi,
-	                                   std::vector<std::pair<K,V>> kv_pairs);
+	                                   std::vector<std::pair<K,V>>& kv_pairs);
 
 	const V                 insert(const int tid, const K& key, const V& val);
 	const V                 insertIfAbsent(const int tid, const K& key,
@@ -100,6 +100,8 @@ private:
 	SCXProvider<Node, MAX_NODE_DEPENDENCIES_PER_SCX> * const prov;
 
     struct Node {
+        NODE_ALLOCATOR_OPERATORS
+
         scx_handle_t volatile scxPtr;
         bool leaf;
         volatile bool marked;
@@ -1022,9 +1024,9 @@ const std::pair<V,bool> ABTREE_BROWN_FUNCT::find(const int tid, const K& key)
 
 ABTREE_BROWN_TEMPL
 int ABTREE_BROWN_FUNCT::rangeQuery(const int tid, const K& lo, const K& hi,
-                      std::vector<std::pair<K,V>> kv_pairs)
+                      std::vector<std::pair<K,V>>& kv_pairs)
 {
-	return 0;
+	return -1;
 }
 
 ABTREE_BROWN_TEMPL
@@ -33,6 +33,7 @@
 #include "../ist_brown/plaf.h"
 #include "../ist_brown/descriptors.h"
 #include <cstring>
+#include <cstdlib>
 
 // NodeT must contain fields:
 //   volatile size_t marked                                                     --- note: any primitive type will do, as long as it is word aligned, and is the only data stored in its word
@@ -86,6 +87,11 @@ PAD;
 
 public:
 
+    // the descriptor arrays are cache line aligned, which new does not
+    // honor before C++17
+    static void *operator new(size_t size) { return aligned_alloc(64, size); }
+    static void operator delete(void *p) { free(p); }
+
     static const scx_handle_t FINALIZED = ((scx_handle_t) TAGPTR1_DUMMY_DESC(1));
     static const scx_handle_t FAILED = ((scx_handle_t) TAGPTR1_DUMMY_DESC(2));
         
@@ -154,7 +160,7 @@ public:
         SCXRecord * dummy = TAGPTR1_UNPACK_PTR(INIT_SCX_HANDLE);
         dummy->c.mutables = MUTABLES1_INIT_DUMMY;
         for (int i=0;i<numThreads;++i) {
-            DESC1_NEW(i); // add a DESC1_NEW call at the start for each thread, since we only perform DESC1_NEW AFTER an scx
+            (void) DESC1_NEW(i); // add a DESC1_NEW call at the start for each thread, since we only perform DESC1_NEW AFTER an scx
         }
         //std::cout<<"address of dummy: "<<((uintptr_t) dummy)<<" address of dummy->c.mutables: "<<((uintptr_t) &dummy->c.mutables)<<" address of dummy->c.{end}: "<<((uintptr_t) &dummy->c.scxPtrsSeen[MaxNodeDependenciesPerSCX])<<" size="<<dummy->size<<std::endl;
     }
@@ -217,7 +223,7 @@ public:
         auto tagptr = TAGPTR1_NEW(tid, scxptr->c.mutables);
         assert((UNPACK1_SEQ(tagptr) & 0x1));
         auto result = help(tid, tagptr, scxptr, false);
-        DESC1_NEW(tid);
+        (void) DESC1_NEW(tid);
         assert(!(UNPACK1_SEQ(scxptr->c.mutables) & 0x1));
         return (result == SCXRecord::STATE_COMMITTED);
     }
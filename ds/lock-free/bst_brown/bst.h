@@ -51,6 +51,9 @@ using namespace std;
 */
 #define LLX_RETURN_IS_LEAF ((void*) 1)
 
+// abtree_brown defines its own versions of these
+#undef ABORT_STATE_INIT
+#undef STATE_GET_HIGHEST_INDEX_REACHED
 #define ABORT_STATE_INIT(i, freezeCount) (SCXRecord<K,V>::STATE_ABORTED | ((i)<<2) | ((freezeCount)<<16))
 #define STATE_GET_HIGHEST_INDEX_REACHED(state) (((state) & ((1<<16)-1))>>2)
 #define STATE_GET_REFCOUNT(state) ((state)>>16)
@@ -86,6 +89,8 @@ template <class K, class V> class SCXRecord;
 template <class K, class V>
 class Node {
 public:
+    NODE_ALLOCATOR_OPERATORS
+
     V value;
     K key;
     SCXRecord<K,V> * volatile scxRecord;
@@ -236,6 +241,7 @@ private:
     atomic_uint numFallback; // number of processes on the fallback path
 
 	#define MAX_TID_POW2 128
+	#undef PREFETCH_SIZE_WORDS
 	#define PREFETCH_SIZE_WORDS 24
     #define VERSION_NUMBER(tid) (version[(tid)*PREFETCH_SIZE_WORDS])
     #define INIT_VERSION_NUMBER(tid) (VERSION_NUMBER(tid) = ((tid << 1) | 1))
@@ -243,6 +249,8 @@ private:
     #define IS_VERSION_NUMBER(infoPtr) (((long) (infoPtr)) & 1)
     long version[MAX_TID_POW2*PREFETCH_SIZE_WORDS];
 
+	MapCounters counters;
+
 public:
     bst_brown(const K& _NO_KEY, const V& _NO_VALUE, const int numProcesses,
 	          const int fast_htm_retries = 10, const int slow_htm_retries = 10)
@@ -274,7 +282,7 @@ public:
 	const std::pair<V,bool> find(const int tid, const K& key);
 	int                     rangeQuery(const int tid,
 	                                   const K& lo, const K& hi,
-	                                   std::vector<std::pair<K,V>> kv_pairs);
+	                                   std::vector<std::pair<K,V>>& kv_pairs);
 
 	const V                 insert(const int tid, const K& key, const V& val);
 	const V                 insertIfAbsent(const int tid, const K& key,
@@ -292,6 +300,8 @@ public:
 	void print() {};
 //	unsigned long long size() { return size_rec(root) - 2; };
 
+	void stats(MapStats *stats) { counters.add_to(stats); }
+
 private:
 
 	void htmWrapper(UPDATE_FUNCTION(update_for_fastHTM),
@@ -310,10 +320,12 @@ private:
 	    for (;;) {
 	        switch (info.path) {
 	            case PATH_FAST_HTM:
+	                counters.inc(tid, MAP_STAT_TX_STARTS);
 	                finished = (this->*update_for_fastHTM)(&info, tid, input, output);
 	                if (finished) {
 	                    return;
 	                } else {
+	                    counters.inc(tid, MAP_STAT_TX_ABORTS);
 	                    // check if we should change paths
 	                    ++attempts;
 	                    // TODO: move to middle immediately if a process is on the fallback path
@@ -322,6 +334,7 @@ private:
 	                        // check if we aren't allowing slow htm path
 	                        if (MAX_SLOW_HTM_RETRIES < 0) {
 	                            info.path = PATH_FALLBACK;
+	                            counters.inc(tid, MAP_STAT_FALLBACKS);
 	                            numFallback.fetch_add(1);
 	                        } else {
 	                            info.path = PATH_SLOW_HTM;
@@ -338,15 +351,18 @@ private:
 	                }
 	                break;
 	            case PATH_SLOW_HTM:
+	                counters.inc(tid, MAP_STAT_TX_STARTS);
 	                finished = (this->*update_for_slowHTM)(&info, tid, input, output);
 	                if (finished) {
 	                    return;
 	                } else {
+	                    counters.inc(tid, MAP_STAT_TX_ABORTS);
 	                    // check if we should change paths
 	                    ++attempts;
 	                    if (attempts > MAX_SLOW_HTM_RETRIES) {
 	                        attempts = 0;
 	                        info.path = PATH_FALLBACK;
+	                        counters.inc(tid, MAP_STAT_FALLBACKS);
 	                        if (MAX_FAST_HTM_RETRIES >= 0 || MAX_SLOW_HTM_RETRIES >= 0) numFallback.fetch_add(1);
 	                    }
 	                }
@@ -357,6 +373,7 @@ private:
 	                    if (MAX_FAST_HTM_RETRIES >= 0 || MAX_SLOW_HTM_RETRIES >= 0) numFallback.fetch_add(-1);
 	                    return;
 	                } else {
+	                    counters.inc(tid, MAP_STAT_RESTARTS);
 	                }
 	                break;
 	            default:
@@ -462,8 +479,8 @@ private:
 		Node<K,V> *newNode0 = allocateNode(tid);
 		Node<K,V> *newNode1 = allocateNode(tid);
 	    initializeNode(tid, newNode0, key, val, NULL, NULL);
-	TXN1: int attempts = MAX_FAST_HTM_RETRIES;
-	    int status = _xbegin();
+	int attempts = MAX_FAST_HTM_RETRIES;
+	    unsigned status = _xbegin();
 	    if (status == _XBEGIN_STARTED) {
 	        if (info->path == PATH_FAST_HTM && numFallback.load(memory_order_relaxed) > 0) _xabort(ABORT_PROCESS_ON_FALLBACK);
 	        Node<K,V> *p = root, *l;
@@ -509,7 +526,6 @@ private:
 	            return true;
 	        }
 	    } else {
-	aborthere:
 	        info->lastAbort = status;
 //	        IF_ALWAYS_RETRY_WHEN_BIT_SET if (status & _XABORT_RETRY) { this->counters->pathFail[info->path]->inc(tid); this->counters->htmRetryAbortRetried[info->path]->inc(tid); goto TXN1; }
 	        return false;
@@ -527,8 +543,8 @@ private:
 		Node<K,V> *newNode0 = allocateNode(tid);
 		Node<K,V> *newNode1 = allocateNode(tid);
 	    SCXRecord<K,V>* scx = (SCXRecord<K,V>*) NEXT_VERSION_NUMBER(tid);
-	TXN1: int attempts = MAX_FAST_HTM_RETRIES;
-	    int status = _xbegin();
+	int attempts = MAX_FAST_HTM_RETRIES;
+	    unsigned status = _xbegin();
 	    if (status == _XBEGIN_STARTED) {
 	        if (info->path == PATH_FAST_HTM && numFallback.load(memory_order_relaxed) > 0) _xabort(ABORT_PROCESS_ON_FALLBACK);
 	        Node<K,V> *p = root, *l;
@@ -549,7 +565,7 @@ private:
 	                *result = val; // for insertIfAbsent, we don't care about the particular value, just whether we inserted or not. so, we use val to signify not having inserted (and NO_VALUE to signify having inserted).
 	                return true; // success
 	            }
-	            Node<K,V> *pleft, *pright;
+	            Node<K,V> *pleft = NULL, *pright = NULL;
 	            if ((info->llxResults[0] = llx_intxn_markingwr_infowr(tid, p, &pleft, &pright)) == NULL)
 	                _xabort(ABORT_NODE_POINTER_CHANGED);
 
@@ -568,7 +584,7 @@ private:
 	            
 	            return true;
 	        } else {
-	            Node<K,V> *pleft, *pright;
+	            Node<K,V> *pleft = NULL, *pright = NULL;
 	            if ((info->llxResults[0] = llx_intxn_markingwr_infowr(tid, p, &pleft, &pright)) == NULL)
 	                _xabort(ABORT_NODE_POINTER_CHANGED);
 	            // assert l is a child of p
@@ -590,7 +606,6 @@ private:
 	            return true;
 	        }
 	    } else {
-	aborthere:
 	        info->lastAbort = status;
 //	        IF_ALWAYS_RETRY_WHEN_BIT_SET if (status & _XABORT_RETRY) { this->counters->pathFail[info->path]->inc(tid); this->counters->htmRetryAbortRetried[info->path]->inc(tid); goto TXN1; }
 	        return false;
@@ -626,7 +641,7 @@ private:
 	            *result = l->value;
 	            return true;
 	        }
-	        Node<K,V> *pleft, *pright;
+	        Node<K,V> *pleft = NULL, *pright = NULL;
 	        if ((info->llxResults[0] = llx(tid, p, &pleft, &pright)) == NULL)
 	            return false;
 	        if (l != pleft && l != pright)
@@ -643,7 +658,7 @@ private:
 	        info->nodes[1] = l;
 	        return scx(tid, info, (l == pleft ? &p->left : &p->right), newNode0);
 	    } else {
-	        Node<K,V> *pleft, *pright;
+	        Node<K,V> *pleft = NULL, *pright = NULL;
 	        if ((info->llxResults[0] = llx(tid, p, &pleft, &pright)) == NULL)
 	            return false;
 	        if (l != pleft && l != pright)
@@ -734,8 +749,8 @@ private:
 	    const K& key = *((const K*) input[0]);
 	    V *result = (V*) output[0];
 	
-	TXN1: int attempts = MAX_FAST_HTM_RETRIES;
-	    int status = _xbegin();
+	int attempts = MAX_FAST_HTM_RETRIES;
+	    unsigned status = _xbegin();
 	    if (status == _XBEGIN_STARTED) {
 	        if (info->path == PATH_FAST_HTM && numFallback.load(memory_order_relaxed) > 0) _xabort(ABORT_PROCESS_ON_FALLBACK);
 	        Node<K,V> *gp, *p, *l;
@@ -760,9 +775,9 @@ private:
 	            *result = this->NO_VALUE;
 	            return true; // success
 	        } else {
-	            Node<K,V> *gpleft, *gpright;
-	            Node<K,V> *pleft, *pright;
-	            Node<K,V> *sleft, *sright;
+	            Node<K,V> *gpleft = NULL, *gpright = NULL;
+	            Node<K,V> *pleft = NULL, *pright = NULL;
+	            Node<K,V> *sleft = NULL, *sright = NULL;
 	            gpleft = gp->left;
 	            gpright = gp->right;
 	            pleft = p->left;
@@ -784,7 +799,6 @@ private:
 	            return true;
 	        }
 	    } else { // transaction failed
-	aborthere:
 	        info->lastAbort = status;
 //	        IF_ALWAYS_RETRY_WHEN_BIT_SET if (status & _XABORT_RETRY) { this->counters->pathFail[info->path]->inc(tid); this->counters->htmRetryAbortRetried[info->path]->inc(tid); goto TXN1; }
 	        return false;
@@ -801,8 +815,8 @@ private:
 	    SCXRecord<K,V>* scx = (SCXRecord<K,V>*) NEXT_VERSION_NUMBER(tid);
 		Node<K,V> *newNode = allocateNode(tid);
 	    Node<K,V> *gp, *p, *l;
-	TXN1: int attempts = MAX_FAST_HTM_RETRIES;
-	    int status = _xbegin();
+	int attempts = MAX_FAST_HTM_RETRIES;
+	    unsigned status = _xbegin();
 	    if (status == _XBEGIN_STARTED) {
 	        if (info->path == PATH_FAST_HTM && numFallback.load(memory_order_relaxed) > 0) _xabort(ABORT_PROCESS_ON_FALLBACK);
 	        l = root->left;
@@ -826,9 +840,9 @@ private:
 	            *result = this->NO_VALUE;
 	            return true; // success
 	        } else {
-	            Node<K,V> *gpleft, *gpright;
-	            Node<K,V> *pleft, *pright;
-	            Node<K,V> *sleft, *sright;
+	            Node<K,V> *gpleft = NULL, *gpright = NULL;
+	            Node<K,V> *pleft = NULL, *pright = NULL;
+	            Node<K,V> *sleft = NULL, *sright = NULL;
 	            if ((info->llxResults[0] = llx_intxn_markingwr_infowr(tid, gp, &gpleft, &gpright)) == NULL) _xabort(ABORT_LLX_FAILED);
 	            if ((info->llxResults[1] = llx_intxn_markingwr_infowr(tid, p, &pleft, &pright)) == NULL) _xabort(ABORT_LLX_FAILED);
 	            *result = l->value;
@@ -860,7 +874,6 @@ private:
 	            return true;
 	        }
 	    } else {
-	aborthere:
 	        info->lastAbort = status;
 //	        IF_ALWAYS_RETRY_WHEN_BIT_SET if (status & _XABORT_RETRY) { this->counters->pathFail[info->path]->inc(tid); this->counters->htmRetryAbortRetried[info->path]->inc(tid); goto TXN1; }
 	        return false;
@@ -895,9 +908,9 @@ private:
 	        *result = this->NO_VALUE;
 	        return true; // success
 	    } else {
-	        Node<K,V> *gpleft, *gpright;
-	        Node<K,V> *pleft, *pright;
-	        Node<K,V> *sleft, *sright;
+	        Node<K,V> *gpleft = NULL, *gpright = NULL;
+	        Node<K,V> *pleft = NULL, *pright = NULL;
+	        Node<K,V> *sleft = NULL, *sright = NULL;
 	        if ((info->llxResults[0] = llx(tid, gp, &gpleft, &gpright)) == NULL) return false;
 	        if (p != gpleft && p != gpright) return false;
 	        if ((info->llxResults[1] = llx(tid, p, &pleft, &pright)) == NULL) return false;
@@ -954,8 +967,8 @@ private:
 	        *result = this->NO_VALUE;
 	        return true; // success
 	    } else {
-	        Node<K,V> *gpleft, *gpright;
-	        Node<K,V> *pleft, *pright;
+	        Node<K,V> *gpleft = NULL, *gpright = NULL;
+	        Node<K,V> *pleft = NULL, *pright = NULL;
 	        gpleft = gp->left;
 	        gpright = gp->right;
 	        pleft = p->left;
@@ -1053,13 +1066,13 @@ private:
 	        } else {
 //				if (shmem->shouldHelp()) {
 				assert(scx2 != dummy);
-				if (!IS_VERSION_NUMBER(scx2)) help(tid, scx2, true);
+				if (!IS_VERSION_NUMBER(scx2)) { counters.inc(tid, MAP_STAT_HELPS); help(tid, scx2, true); }
 //				}
 	        }
 	    } else if (state == SCXRecord<K,V>::STATE_INPROGRESS) {
 //			if (shmem->shouldHelp()) {
 			assert(scx1 != dummy);
-			if (!IS_VERSION_NUMBER(scx1)) help(tid, scx1, true);
+			if (!IS_VERSION_NUMBER(scx1)) { counters.inc(tid, MAP_STAT_HELPS); help(tid, scx1, true); }
 //			}
 	    } else {
 	        // state committed and marked
@@ -1068,7 +1081,7 @@ private:
 //			if (shmem->shouldHelp()) {
 			SCXRecord<K,V> *scx3 = node->scxRecord;
 			assert(scx3 != dummy);
-			if (!IS_VERSION_NUMBER(scx3)) help(tid, scx3, true);
+			if (!IS_VERSION_NUMBER(scx3)) { counters.inc(tid, MAP_STAT_HELPS); help(tid, scx3, true); }
 //			} else {
 //			}
 	    }
@@ -1235,9 +1248,9 @@ const std::pair<V,bool> BST_BROWN_FUNCT::find(const int tid, const K& key)
 
 BST_BROWN_TEMPL
 int BST_BROWN_FUNCT::rangeQuery(const int tid, const K& lo, const K& hi,
-                      std::vector<std::pair<K,V>> kv_pairs)
+                      std::vector<std::pair<K,V>>& kv_pairs)
 {
-	return 0;
+	return -1;
 }
 
 BST_BROWN_TEMPL
@@ -37,7 +37,9 @@ public:
 	}
 
 	void initThread(const int tid) {
-		last_result_threadlocal = (search_result_t *)new search_result_t();
+		search_result_t *last_result = new search_result_t();
+		last_result->tid = tid;
+		last_result_threadlocal = (void *)last_result;
 	};
 	void deinitThread(const int tid) {};
 
@@ -45,7 +47,7 @@ public:
 	const std::pair<V,bool> find(const int tid, const K& key);
 	int                     rangeQuery(const int tid,
 	                                   const K& lo, const K& hi,
-	                                   std::vector<std::pair<K,V>> kv_pairs);
+	                                   std::vector<std::pair<K,V>>& kv_pairs);
 
 	const V                 insert(const int tid, const K& key, const V& val);
 	const V                 insertIfAbsent(const int tid, const K& key,
@@ -57,12 +59,23 @@ public:
 
 	void print() { };
 	unsigned long long size() { return size_rec(root) - 2; };
+	void stats(MapStats *stats) { counters.add_to(stats); }
+	void memoryStats(MemoryStats *stats)
+	{
+		unsigned long long internal = 0, leaves = 0;
+		memory_stats_rec(root, &internal, &leaves);
+		stats->add_nodes("internal", sizeof(node_t), internal);
+		stats->add_nodes("leaf", sizeof(node_t), leaves);
+		stats->add_keys(leaves - 2); //> The two sentinel leaves
+	}
 
 private:
 	union info_t;
 	typedef info_t* update_t; // FIXME quite a few CASes done on this data
 
 	struct node_t {
+		NODE_ALLOCATOR_OPERATORS
+
 		K key;
 		V value;
 		update_t update;
@@ -116,6 +129,7 @@ private:
 		       *l;
 		update_t pupdate,
 		         gpupdate;
+		int tid; //> For the counters
 
 		search_result_t() {
 			gp = p = l = NULL;
@@ -124,6 +138,11 @@ private:
 	};
 
 	node_t *root;
+	MapCounters counters;
+
+	inline void count(map_stat_t stat) {
+		counters.inc(((search_result_t *)last_result_threadlocal)->tid, stat);
+	}
 
 private:
 #undef GETFLAG
@@ -193,6 +212,7 @@ private:
 			help_marked(op);
 			return true;
 		} else {
+			count(MAP_STAT_CAS_FAILURES);
 			help(result);
 			void *dummy = CAS_PTR(&(op->dinfo.gp->update), FLAG(op,STATE_DFLAG),
 			                                               FLAG(op,STATE_CLEAN));
@@ -212,6 +232,7 @@ private:
 	
 	void help(update_t u)
 	{
+		if (GETFLAG(u) != STATE_CLEAN) count(MAP_STAT_HELPS);
 		if (GETFLAG(u) == STATE_IFLAG)      help_insert((info_t*)UNFLAG(u));
 		else if (GETFLAG(u) == STATE_MARK)  help_marked((info_t*)UNFLAG(u));
 		else if (GETFLAG(u) == STATE_DFLAG) help_delete((info_t*)UNFLAG(u)); 
@@ -254,6 +275,7 @@ private:
 				help_insert(op);
 				return 1;
 			} else {
+				count(MAP_STAT_CAS_FAILURES);
 				help(result);
 			}
 		}
@@ -271,6 +293,7 @@ private:
 				return search_result->l->value;
 			if (do_insert(key, value, &new_node, &new_sibling, &new_internal, search_result))
 				return this->NO_VALUE;
+			count(MAP_STAT_RESTARTS);
 		}
 	}
 
@@ -292,6 +315,7 @@ private:
 			if (result == search_result->gpupdate) {
 				if (help_delete(op) == true) return 1;
 			} else {
+				count(MAP_STAT_CAS_FAILURES);
 				help(result);
 			}
 		}
@@ -306,6 +330,7 @@ private:
 			search_result = search(key); 
 			if (search_result->l->key != key)      return this->NO_VALUE;
 			if (do_delete(search_result, del_val)) return del_val;
+			count(MAP_STAT_RESTARTS);
 		}
 	}
 
@@ -341,6 +366,18 @@ private:
 			if (node->leaf) return 1;
 			return (size_rec(node->right) + size_rec(node->left));
 	}
+
+	void memory_stats_rec(node_t *node, unsigned long long *internal,
+	                      unsigned long long *leaves)
+	{
+		if (node->leaf) {
+			(*leaves)++;
+			return;
+		}
+		(*internal)++;
+		memory_stats_rec(node->left, internal, leaves);
+		memory_stats_rec(node->right, internal, leaves);
+	}
 	
 	int total_paths, total_nodes, bst_violations;
 	int min_path_len, max_path_len;
@@ -422,9 +459,9 @@ const std::pair<V,bool> BST_UNB_ELLEN_FUNCT::find(const int tid, const K& key)
 
 BST_UNB_ELLEN_TEMPL
 int BST_UNB_ELLEN_FUNCT::rangeQuery(const int tid, const K& lo, const K& hi,
-                      std::vector<std::pair<K,V>> kv_pairs)
+                      std::vector<std::pair<K,V>>& kv_pairs)
 {
-	return 0;
+	return -1;
 }
 
 BST_UNB_ELLEN_TEMPL
@@ -62,7 +62,7 @@ public:
 	const std::pair<V,bool> find(const int tid, const K& key);
 	int                     rangeQuery(const int tid,
 	                                   const K& lo, const K& hi,
-	                                   std::vector<std::pair<K,V>> kv_pairs);
+	                                   std::vector<std::pair<K,V>>& kv_pairs);
 
 	const V                 insert(const int tid, const K& key, const V& val);
 	const V                 insertIfAbsent(const int tid, const K& key,
@@ -79,6 +79,8 @@ private:
 	union operation_t;
 
 	struct node_t {
+		NODE_ALLOCATOR_OPERATORS
+
 		K key; 
 	    V value;
 		operation_t *op;
@@ -490,9 +492,9 @@ const std::pair<V,bool> BST_UNB_HOWLEY_FUNCT::find(const int tid, const K& key)
 
 BST_UNB_HOWLEY_TEMPL
 int BST_UNB_HOWLEY_FUNCT::rangeQuery(const int tid, const K& lo, const K& hi,
-                      std::vector<std::pair<K,V>> kv_pairs)
+                      std::vector<std::pair<K,V>>& kv_pairs)
 {
-	return 0;
+	return -1;
 }
 
 BST_UNB_HOWLEY_TEMPL
@@ -2,10 +2,18 @@
  * An external unbalanced binary search tree.
  * Paper:
  *    Fast concurrent lock-free binary search trees, Natarajan et. al, PPoPP 2014
+ *
+ * With COMPACT set, the nodes have no padding and their child fields are
+ * 32-bit words that hold the arena offset of the child (see
+ * NodeAllocator::compress()) shifted left by 2, so that the flag and tag bits
+ * stay in the 2 LSBs as with plain pointers. This reaches the first 8GB of
+ * the NodeAllocator arena.
  **/
 
 #pragma once
 
+#include <type_traits>
+
 #include "../map_if.h"
 #include "Log.h"
 
@@ -18,46 +26,52 @@
 
 #define MAX(a,b) ( (a) >= (b) ? (a) : (b) )
 
-//> Helper functions
-#define GETFLAG(ptr) ((uint64_t)(ptr) & 1)
-#define GETTAG(ptr)  ((uint64_t)(ptr) & 2)
-#define FLAG(ptr)    ((node_t *)((uint64_t)(ptr) | 1))
-#define TAG(ptr)     ((node_t *)((uint64_t)(ptr) | 2))
-#define UNTAG(ptr)   ((node_t *)((uint64_t)(ptr) & 0xfffffffffffffffd))
-#define UNFLAG(ptr)  ((node_t *)((uint64_t)(ptr) & 0xfffffffffffffffe))
-#define ADDRESS(ptr) ((node_t *)((uint64_t)(ptr) & 0xfffffffffffffffc))
+//> Helper functions, on child_t words
+#define GETFLAG(w) ((uint64_t)(w) & 1)
+#define GETTAG(w)  ((uint64_t)(w) & 2)
+#define FLAG(w)    ((child_t)((uint64_t)(w) | 1))
+#define TAG(w)     ((child_t)((uint64_t)(w) | 2))
+#define UNTAG(w)   ((child_t)((uint64_t)(w) & 0xfffffffffffffffd))
+#define UNFLAG(w)  ((child_t)((uint64_t)(w) & 0xfffffffffffffffe))
 
 static __thread void* seek_record_threadlocal; //FIXME is this OK to be here??
 
-template <typename K, typename V>
+template <typename K, typename V, bool COMPACT = false>
 class bst_unb_natarajan: public Map<K,V> {
 public:
 	bst_unb_natarajan(const K _NO_KEY, const V _NO_VALUE, const int numProcesses)
 	  : Map<K,V>(_NO_KEY, _NO_VALUE)
 	{
 		node_t *r, *s, *inf0, *inf1, *inf2;
+		//> The child words keep 30 bits of the offset, so the nodes have to
+		//> be within the first 8GB of the arena (see to_word()).
+		if (COMPACT) NodeAllocator::require_arena((1ULL << 30) * NODE_ALLOCATOR_ALIGN);
 		r = new node_t(INF2, NULL);
 		s = new node_t(INF1, NULL);
 		inf0 = new node_t(INF0, NULL);
 		inf1 = new node_t(INF1, NULL);
 		inf2 = new node_t(INF2, NULL);
 	    asm volatile("" ::: "memory");
-	    r->left = s;
-	    r->right = inf2;
-	    s->right = inf1;
-	    s->left= inf0;
+	    r->left = to_word(s);
+	    r->right = to_word(inf2);
+	    s->right = to_word(inf1);
+	    s->left= to_word(inf0);
 	    asm volatile("" ::: "memory");
 		root = r;
 	}
 
-	void initThread(const int tid) { seek_record_threadlocal = (void*)(new seek_record_t()); };
+	void initThread(const int tid) {
+		seek_record_t *seek_record = new seek_record_t();
+		seek_record->tid = tid;
+		seek_record_threadlocal = (void*)seek_record;
+	};
 	void deinitThread(const int tid) {};
 
 	bool                    contains(const int tid, const K& key);
 	const std::pair<V,bool> find(const int tid, const K& key);
 	int                     rangeQuery(const int tid,
 	                                   const K& lo, const K& hi,
-	                                   std::vector<std::pair<K,V>> kv_pairs);
+	                                   std::vector<std::pair<K,V>>& kv_pairs);
 
 	const V                 insert(const int tid, const K& key, const V& val);
 	const V                 insertIfAbsent(const int tid, const K& key,
@@ -65,49 +79,91 @@ public:
 	const std::pair<V,bool> remove(const int tid, const K& key);
 
 	bool  validate();
-	char *name() { return "BST Unbalanced Natarajan"; }
+	char *name() {
+		if (COMPACT) return "BST Unbalanced Natarajan (compact)";
+		return "BST Unbalanced Natarajan";
+	}
 
 	void print() { };
 	unsigned long long size() { return size_rec(root); };
+	void stats(MapStats *stats) { counters.add_to(stats); }
+	void memoryStats(MemoryStats *stats)
+	{
+		unsigned long long internal = 0, leaves = 0;
+		stats->add_keys(memory_stats_rec(root, &internal, &leaves));
+		stats->add_nodes("internal", sizeof(node_t), internal);
+		stats->add_nodes("leaf", sizeof(node_t), leaves);
+	}
 
 private:
 
-	struct node_t {
+	struct node_t;
+	typedef typename std::conditional<COMPACT, uint32_t, node_t *>::type child_t;
+
+	//> The padding of the nodes is a base class, so that the compact nodes
+	//> get none at all (empty base).
+	struct padded_t { char padding[32]; };
+	struct unpadded_t { };
+	typedef typename std::conditional<COMPACT, unpadded_t, padded_t>::type node_base_t;
+
+	struct node_t : node_base_t {
+		NODE_ALLOCATOR_OPERATORS
+
 		K key;
 		V value;
 	
-		node_t *left, *right;
-		char padding[32];
+		child_t left, right;
 
 		node_t(K key, V value) {
 			this->key = key;
 			this->value = value;
-			this->right = this->left = NULL;
+			this->right = this->left = 0;
 		}
 	};
 
+	//> Conversions between node pointers and (untagged) child words.
+	static inline node_t *to_node(node_t *w) {
+		return (node_t *)((uint64_t)w & 0xfffffffffffffffc);
+	}
+	static inline node_t *to_node(uint32_t w) {
+		return (node_t *)NodeAllocator::decompress(w >> 2);
+	}
+	static inline child_t to_word(node_t *n) { return to_word(n, (child_t *)NULL); }
+	static inline node_t *to_word(node_t *n, node_t **) { return n; }
+	static inline uint32_t to_word(node_t *n, uint32_t *) {
+		uint32_t off = NodeAllocator::compress(n);
+		assert(off < (1U << 30));
+		return off << 2;
+	}
+
 	struct seek_record_t {
 		node_t *ancestor, *successor,
 		       *parent, *leaf;
-		char padding[64 - 4 * sizeof(node_t *)];
+		int tid; //> For the counters
+		char padding[64 - 4 * sizeof(node_t *) - sizeof(int)];
 	};
 
 	node_t *root;
+	MapCounters counters;
+
+	inline void count(map_stat_t stat) {
+		counters.inc(((seek_record_t*)seek_record_threadlocal)->tid, stat);
+	}
 
 private:
 
 	seek_record_t *seek(const K& key, node_t *node_r) {
 		seek_record_t *seek_record = (seek_record_t*)seek_record_threadlocal;
 		seek_record_t seek_record_l;
-		node_t *node_s = ADDRESS(node_r->left);
+		node_t *node_s = to_node(node_r->left);
 		seek_record_l.ancestor = node_r;
 		seek_record_l.successor = node_s; 
 		seek_record_l.parent = node_s;
-		seek_record_l.leaf = ADDRESS(node_s->left);
+		seek_record_l.leaf = to_node(node_s->left);
 	
-		node_t* parent_field = (node_t*) seek_record_l.parent->left;
-		node_t* current_field = (node_t*) seek_record_l.leaf->left;
-		node_t* current = ADDRESS(current_field);
+		child_t parent_field = seek_record_l.parent->left;
+		child_t current_field = seek_record_l.leaf->left;
+		node_t* current = to_node(current_field);
 	
 		while (current != NULL) {
 			if (!GETTAG(parent_field)) {
@@ -118,10 +174,10 @@ private:
 			seek_record_l.leaf = current;
 	
 			parent_field = current_field;
-			if (key < current->key) current_field = (node_t*) current->left;
-			else                    current_field = (node_t*) current->right;
+			if (key < current->key) current_field = current->left;
+			else                    current_field = current->right;
 	
-			current = ADDRESS(current_field);
+			current = to_node(current_field);
 		}
 		seek_record->ancestor = seek_record_l.ancestor;
 		seek_record->successor = seek_record_l.successor;
@@ -149,21 +205,21 @@ private:
 		node_t *successor = seek_record->successor;
 		node_t *parent = seek_record->parent;
 	
-		node_t **succ_addr;
-		if (key < ancestor->key) succ_addr = (node_t**) &(ancestor->left);
-		else                     succ_addr = (node_t**) &(ancestor->right);
+		child_t *succ_addr;
+		if (key < ancestor->key) succ_addr = &(ancestor->left);
+		else                     succ_addr = &(ancestor->right);
 	
-		node_t **child_addr;
-		node_t **sibling_addr;
+		child_t *child_addr;
+		child_t *sibling_addr;
 		if (key < parent->key) {
-			child_addr = (node_t**) &(parent->left);
-			sibling_addr = (node_t**) &(parent->right);
+			child_addr = &(parent->left);
+			sibling_addr = &(parent->right);
 		} else {
-			child_addr = (node_t**) &(parent->right);
-			sibling_addr = (node_t**) &(parent->left);
+			child_addr = &(parent->right);
+			sibling_addr = &(parent->left);
 		}
 	
-		node_t *chld = *child_addr;
+		child_t chld = *child_addr;
 		if (!GETFLAG(chld)) {
 			chld = *sibling_addr;
 			asm volatile("");
@@ -171,16 +227,18 @@ private:
 		}
 	
 		while (1) {
-			node_t *untagged = *sibling_addr;
-			node_t *tagged = TAG(untagged);
-			node_t *res = CAS_PTR(sibling_addr, untagged, tagged);
+			child_t untagged = *sibling_addr;
+			child_t tagged = TAG(untagged);
+			child_t res = CAS_PTR(sibling_addr, untagged, tagged);
 			if (res == untagged) break;
+			count(MAP_STAT_CAS_FAILURES);
 		}
 	
-		node_t *sibl = *sibling_addr;
-		if (CAS_PTR(succ_addr, ADDRESS(successor), UNTAG(sibl)) == ADDRESS(successor))
+		child_t sibl = *sibling_addr;
+		if (CAS_PTR(succ_addr, to_word(successor), UNTAG(sibl)) == to_word(successor))
 			return 1;
 
+		count(MAP_STAT_CAS_FAILURES);
 		return 0;
 	}
 
@@ -190,10 +248,10 @@ private:
 		seek_record_t *seek_record = (seek_record_t*)seek_record_threadlocal;
 		node_t *parent = seek_record->parent;
 		node_t *leaf = seek_record->leaf;
-		node_t **child_addr;
+		child_t *child_addr;
 	
-		if (key < parent->key) child_addr = (node_t**) &(parent->left); 
-		else                   child_addr = (node_t**) &(parent->right);
+		if (key < parent->key) child_addr = &(parent->left); 
+		else                   child_addr = &(parent->right);
 	
 		if (*created == 0) {
 			*new_internal = new node_t(MAX(key,leaf->key),0);
@@ -204,20 +262,23 @@ private:
 		}
 	
 		if (key < leaf->key) {
-			(*new_internal)->left = *new_node;
-			(*new_internal)->right = leaf; 
+			(*new_internal)->left = to_word(*new_node);
+			(*new_internal)->right = to_word(leaf); 
 		} else {
-			(*new_internal)->right = *new_node;
-			(*new_internal)->left = leaf;
+			(*new_internal)->right = to_word(*new_node);
+			(*new_internal)->left = to_word(leaf);
 		}
 	
-		node_t *result = CAS_PTR(child_addr, ADDRESS(leaf), ADDRESS(*new_internal));
-		if (result == ADDRESS(leaf))
+		child_t result = CAS_PTR(child_addr, to_word(leaf), to_word(*new_internal));
+		if (result == to_word(leaf))
 			return true;
+		count(MAP_STAT_CAS_FAILURES);
 	
-		node_t *chld = *child_addr; 
-		if ((ADDRESS(chld)==leaf) && (GETFLAG(chld) || GETTAG(chld)))
+		child_t chld = *child_addr; 
+		if ((to_node(chld)==leaf) && (GETFLAG(chld) || GETTAG(chld))) {
+			count(MAP_STAT_HELPS);
 			cleanup(key);
+		}
 		return false;
 	}
 
@@ -232,6 +293,7 @@ private:
 	            return seek_record->leaf->value;
 			if (do_insert(key, val, &created, &new_internal, &new_node))
 				return this->NO_VALUE;
+			count(MAP_STAT_RESTARTS);
 		}
 	}
 
@@ -239,27 +301,30 @@ private:
 	{
 		seek_record_t *seek_record = (seek_record_t*)seek_record_threadlocal;
 		node_t *parent = seek_record->parent;
-		node_t **child_addr;
-		node_t *lf, *result, *chld;
+		child_t *child_addr;
+		child_t lf, result, chld;
 	
-		if (key < parent->key) child_addr = (node_t**) &(parent->left);
-		else                   child_addr = (node_t**) &(parent->right);
+		if (key < parent->key) child_addr = &(parent->left);
+		else                   child_addr = &(parent->right);
 	
 		if (*injecting == 1) {
 			*leaf = seek_record->leaf;
 			if ((*leaf)->key != key)
 				return 0;
 	
-			lf = ADDRESS(*leaf);
+			lf = to_word(*leaf);
 			result = CAS_PTR(child_addr, lf, FLAG(lf));
-			if (result == ADDRESS(*leaf)) {
+			if (result == lf) {
 				*injecting = 0;
 				if (cleanup(key))
 					return 1;
 			} else {
+				count(MAP_STAT_CAS_FAILURES);
 				chld = *child_addr;
-				if ( (ADDRESS(chld) == *leaf) && (GETFLAG(chld) || GETTAG(chld)) )
+				if ( (to_node(chld) == *leaf) && (GETFLAG(chld) || GETTAG(chld)) ) {
+					count(MAP_STAT_HELPS);
 					cleanup(key);
+				}
 			}
 		} else {
 			if (seek_record->leaf != *leaf) {
@@ -282,6 +347,7 @@ private:
 			ret = do_remove(key, &injecting, &leaf);
 			if (ret == 1) return leaf->value;
 			else if (ret == 0) return this->NO_VALUE;
+			count(MAP_STAT_RESTARTS);
 	    }
 	}
 
@@ -314,18 +380,34 @@ private:
 	unsigned long long size_rec(node_t* node) {
 		if (node == NULL) return 0; 
 	
-		if ((node->left == NULL) && (node->right == NULL))
+		if ((node->left == 0) && (node->right == 0))
 			if (node->key < INF0 )
 				return 1;
 	
 		unsigned long long l = 0, r = 0;
 		if ( !GETFLAG(node->left) && !GETTAG(node->left))
-			l = size_rec(node->left);
+			l = size_rec(to_node(node->left));
 		if ( !GETFLAG(node->right) && !GETTAG(node->right))
-			r = size_rec(node->right);
+			r = size_rec(to_node(node->right));
 		return l+r;
 	}
 
+	//> Counts all the reachable nodes, including the sentinels and the leaves
+	//> of pending deletions, and returns the number of keys.
+	unsigned long long memory_stats_rec(node_t *node, unsigned long long *internal,
+	                                    unsigned long long *leaves)
+	{
+		if (node == NULL) return 0;
+
+		if (node->left == 0 && node->right == 0) {
+			(*leaves)++;
+			return (node->key < INF0) ? 1 : 0;
+		}
+		(*internal)++;
+		return memory_stats_rec(to_node(node->left), internal, leaves) +
+		       memory_stats_rec(to_node(node->right), internal, leaves);
+	}
+
 	int total_paths, total_nodes, bst_violations;
 	int min_path_len, max_path_len;
 	int min_path_key, max_path_key;
@@ -333,8 +415,8 @@ private:
 	{
 		if (!root) return;
 	
-		node_t *left = root->left;
-		node_t *right = root->right;
+		node_t *left = to_node(root->left);
+		node_t *right = to_node(root->right);
 	
 		if (root->key < INF0) {
 			total_nodes++;
@@ -394,8 +476,8 @@ private:
 
 };
 
-#define BST_UNB_NATARAJAN_TEMPL template<typename K, typename V>
-#define BST_UNB_NATARAJAN_FUNCT bst_unb_natarajan<K,V>
+#define BST_UNB_NATARAJAN_TEMPL template<typename K, typename V, bool COMPACT>
+#define BST_UNB_NATARAJAN_FUNCT bst_unb_natarajan<K,V,COMPACT>
 
 BST_UNB_NATARAJAN_TEMPL
 bool BST_UNB_NATARAJAN_FUNCT::contains(const int tid, const K& key)
@@ -413,9 +495,9 @@ const std::pair<V,bool> BST_UNB_NATARAJAN_FUNCT::find(const int tid, const K& ke
 
 BST_UNB_NATARAJAN_TEMPL
 int BST_UNB_NATARAJAN_FUNCT::rangeQuery(const int tid, const K& lo, const K& hi,
-                      std::vector<std::pair<K,V>> kv_pairs)
+                      std::vector<std::pair<K,V>>& kv_pairs)
 {
-	return 0;
+	return -1;
 }
 
 BST_UNB_NATARAJAN_TEMPL
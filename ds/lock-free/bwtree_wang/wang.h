@@ -131,6 +131,7 @@ static bool print_flag = false;
  * class BwTreeBase - Base class of bwtree_wang that stores some common members
  */
 class BwTreeBase {
+ protected:
   // This is the presumed size of cache line
   static constexpr size_t CACHE_LINE_SIZE = 64;
   
@@ -245,7 +246,7 @@ class BwTreeBase {
                 "class PaddedGCMetadata size does"
                 " not conform to the alignment!");
  
- private: 
+ protected: 
   // This is used as the garbage collection ID, and is maintained in a per
   // thread level
   // This is initialized to -1 in order to distinguish between registered 
@@ -544,7 +545,7 @@ public:
 	const std::pair<V,bool> find(const int tid, const K& key);
 	int                     rangeQuery(const int tid,
 	                                   const K& lo, const K& hi,
-	                                   std::vector<std::pair<K,V>> kv_pairs);
+	                                   std::vector<std::pair<K,V>>& kv_pairs);
 
 	const V                 insert(const int tid, const K& key, const V& val);
 	const V                 insertIfAbsent(const int tid, const K& key,
@@ -2164,7 +2165,7 @@ public:
         }
       } else {
         const size_t diff = (uint64_t)copy_end_p - (uint64_t)copy_start_p;
-        std::memcpy(End(), copy_start_p, diff);
+        std::memcpy((void *)End(), copy_start_p, diff);
         
         end = (ElementType *)((uint64_t)end + diff);
       }
@@ -2237,7 +2238,12 @@ public:
      * type of node
      */
     static ElasticNode *GetNodeHeader(const KeyNodeIDPair *low_key_p) {
+      // ElasticNode is not standard-layout (it derives from BaseNode), but
+      // GCC and Clang lay out its members as expected
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Winvalid-offsetof"
       static constexpr size_t low_key_offset = offsetof(ElasticNode, low_key);
+#pragma GCC diagnostic pop
       
       return reinterpret_cast<ElasticNode *>( \
                reinterpret_cast<uint64_t>(low_key_p) - low_key_offset);
@@ -5854,6 +5860,7 @@ before_switch:
         //
 
       } // case Inner/LeafRemoveType
+      // fall through
       case NodeType::InnerMergeType:
       case NodeType::LeafMergeType: {
         bwt_printf("Helping along merge delta\n");
@@ -9198,9 +9205,9 @@ const std::pair<V,bool> BWTREE_WANG_FUNCT::find(const int tid, const K& key)
 
 BWTRE_WANG_TEMPL
 int BWTREE_WANG_FUNCT::rangeQuery(const int tid, const K& lo, const K& hi,
-                      std::vector<std::pair<K,V>> kv_pairs)
+                      std::vector<std::pair<K,V>>& kv_pairs)
 {
-	return 0;
+	return -1;
 }
 
 BWTRE_WANG_TEMPL
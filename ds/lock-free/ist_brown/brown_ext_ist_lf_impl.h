@@ -116,7 +116,7 @@ public:
 	const std::pair<V,bool> find(const int tid, const K& key);
 	int                     rangeQuery(const int tid,
 	                                   const K& lo, const K& hi,
-	                                   std::vector<std::pair<K,V>> kv_pairs);
+	                                   std::vector<std::pair<K,V>>& kv_pairs);
 
 	const V                 insert(const int tid, const K& key, const V& val);
 	const V                 insertIfAbsent(const int tid, const K& key,
@@ -126,8 +126,11 @@ public:
 	bool  validate();
 	char *name() { return "IST Brown"; }
 
+	bool bulkLoad(const int tid, const std::vector<std::pair<K,V>>& kv_pairs);
+
 	void print() { print_helper(); };
 //	unsigned long long size() { return size_rec(root) - 2; };
+	void stats(MapStats *stats) { counters.add_to(stats); }
 
 private:
 
@@ -171,11 +174,15 @@ private:
 
 
 	struct KVPair {
+		NODE_ALLOCATOR_OPERATORS
+
 		K k;
 		V v;
 	};
 
 	struct Node {
+		NODE_ALLOCATOR_OPERATORS
+
 		/**
 		 * NOTE: unlisted fields: `degree-1` keys of type K followed by `degree`
 		 * values/pointers of type casword_t
@@ -282,6 +289,7 @@ private:
 	RandomFNV1A threadRNGs[88];
 	dcssProvider<void* /* unused */> * const prov;
 	Node *root;
+	MapCounters counters;
 
 private:
 	KVPair *createKVPair(const int tid, const K& key, const V& value)
@@ -296,7 +304,7 @@ private:
 	Node *createNode(const int tid, const int degree)
 	{
 		size_t sz = sizeof(Node) + sizeof(K) * (degree - 1) + sizeof(casword_t) * degree;
-		Node *node = (Node *) ::operator new (sz);
+		Node *node = (Node *) NodeAllocator::alloc(sz);
 		assert((((size_t) node) & TOTAL_MASK) == 0);
 		node->degree = degree;
 		node->capacity = 0;
@@ -548,14 +556,19 @@ private:
 					rebuild_if_necessary(tid, path, pathLength, affectsChangeSum);
 					return foundVal;
 				case 1:
+					counters.inc(tid, MAP_STAT_CAS_FAILURES);
 					goto retryNode;
 				case 2:
+					counters.inc(tid, MAP_STAT_CAS_FAILURES);
+					counters.inc(tid, MAP_STAT_RESTARTS);
 					goto retry;
 				case 3:
 					return foundVal;
 				}
 			} else if (IS_REBUILDOP(word)) {
+				counters.inc(tid, MAP_STAT_HELPS);
 				helpRebuild(tid, CASWORD_TO_REBUILDOP(word));
+				counters.inc(tid, MAP_STAT_RESTARTS);
 				goto retry;
 			} else {
 				assert(IS_NODE(word));
@@ -882,6 +895,7 @@ private:
 		if (result == DCSS_SUCCESS) {
 			assert(op->success == false);
 			op->success = true;
+			counters.inc(tid, MAP_STAT_REBUILDS);
 //			recordmgr->retire(tid, op);
 		} else {
 			// if we fail to CAS, then either:
@@ -1131,7 +1145,6 @@ private:
 				return; // stop early if someone else built the subtree already
 			
 			assert(*numKeysToAdd > 0);
-			assert(*numKeysToSkip >= 0);
 			auto childptr = prov->readPtr(tid, node->ptrAddr(i));
 			if (IS_VAL(childptr)) {
 				if (IS_EMPTY_VAL(childptr))
@@ -1357,9 +1370,9 @@ const std::pair<V,bool> IST_BROWN_FUNCT::find(const int tid, const K& key)
 
 IST_BROWN_TEMPL
 int IST_BROWN_FUNCT::rangeQuery(const int tid, const K& lo, const K& hi,
-                      std::vector<std::pair<K,V>> kv_pairs)
+                      std::vector<std::pair<K,V>>& kv_pairs)
 {
-	return 0;
+	return -1;
 }
 
 IST_BROWN_TEMPL
@@ -1386,3 +1399,20 @@ bool IST_BROWN_FUNCT::validate()
 {
 	return validate_helper();
 }
+
+IST_BROWN_TEMPL
+bool IST_BROWN_FUNCT::bulkLoad(const int tid,
+                               const std::vector<std::pair<K,V>>& kv_pairs)
+{
+	if (!IS_EMPTY_VAL(*root->ptrAddr(0))) return false;
+	if (kv_pairs.empty()) return true;
+
+	//> The subtree under the root is built exactly as a rebuild at depth 0
+	//> would build it.
+	IdealBuilder b(this, kv_pairs.size(), 0);
+	casword_t dummy = NODE_TO_CASWORD(NULL);
+	for (size_t i=0; i < kv_pairs.size(); i++)
+		b.addKV(tid, kv_pairs[i].first, kv_pairs[i].second);
+	*root->ptrAddr(0) = b.getCASWord(tid, &dummy);
+	return true;
+}
@@ -11,6 +11,7 @@
 #include <cstdarg>
 #include <csignal>
 #include <string.h>
+#include <stdlib.h>
 #include "plaf.h"
 #include "descriptors.h"
 
@@ -68,6 +69,11 @@ private:
     PAD;
 
 public:
+    // the descriptor arrays are cache line aligned, which new does not
+    // honor before C++17
+    static void *operator new(size_t size) { return aligned_alloc(64, size); }
+    static void operator delete(void *p) { free(p); }
+
 #ifdef USE_DEBUGCOUNTERS
     debugCounter * dcssHelpCounter;
     PAD;
@@ -22,6 +22,7 @@
 // the following definition is only used to pad data to avoid false sharing.
 // although the number of words per cache line is actually 8, we inflate this
 // figure to counteract the effects of prefetching multiple adjacent cache lines.
+#undef PREFETCH_SIZE_WORDS
 #define PREFETCH_SIZE_WORDS 16
 #define PREFETCH_SIZE_BYTES 128
 #define BYTES_IN_CACHE_LINE 64
@@ -31,7 +31,7 @@ public:
 	const std::pair<V,bool> find(const int tid, const K& key);
 	int                     rangeQuery(const int tid,
 	                                   const K& lo, const K& hi,
-	                                   std::vector<std::pair<K,V>> kv_pairs);
+	                                   std::vector<std::pair<K,V>>& kv_pairs);
 
 	const V                 insert(const int tid, const K& key, const V& val);
 	const V                 insertIfAbsent(const int tid, const K& key,
@@ -47,6 +47,8 @@ public:
 private:
 
 	struct node_t {
+		NODE_ALLOCATOR_OPERATORS
+
 		K key;
 		V value;
 
@@ -553,9 +555,9 @@ const std::pair<V,bool> BST_AVL_CF_FUNCT::find(const int tid, const K& key)
 
 BST_AVL_CF_TEMPL
 int BST_AVL_CF_FUNCT::rangeQuery(const int tid, const K& lo, const K& hi,
-                      std::vector<std::pair<K,V>> kv_pairs)
+                      std::vector<std::pair<K,V>>& kv_pairs)
 {
-	return 0;
+	return -1;
 }
 
 BST_AVL_CF_TEMPL
@@ -59,7 +59,7 @@ public:
 	const std::pair<V,bool> find(const int tid, const K& key);
 	int                     rangeQuery(const int tid,
 	                                   const K& lo, const K& hi,
-	                                   std::vector<std::pair<K,V>> kv_pairs);
+	                                   std::vector<std::pair<K,V>>& kv_pairs);
 
 	const V                 insert(const int tid, const K& key, const V& val);
 	const V                 insertIfAbsent(const int tid, const K& key,
@@ -75,6 +75,8 @@ public:
 private:
 
 	struct node_t {
+		NODE_ALLOCATOR_OPERATORS
+
 		K key;
 		V value;
 	
@@ -91,8 +93,8 @@ private:
 		node_t(K key, V value) {
 			this->key = key;
 			this->value = value;
-			this->lheight = lheight;
-			this->rheight = rheight;
+			this->lheight = 0;
+			this->rheight = 0;
 			this->marked = false;
 			this->parent = this->succ = this->pred = NULL;
 			this->right = this->left = NULL;
@@ -643,9 +645,9 @@ const std::pair<V,bool> BST_AVL_DRACHSLER_FUNCT::find(const int tid, const K& ke
 
 BST_AVL_DRACHSLER_TEMPL
 int BST_AVL_DRACHSLER_FUNCT::rangeQuery(const int tid, const K& lo, const K& hi,
-                      std::vector<std::pair<K,V>> kv_pairs)
+                      std::vector<std::pair<K,V>>& kv_pairs)
 {
-	return 0;
+	return -1;
 }
 
 BST_AVL_DRACHSLER_TEMPL
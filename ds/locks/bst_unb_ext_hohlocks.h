@@ -28,7 +28,7 @@ public:
 	const std::pair<V,bool> find(const int tid, const K& key);
 	int                     rangeQuery(const int tid,
 	                                   const K& lo, const K& hi,
-	                                   std::vector<std::pair<K,V>> kv_pairs);
+	                                   std::vector<std::pair<K,V>>& kv_pairs);
 
 	const V                 insert(const int tid, const K& key, const V& val);
 	const V                 insertIfAbsent(const int tid, const K& key,
@@ -44,6 +44,8 @@ public:
 private:
 
 	struct node_t {
+		NODE_ALLOCATOR_OPERATORS
+
 		K key;
 		V value;
 
@@ -315,9 +317,9 @@ const std::pair<V,bool> BST_UNB_EXT_HOHLOCKS_FUNCT::find(const int tid, const K&
 
 BST_UNB_EXT_HOHLOCKS_TEMPL
 int BST_UNB_EXT_HOHLOCKS_FUNCT::rangeQuery(const int tid, const K& lo, const K& hi,
-                      std::vector<std::pair<K,V>> kv_pairs)
+                      std::vector<std::pair<K,V>>& kv_pairs)
 {
-	return 0;
+	return -1;
 }
 
 BST_UNB_EXT_HOHLOCKS_TEMPL
@@ -32,12 +32,12 @@ typedef struct rcu_node_t {
     char p[184];
 } rcu_node;
 
-static void initURCU(int num_threads);
-static void urcu_read_lock();
-static void urcu_read_unlock();
-static void urcu_synchronize();
-static void urcu_register(int id);
-static void urcu_unregister();
+static inline void initURCU(int num_threads);
+static inline void urcu_read_lock();
+static inline void urcu_read_unlock();
+static inline void urcu_synchronize();
+static inline void urcu_register(int id);
+static inline void urcu_unregister();
 
 static int threads;
 static rcu_node **urcu_table;
@@ -46,7 +46,7 @@ static __thread volatile long *times = NULL;
 static __thread int i;
 static __thread int urcu_tid;
 
-static void initURCU(int num_threads)
+static inline void initURCU(int num_threads)
 {
    rcu_node **result = (rcu_node**)malloc(sizeof(rcu_node)*num_threads);
 
@@ -62,7 +62,7 @@ static void initURCU(int num_threads)
     return;
 }
 
-static void urcu_register(int id)
+static inline void urcu_register(int id)
 {
     times = (long *)malloc(sizeof(long)*threads);
     i = id;
@@ -73,12 +73,12 @@ static void urcu_register(int id)
     }
 }
 
-static void urcu_unregister()
+static inline void urcu_unregister()
 {
     free((void *)times);
 }
 
-static void urcu_read_lock()
+static inline void urcu_read_lock()
 {
     assert(urcu_table[i] != NULL);
     __sync_add_and_fetch(&urcu_table[i]->time, 1);
@@ -89,13 +89,13 @@ static inline void set_bit(int nr, volatile long *addr)
     asm("btsl %1,%0" : "+m" (*addr) : "Ir" (nr));
 }
 
-static void urcu_read_unlock()
+static inline void urcu_read_unlock()
 {
     assert(urcu_table[i] !=  NULL);
     set_bit(0, &urcu_table[i]->time);
 }
 
-static void urcu_synchronize()
+static inline void urcu_synchronize()
 {
     //read old counters
     for(int i=0; i<threads ; i++) times[i] = urcu_table[i]->time;
@@ -104,7 +104,7 @@ static void urcu_synchronize()
 		if (i == urcu_tid) continue;
         if (times[i] & 1) continue;
         while(1) {
-            unsigned long t = urcu_table[i]->time;
+            long t = urcu_table[i]->time;
             if (t & 1 || t > times[i]) break;
         }
     }
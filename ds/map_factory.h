@@ -53,16 +53,22 @@ static Map<K,V> *createMap(std::string& type, std::string& sync_type)
 		map = new bst_unb_pext<K,V>(MAX_KEY, NULL, 88);
 	else if (type == "bst-unb-ext")
 		map = new bst_unb_ext<K,V>(MAX_KEY, NULL, 88);
+	else if (type == "bst-unb-ext-compact")
+		map = new bst_unb_ext<K,V,true>(MAX_KEY, NULL, 88);
 	else if (type == "bst-avl-int")
 		map = new bst_avl_int<K,V>(MAX_KEY, NULL, 88);
 	else if (type == "bst-avl-pext")
 		map = new bst_avl_pext<K,V>(MAX_KEY, NULL, 88);
 	else if (type == "bst-avl-ext")
 		map = new bst_avl_ext<K,V>(MAX_KEY, NULL, 88);
+	else if (type == "bst-avl-ext-compact")
+		map = new bst_avl_ext<K,V,true>(MAX_KEY, NULL, 88);
 	else if (type == "bst-rbt-int")
 		map = new bst_rbt_int<K,V>(MAX_KEY, NULL, 88);
 	else if (type == "bst-rbt-ext")
 		map = new bst_rbt_ext<K,V>(MAX_KEY, NULL, 88);
+	else if (type == "bst-rbt-ext-compact")
+		map = new bst_rbt_ext<K,V,true>(MAX_KEY, NULL, 88);
 	else if (type == "btree")
 		map = new btree<K,V>(MAX_KEY, NULL, 88);
 	else if (type == "abtree")
@@ -81,6 +87,8 @@ static Map<K,V> *createMap(std::string& type, std::string& sync_type)
 	//> Lock-free
 	else if (type == "bst-unb-natarajan")
 		map = new bst_unb_natarajan<K,V>(MAX_KEY, NULL, 88);
+	else if (type == "bst-unb-natarajan-compact")
+		map = new bst_unb_natarajan<K,V,true>(MAX_KEY, NULL, 88);
 	else if (type == "bst-unb-ellen")
 		map = new bst_unb_ellen<K,V>(MAX_KEY, NULL, 88);
 	else if (type == "bst-unb-howley")
@@ -122,6 +130,12 @@ static Map<K,V> *createMap(std::string& type, std::string& sync_type)
 		map = new rcu_htm<K,V>(MAX_KEY, NULL, 88, map);
 	else if (sync_type == "rcu-sgl")
 		map = new rcu_htm<K,V>(MAX_KEY, NULL, 88, map, 0);
+	//> No synchronization wrapper, the data structure is used as is
+	else if (sync_type != "" && sync_type != "none" && sync_type != "NONE"
+	                         && sync_type != "Sequential") {
+		std::cerr << "Wrong sync type provided\n";
+		exit(1);
+	}
 
 	return map;
 }
@@ -9,6 +9,9 @@
 #include <vector>
 
 #include "Log.h"
+#include "NodeAllocator.h"
+#include "MemoryStats.h"
+#include "MapStats.h"
 
 #define NOT_IMPLEMENTED() log_info("%s() is not yet overriden by this data structure\n", __func__)
 
@@ -35,11 +38,14 @@ public:
 	virtual void deinitThread(const int tid) = 0;
 
 	//> Map operations. Thread-safe.
+	//> rangeQuery() appends the pairs with keys in [lo, hi] to `kv_pairs`, in
+	//> key order, and returns their number, or -1 if the data structure does
+	//> not support range queries.
 	virtual bool                    contains(const int tid, const K& key) = 0;
 	virtual const std::pair<V,bool> find(const int tid, const K& key) = 0;
 	virtual int                     rangeQuery(const int tid,
 	                                           const K& lo, const K& hi,
-	                                           std::vector<std::pair<K,V>> kv_pairs) = 0;
+	                                           std::vector<std::pair<K,V>>& kv_pairs) = 0;
 
 	virtual const V                 insert(const int tid, const K& key,
 	                                       const V& val) = 0;
@@ -47,16 +53,43 @@ public:
 	                                               const V& val) = 0;
 	virtual const std::pair<V,bool> remove(const int tid, const K& key) = 0;
 
+	//> Multi-value insertion, for maps whose values are lists of items (e.g.,
+	//> the macrobench indexes, where a key may have many rows). Inserts `val`
+	//> if `key` is absent, otherwise calls append(found, val) which must link
+	//> `val` to the list found atomically (e.g., with a CAS), so the operation
+	//> is as lock-free as insertIfAbsent(). Returns the value found, or
+	//> NO_VALUE if `val` was inserted.
+	virtual const V insertOrAppend(const int tid, const K& key, const V& val,
+	                               void (*append)(const V& found, const V& val))
+	{
+		const V found = insertIfAbsent(tid, key, val);
+		if (found != NO_VALUE) append(found, val);
+		return found;
+	}
+
 	//> Functions that are called by only one thread before or after the
 	//> execution of any benchmark on the map.
 	virtual bool  validate() = 0;
 	virtual char *name() = 0;
+
+	//> Builds the map from `kv_pairs` which must be sorted by key and contain
+	//> no duplicates. The map must be empty. Returns false if the data
+	//> structure does not provide a bulk-load path, in which case the map is
+	//> left untouched and the caller should fall back to single insertions.
+	virtual bool bulkLoad(const int tid,
+	                      const std::vector<std::pair<K,V>>& kv_pairs) { return false; }
 	
 	//> Methods that are used for debugging.
 	//> These are not pure virtual to allow newly implemented data structures
 	//> to be used without the need to implement those methods.
 	virtual void print() { NOT_IMPLEMENTED(); }
 	virtual unsigned long long size() { NOT_IMPLEMENTED(); return -1; }
+	//> Adds the reachable nodes, by type, and the keys of the map to `stats`.
+	//> Called by one thread, when no other thread operates on the map.
+	virtual void memoryStats(MemoryStats *stats) { NOT_IMPLEMENTED(); }
+	//> Adds the internal events counted so far (see lib/MapStats.h) to
+	//> `stats`. Data structures that do not count any events leave it as is.
+	virtual void stats(MapStats *stats) {}
 
 
 public:
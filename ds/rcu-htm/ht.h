@@ -30,7 +30,7 @@ typedef struct {
 	void *entries[HT_LEN][HT_MAX_BUCKET_LEN * 2];
 } ht_t;
 
-static ht_t *ht_new()
+static inline ht_t *ht_new()
 {
 	int i;
 	ht_t *ret;
@@ -41,12 +41,12 @@ static ht_t *ht_new()
 	return ret;
 }
 
-static void ht_reset(ht_t *ht)
+static inline void ht_reset(ht_t *ht)
 {
 	memset(&ht->bucket_next_index[0], 0, sizeof(ht->bucket_next_index));
 }
 
-static void ht_insert(ht_t *ht, void *key, void *value)
+static inline void ht_insert(ht_t *ht, void *key, void *value)
 {
 	int bucket = HT_GET_BUCKET(key);
 	unsigned short bucket_index = ht->bucket_next_index[bucket];
@@ -59,7 +59,7 @@ static void ht_insert(ht_t *ht, void *key, void *value)
 	ht->entries[bucket][bucket_index+1] = value;
 }
 
-static void *ht_get(ht_t *ht, void *key)
+static inline void *ht_get(ht_t *ht, void *key)
 {
 	int bucket = HT_GET_BUCKET(key);
 	int i;
@@ -71,7 +71,7 @@ static void *ht_get(ht_t *ht, void *key)
 	return NULL;
 }
 
-static void ht_print(ht_t *ht)
+static inline void ht_print(ht_t *ht)
 {
 	int i, j;
 
@@ -28,7 +28,7 @@ public:
 	const std::pair<V,bool> find(const int tid, const K& key);
 	int                     rangeQuery(const int tid,
 	                                   const K& lo, const K& hi,
-	                                   std::vector<std::pair<K,V>> kv_pairs);
+	                                   std::vector<std::pair<K,V>>& kv_pairs);
 
 	const V                 insert(const int tid, const K& key, const V& val);
 	const V                 insertIfAbsent(const int tid, const K& key,
@@ -47,11 +47,23 @@ public:
 
 	void print() { seq_ds->print(); }
 	unsigned long long size() { return seq_ds->size(); }
+	void memoryStats(MemoryStats *stats) { seq_ds->memoryStats(stats); }
+	void stats(MapStats *stats)
+	{
+		counters.add_to(stats);
+		seq_ds->stats(stats);
+	}
+
+	bool bulkLoad(const int tid, const std::vector<std::pair<K,V>>& kv_pairs)
+	{
+		return seq_ds->bulkLoad(tid, kv_pairs);
+	}
 
 private:
 	const int MAX_STACK_LEN = 64;
 	const int TX_NUM_RETRIES; //> FIXME
 	Map<K,V> *seq_ds;
+	MapCounters counters;
 	char padding[64];
 
 	pthread_spinlock_t updaters_lock;
@@ -67,6 +79,7 @@ private:
 			while (updaters_lock != LOCK_FREE) ;
 
 			tdata->tx_starts++;
+			counters.inc(tdata->tid, MAP_STAT_TX_STARTS);
 			status = TX_BEGIN(0);
 			if (status == TM_BEGIN_SUCCESS) {
 				if (updaters_lock != LOCK_FREE)
@@ -80,9 +93,11 @@ private:
 				return true;
 			} else {
 				tdata->tx_aborts++;
+				counters.inc(tdata->tid, MAP_STAT_TX_ABORTS);
 				if (ABORT_IS_EXPLICIT(status) && 
 				    ABORT_CODE(status) == ABORT_VALIDATION_FAILURE) {
 					tdata->tx_aborts_explicit_validation++;
+					counters.inc(tdata->tid, MAP_STAT_RESTARTS);
 					return false;
 				} else {
 					continue;
@@ -125,6 +140,7 @@ private:
 		//> ...otherwise fallback to the coarse-grained RCU
 		ht_reset(tdata->ht);
 		tdata->lacqs++;
+		counters.inc(tdata->tid, MAP_STAT_FALLBACKS);
 		pthread_spin_lock(&updaters_lock);
 		const V ret = seq_ds->traverse_with_stack(key, node_stack,
 		                                          node_stack_indexes, &stack_top);
@@ -176,6 +192,7 @@ private:
 		//> ...otherwise fallback to the coarse-grained RCU
 		ht_reset(tdata->ht);
 		tdata->lacqs++;
+		counters.inc(tdata->tid, MAP_STAT_FALLBACKS);
 		pthread_spin_lock(&updaters_lock);
 		const V ret = seq_ds->traverse_with_stack(key, node_stack,
 		                                          node_stack_indexes, &stack_top);
@@ -228,6 +245,7 @@ private:
 			//> ...otherwise fallback to the coarse-grained RCU
 			ht_reset(tdata->ht);
 			tdata->lacqs++;
+			counters.inc(tdata->tid, MAP_STAT_FALLBACKS);
 			pthread_spin_lock(&updaters_lock);
 			seq_ds->traverse_for_rebalance(key, &should_rebalance,
 			                               node_stack, node_stack_indexes,
@@ -266,7 +284,7 @@ const std::pair<V,bool> RCU_HTM_FUNCT::find(const int tid, const K& key)
 
 RCU_HTM_TEMPL
 int RCU_HTM_FUNCT::rangeQuery(const int tid, const K& lo, const K& hi,
-                      std::vector<std::pair<K,V>> kv_pairs)
+                      std::vector<std::pair<K,V>>& kv_pairs)
 {
 	return seq_ds->rangeQuery(tid, lo, hi, kv_pairs);
 }
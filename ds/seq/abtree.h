@@ -35,7 +35,7 @@ public:
 	const std::pair<V,bool> find(const int tid, const K& key);
 	int                     rangeQuery(const int tid,
 	                                   const K& lo, const K& hi,
-	                                   std::vector<std::pair<K,V>> kv_pairs);
+	                                   std::vector<std::pair<K,V>>& kv_pairs);
 
 	const V                 insert(const int tid, const K& key, const V& val);
 	const V                 insertIfAbsent(const int tid, const K& key,
@@ -51,6 +51,8 @@ public:
 private:
 
 	struct node_t {
+		NODE_ALLOCATOR_OPERATORS
+
 		bool leaf, tag;
 		int no_keys;
 
@@ -1195,9 +1197,9 @@ const std::pair<V,bool> ABTREE_FUNCT::find(const int tid, const K& key)
 
 ABTREE_TEMPL
 int ABTREE_FUNCT::rangeQuery(const int tid, const K& lo, const K& hi,
-                             std::vector<std::pair<K,V>> kv_pairs)
+                             std::vector<std::pair<K,V>>& kv_pairs)
 {
-	return 0;
+	return -1;
 }
 
 ABTREE_TEMPL
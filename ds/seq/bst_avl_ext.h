@@ -1,9 +1,13 @@
 /**
  * An external AVL tree.
+ * With COMPACT set, the child pointers are 32-bit arena offsets (CompactPtr)
+ * and the nodes are allocated in the NodeAllocator arena.
  **/
 
 #pragma once
 
+#include <type_traits>
+
 #include "../rcu-htm/ht.h"
 #include "../map_if.h"
 #include "Log.h"
@@ -14,12 +18,13 @@
 #define IS_EXTERNAL_NODE(node) \
     ( (node)->left == NULL && (node)->right == NULL )
 
-template <typename K, typename V>
+template <typename K, typename V, bool COMPACT = false>
 class bst_avl_ext : public Map<K,V> {
 public:
 	bst_avl_ext(const K _NO_KEY, const V _NO_VALUE, const int numProcesses)
 	  : Map<K,V>(_NO_KEY, _NO_VALUE)
 	{
+		if (COMPACT) NodeAllocator::require_arena();
 		root = NULL;
 	}
 
@@ -30,7 +35,7 @@ public:
 	const std::pair<V,bool> find(const int tid, const K& key);
 	int                     rangeQuery(const int tid,
 	                                   const K& lo, const K& hi,
-	                                   std::vector<std::pair<K,V>> kv_pairs);
+	                                   std::vector<std::pair<K,V>>& kv_pairs);
 
 	const V                 insert(const int tid, const K& key, const V& val);
 	const V                 insertIfAbsent(const int tid, const K& key,
@@ -38,20 +43,29 @@ public:
 	const std::pair<V,bool> remove(const int tid, const K& key);
 
 	bool  validate();
-	char *name() { return "BST AVL External"; }
+	char *name() {
+		if (COMPACT) return "BST AVL External (compact)";
+		return "BST AVL External";
+	}
 
 	void print() {};
 //	unsigned long long size() { return size_rec(root); };
 
 private:
 
+	struct node_t;
+	typedef typename std::conditional<COMPACT, CompactPtr<node_t>,
+	                                           node_t *>::type node_ptr_t;
+
 	struct node_t {
+		NODE_ALLOCATOR_OPERATORS
+
 		K key;
 		V value;
 	
 		int height;
 	
-		node_t *left, *right;
+		node_ptr_t left, right;
 //		char padding[32];
 
 		node_t(K key, V value) {
@@ -377,6 +391,24 @@ private:
 		}
 	}
 
+	//> Appends the pairs of the subtree with keys in [lo, hi] in key order.
+	//> Keys <= node->key are routed left, so a subtree is skipped when the
+	//> whole of it falls outside the range.
+	int range_query_rec(node_t *root, const K& lo, const K& hi,
+	                    std::vector<std::pair<K,V>>& kv_pairs)
+	{
+		if (root == NULL) return 0;
+		if (IS_EXTERNAL_NODE(root)) {
+			if (root->key < lo || hi < root->key) return 0;
+			kv_pairs.push_back(std::pair<K,V>(root->key, root->value));
+			return 1;
+		}
+		int nkeys = 0;
+		if (!(root->key < lo)) nkeys += range_query_rec(root->left, lo, hi, kv_pairs);
+		if (root->key < hi)    nkeys += range_query_rec(root->right, lo, hi, kv_pairs);
+		return nkeys;
+	}
+
 	int total_paths, total_nodes, bst_violations, avl_violations;
 	int min_path_len, max_path_len;
 	void validate_rec(node_t *root, int _th)
@@ -537,7 +569,7 @@ public:
 	
 		for (int i=0; i < HT_LEN; i++) {
 			for (int j=0; j < tdata->ht->bucket_next_index[i]; j+=2) {
-				node_t **np = (node_t **)tdata->ht->entries[i][j];
+				node_ptr_t *np = (node_ptr_t *)tdata->ht->entries[i][j];
 				node_t  *n  = (node_t *)tdata->ht->entries[i][j+1];
 				if (*np != n)
 					TX_ABORT(ABORT_VALIDATION_FAILURE);
@@ -791,8 +823,8 @@ public:
 	}
 };
 
-#define BST_AVL_EXT_TEMPL template<typename K, typename V>
-#define BST_AVL_EXT_FUNCT bst_avl_ext<K,V>
+#define BST_AVL_EXT_TEMPL template<typename K, typename V, bool COMPACT>
+#define BST_AVL_EXT_FUNCT bst_avl_ext<K,V,COMPACT>
 
 BST_AVL_EXT_TEMPL
 bool BST_AVL_EXT_FUNCT::contains(const int tid, const K& key)
@@ -810,9 +842,9 @@ const std::pair<V,bool> BST_AVL_EXT_FUNCT::find(const int tid, const K& key)
 
 BST_AVL_EXT_TEMPL
 int BST_AVL_EXT_FUNCT::rangeQuery(const int tid, const K& lo, const K& hi,
-                      std::vector<std::pair<K,V>> kv_pairs)
+                      std::vector<std::pair<K,V>>& kv_pairs)
 {
-	return 0;
+	return range_query_rec(root, lo, hi, kv_pairs);
 }
 
 BST_AVL_EXT_TEMPL
@@ -27,7 +27,7 @@ public:
 	const std::pair<V,bool> find(const int tid, const K& key);
 	int                     rangeQuery(const int tid,
 	                                   const K& lo, const K& hi,
-	                                   std::vector<std::pair<K,V>> kv_pairs);
+	                                   std::vector<std::pair<K,V>>& kv_pairs);
 
 	const V                 insert(const int tid, const K& key, const V& val);
 	const V                 insertIfAbsent(const int tid, const K& key,
@@ -43,6 +43,8 @@ public:
 private:
 
 	struct node_t {
+		NODE_ALLOCATOR_OPERATORS
+
 		K key;
 		V value;
 	
@@ -392,6 +394,21 @@ private:
 		}
 	}
 
+	//> Appends the pairs of the subtree with keys in [lo, hi] in key order.
+	int range_query_rec(node_t *root, const K& lo, const K& hi,
+	                    std::vector<std::pair<K,V>>& kv_pairs)
+	{
+		if (root == NULL) return 0;
+		int nkeys = 0;
+		if (lo < root->key) nkeys += range_query_rec(root->left, lo, hi, kv_pairs);
+		if (!(root->key < lo) && !(hi < root->key)) {
+			kv_pairs.push_back(std::pair<K,V>(root->key, root->value));
+			nkeys++;
+		}
+		if (root->key < hi) nkeys += range_query_rec(root->right, lo, hi, kv_pairs);
+		return nkeys;
+	}
+
 	int total_paths, total_nodes, bst_violations, avl_violations;
 	int min_path_len, max_path_len;
 	void validate_rec(node_t *root, int _th)
@@ -869,9 +886,9 @@ const std::pair<V,bool> BST_AVL_INT_FUNCT::find(const int tid, const K& key)
 
 BST_AVL_INT_TEMPL
 int BST_AVL_INT_FUNCT::rangeQuery(const int tid, const K& lo, const K& hi,
-                      std::vector<std::pair<K,V>> kv_pairs)
+                      std::vector<std::pair<K,V>>& kv_pairs)
 {
-	return 0;
+	return range_query_rec(root, lo, hi, kv_pairs);
 }
 
 BST_AVL_INT_TEMPL
@@ -1,9 +1,13 @@
 /**
  * An internal Red-Black tree
+ * With COMPACT set, the child pointers are 32-bit arena offsets (CompactPtr)
+ * and the nodes are allocated in the NodeAllocator arena.
  **/
 
 #pragma once
 
+#include <type_traits>
+
 #include "../map_if.h"
 #include "Log.h"
 
@@ -13,12 +17,13 @@
 #define IS_EXTERNAL_NODE(node) \
     ( (node)->left == NULL && (node)->right == NULL )
 
-template <typename K, typename V>
+template <typename K, typename V, bool COMPACT = false>
 class bst_rbt_ext : public Map<K,V> {
 public:
 	bst_rbt_ext(const K _NO_KEY, const V _NO_VALUE, const int numProcesses)
 	  : Map<K,V>(_NO_KEY, _NO_VALUE)
 	{
+		if (COMPACT) NodeAllocator::require_arena();
 		root = NULL;
 	}
 
@@ -29,7 +34,7 @@ public:
 	const std::pair<V,bool> find(const int tid, const K& key);
 	int                     rangeQuery(const int tid,
 	                                   const K& lo, const K& hi,
-	                                   std::vector<std::pair<K,V>> kv_pairs);
+	                                   std::vector<std::pair<K,V>>& kv_pairs);
 
 	const V                 insert(const int tid, const K& key, const V& val);
 	const V                 insertIfAbsent(const int tid, const K& key,
@@ -37,7 +42,10 @@ public:
 	const std::pair<V,bool> remove(const int tid, const K& key);
 
 	bool  validate();
-	char *name() { return "BST Red-Black External"; }
+	char *name() {
+		if (COMPACT) return "BST Red-Black External (compact)";
+		return "BST Red-Black External";
+	}
 
 	void print() { print_helper(); };
 //	unsigned long long size() { return size_rec(root); };
@@ -49,12 +57,18 @@ private:
 		BLACK
 	} color_t;
 
+	struct node_t;
+	typedef typename std::conditional<COMPACT, CompactPtr<node_t>,
+	                                           node_t *>::type node_ptr_t;
+
 	struct node_t {
+		NODE_ALLOCATOR_OPERATORS
+
 		K key;
 		V value;
 
 		color_t color;
-		node_t *left, *right;
+		node_ptr_t left, right;
 
 		node_t(K key, V value, color_t color) {
 			this->key = key;
@@ -453,6 +467,24 @@ private:
 
 	int key_in_min_path, key_in_max_path;
 	int bh;
+	//> Appends the pairs of the subtree with keys in [lo, hi] in key order.
+	//> Keys <= node->key are routed left, so a subtree is skipped when the
+	//> whole of it falls outside the range.
+	int range_query_rec(node_t *root, const K& lo, const K& hi,
+	                    std::vector<std::pair<K,V>>& kv_pairs)
+	{
+		if (root == NULL) return 0;
+		if (IS_EXTERNAL_NODE(root)) {
+			if (root->key < lo || hi < root->key) return 0;
+			kv_pairs.push_back(std::pair<K,V>(root->key, root->value));
+			return 1;
+		}
+		int nkeys = 0;
+		if (!(root->key < lo)) nkeys += range_query_rec(root->left, lo, hi, kv_pairs);
+		if (root->key < hi)    nkeys += range_query_rec(root->right, lo, hi, kv_pairs);
+		return nkeys;
+	}
+
 	int paths_with_bh_diff;
 	int total_paths;
 	int min_path_len, max_path_len;
@@ -578,8 +610,8 @@ private:
 
 };
 
-#define BST_RBT_EXT_TEMPL template<typename K, typename V>
-#define BST_RBT_EXT_FUNCT bst_rbt_ext<K,V>
+#define BST_RBT_EXT_TEMPL template<typename K, typename V, bool COMPACT>
+#define BST_RBT_EXT_FUNCT bst_rbt_ext<K,V,COMPACT>
 
 BST_RBT_EXT_TEMPL
 bool BST_RBT_EXT_FUNCT::contains(const int tid, const K& key)
@@ -597,9 +629,9 @@ const std::pair<V,bool> BST_RBT_EXT_FUNCT::find(const int tid, const K& key)
 
 BST_RBT_EXT_TEMPL
 int BST_RBT_EXT_FUNCT::rangeQuery(const int tid, const K& lo, const K& hi,
-                      std::vector<std::pair<K,V>> kv_pairs)
+                      std::vector<std::pair<K,V>>& kv_pairs)
 {
-	return 0;
+	return range_query_rec(root, lo, hi, kv_pairs);
 }
 
 BST_RBT_EXT_TEMPL
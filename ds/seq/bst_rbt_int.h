@@ -27,7 +27,7 @@ public:
 	const std::pair<V,bool> find(const int tid, const K& key);
 	int                     rangeQuery(const int tid,
 	                                   const K& lo, const K& hi,
-	                                   std::vector<std::pair<K,V>> kv_pairs);
+	                                   std::vector<std::pair<K,V>>& kv_pairs);
 
 	const V                 insert(const int tid, const K& key, const V& val);
 	const V                 insertIfAbsent(const int tid, const K& key,
@@ -48,6 +48,8 @@ private:
 	} color_t;
 
 	struct node_t {
+		NODE_ALLOCATOR_OPERATORS
+
 		K key;
 		V value;
 
@@ -313,6 +315,7 @@ private:
 	
 		if (original_node) {
 			original_node->key = leaf->key;
+			original_node->value = leaf->value;
 			*succ_key = leaf->key;
 		}
 	
@@ -454,6 +457,21 @@ private:
 		return del_val;
 	}
 
+	//> Appends the pairs of the subtree with keys in [lo, hi] in key order.
+	int range_query_rec(node_t *root, const K& lo, const K& hi,
+	                    std::vector<std::pair<K,V>>& kv_pairs)
+	{
+		if (root == NULL) return 0;
+		int nkeys = 0;
+		if (lo < root->key) nkeys += range_query_rec(root->left, lo, hi, kv_pairs);
+		if (!(root->key < lo) && !(hi < root->key)) {
+			kv_pairs.push_back(std::pair<K,V>(root->key, root->value));
+			nkeys++;
+		}
+		if (root->key < hi) nkeys += range_query_rec(root->right, lo, hi, kv_pairs);
+		return nkeys;
+	}
+
 	int key_in_min_path, key_in_max_path;
 	int bh;
 	int paths_with_bh_diff;
@@ -570,9 +588,9 @@ const std::pair<V,bool> BST_RBT_INT_FUNCT::find(const int tid, const K& key)
 
 BST_RBT_INT_TEMPL
 int BST_RBT_INT_FUNCT::rangeQuery(const int tid, const K& lo, const K& hi,
-                      std::vector<std::pair<K,V>> kv_pairs)
+                      std::vector<std::pair<K,V>>& kv_pairs)
 {
-	return 0;
+	return range_query_rec(root, lo, hi, kv_pairs);
 }
 
 BST_RBT_INT_TEMPL
@@ -1,19 +1,24 @@
 /**
  * An external (unbalanced) binary search tree.
+ * With COMPACT set, the child pointers are 32-bit arena offsets (CompactPtr)
+ * and the nodes are allocated in the NodeAllocator arena.
  **/
 
 #pragma once
 
+#include <type_traits>
+
 #include "../rcu-htm/ht.h"
 #include "../map_if.h"
 #include "Log.h"
 
-template <typename K, typename V>
+template <typename K, typename V, bool COMPACT = false>
 class bst_unb_ext : public Map<K,V> {
 public:
 	bst_unb_ext(const K _NO_KEY, const V _NO_VALUE, const int numProcesses)
 	  : Map<K,V>(_NO_KEY, _NO_VALUE)
 	{
+		if (COMPACT) NodeAllocator::require_arena();
 		root = NULL;
 	}
 
@@ -24,7 +29,7 @@ public:
 	const std::pair<V,bool> find(const int tid, const K& key);
 	int                     rangeQuery(const int tid,
 	                                   const K& lo, const K& hi,
-	                                   std::vector<std::pair<K,V>> kv_pairs);
+	                                   std::vector<std::pair<K,V>>& kv_pairs);
 
 	const V                 insert(const int tid, const K& key, const V& val);
 	const V                 insertIfAbsent(const int tid, const K& key,
@@ -32,23 +37,34 @@ public:
 	const std::pair<V,bool> remove(const int tid, const K& key);
 
 	bool  validate();
-	char *name() { return "BST Unbalanced External"; }
+	char *name() {
+		if (COMPACT) return "BST Unbalanced External (compact)";
+		return "BST Unbalanced External";
+	}
+
+	bool bulkLoad(const int tid, const std::vector<std::pair<K,V>>& kv_pairs);
 
 	void print();
 	unsigned long long size() { return size_rec(root); };
+	void memoryStats(MemoryStats *stats);
 
 private:
 
-	typedef bst_unb_ext<K, V> tree_t;
+	typedef bst_unb_ext<K, V, COMPACT> tree_t;
+
+	struct node_t;
+	typedef typename std::conditional<COMPACT, CompactPtr<node_t>,
+	                                           node_t *>::type node_ptr_t;
 
 	struct node_t {
+		NODE_ALLOCATOR_OPERATORS
 
 		#define IS_EXTERNAL_NODE(node) \
 		        ( (node)->left == NULL && (node)->right == NULL )
 
 		K key;
 		V value;
-		node_t *left, *right;
+		node_ptr_t left, right;
 
 		node_t (const K& key_, const V& value_) :
 		     key(key_), value(value_),
@@ -192,7 +208,7 @@ public:
 	
 		for (int i=0; i < HT_LEN; i++) {
 			for (int j=0; j < tdata->ht->bucket_next_index[i]; j+=2) {
-				node_t **np = (node_t **)tdata->ht->entries[i][j];
+				node_ptr_t *np = (node_ptr_t *)tdata->ht->entries[i][j];
 				node_t  *n  = (node_t *)tdata->ht->entries[i][j+1];
 				if (*np != n)
 					TX_ABORT(ABORT_VALIDATION_FAILURE);
@@ -277,10 +293,33 @@ private:
 	int update_helper(const K& key, const V& value);
 
 	int validate_helper(bool print);
+	//> Appends the pairs of the subtree with keys in [lo, hi] in key order.
+	//> Keys <= node->key are routed left, so a subtree is skipped when the
+	//> whole of it falls outside the range.
+	int range_query_rec(node_t *root, const K& lo, const K& hi,
+	                    std::vector<std::pair<K,V>>& kv_pairs)
+	{
+		if (root == NULL) return 0;
+		if (IS_EXTERNAL_NODE(root)) {
+			if (root->key < lo || hi < root->key) return 0;
+			kv_pairs.push_back(std::pair<K,V>(root->key, root->value));
+			return 1;
+		}
+		int nkeys = 0;
+		if (!(root->key < lo)) nkeys += range_query_rec(root->left, lo, hi, kv_pairs);
+		if (root->key < hi)    nkeys += range_query_rec(root->right, lo, hi, kv_pairs);
+		return nkeys;
+	}
+
 	void validate_rec(node_t *root, int _th);
 
+	node_t *bulk_load_rec(const std::vector<std::pair<K,V>>& kv_pairs,
+	                      long long lo, long long hi);
+
 	void print_rec(node_t *root, int level);
 	unsigned long long size_rec(node_t *root);
+	void memory_stats_rec(node_t *root, unsigned long long *internal,
+	                      unsigned long long *external);
 
 private:
 
@@ -290,8 +329,8 @@ private:
 
 };
 
-#define BST_UNB_EXT_TEMPL template<typename K, typename V>
-#define BST_UNB_EXT_FUNCT bst_unb_ext<K,V>
+#define BST_UNB_EXT_TEMPL template<typename K, typename V, bool COMPACT>
+#define BST_UNB_EXT_FUNCT bst_unb_ext<K,V,COMPACT>
 
 BST_UNB_EXT_TEMPL
 bool BST_UNB_EXT_FUNCT::contains(const int tid, const K& key)
@@ -309,9 +348,9 @@ const std::pair<V,bool> BST_UNB_EXT_FUNCT::find(const int tid, const K& key)
 
 BST_UNB_EXT_TEMPL
 int BST_UNB_EXT_FUNCT::rangeQuery(const int tid, const K& lo, const K& hi,
-                      std::vector<std::pair<K,V>> kv_pairs)
+                      std::vector<std::pair<K,V>>& kv_pairs)
 {
-	return 0;
+	return range_query_rec(root, lo, hi, kv_pairs);
 }
 
 BST_UNB_EXT_TEMPL
@@ -339,6 +378,35 @@ bool BST_UNB_EXT_FUNCT::validate()
 	return validate(true);
 }
 
+BST_UNB_EXT_TEMPL
+bool BST_UNB_EXT_FUNCT::bulkLoad(const int tid,
+                                 const std::vector<std::pair<K,V>>& kv_pairs)
+{
+	if (root != NULL) return false;
+	if (kv_pairs.empty()) return true;
+	root = bulk_load_rec(kv_pairs, 0, kv_pairs.size() - 1);
+	return true;
+}
+
+/**
+ * Builds a perfectly balanced external tree out of kv_pairs[lo..hi].
+ * Each internal node holds the maximum key of its left subtree.
+ **/
+BST_UNB_EXT_TEMPL
+typename BST_UNB_EXT_FUNCT::node_t *BST_UNB_EXT_FUNCT::bulk_load_rec(
+                                 const std::vector<std::pair<K,V>>& kv_pairs,
+                                 long long lo, long long hi)
+{
+	if (lo == hi)
+		return new node_t(kv_pairs[lo].first, kv_pairs[lo].second);
+
+	long long mid = lo + (hi - lo) / 2;
+	node_t *internal = new node_t(kv_pairs[mid].first, this->NO_VALUE);
+	internal->left = bulk_load_rec(kv_pairs, lo, mid);
+	internal->right = bulk_load_rec(kv_pairs, mid + 1, hi);
+	return internal;
+}
+
 /**
  * Traverses the tree `bst` as dictated by `key`.
  * When returning, `leaf` is either NULL (empty tree) or the last node in the
@@ -511,6 +579,30 @@ unsigned long long BST_UNB_EXT_FUNCT::size_rec(node_t *root)
 	else return size_rec(root->left) + size_rec(root->right);
 }
 
+BST_UNB_EXT_TEMPL
+void BST_UNB_EXT_FUNCT::memory_stats_rec(node_t *root, unsigned long long *internal,
+                                         unsigned long long *external)
+{
+	if (root == NULL) return;
+	if (IS_EXTERNAL_NODE(root)) {
+		(*external)++;
+		return;
+	}
+	(*internal)++;
+	memory_stats_rec(root->left, internal, external);
+	memory_stats_rec(root->right, internal, external);
+}
+
+BST_UNB_EXT_TEMPL
+void BST_UNB_EXT_FUNCT::memoryStats(MemoryStats *stats)
+{
+	unsigned long long internal = 0, external = 0;
+	memory_stats_rec(root, &internal, &external);
+	stats->add_nodes("internal", sizeof(node_t), internal);
+	stats->add_nodes("external", sizeof(node_t), external);
+	stats->add_keys(external);
+}
+
 BST_UNB_EXT_TEMPL
 void BST_UNB_EXT_FUNCT::validate_rec(node_t *root, int _th)
 {
@@ -24,7 +24,7 @@ public:
 	const std::pair<V,bool> find(const int tid, const K& key);
 	int                     rangeQuery(const int tid,
 	                                   const K& lo, const K& hi,
-	                                   std::vector<std::pair<K,V>> kv_pairs);
+	                                   std::vector<std::pair<K,V>>& kv_pairs);
 
 	const V                 insert(const int tid, const K& key, const V& val);
 	const V                 insertIfAbsent(const int tid, const K& key,
@@ -36,12 +36,20 @@ public:
 
 	void print();
 	unsigned long long size() { return size_rec(root); };
+	void memoryStats(MemoryStats *stats)
+	{
+		unsigned long long nodes = size_rec(root);
+		stats->add_nodes("node", sizeof(node_t), nodes);
+		stats->add_keys(nodes);
+	}
 
 private:
 
 	typedef bst_unb_int<K, V> tree_t;
 
 	struct node_t {
+		NODE_ALLOCATOR_OPERATORS
+
 		K key;
 		V value;
 		node_t *left, *right;
@@ -348,6 +356,21 @@ private:
 	int update_helper(const K& key, const V& value);
 
 	int validate_helper(bool print);
+	//> Appends the pairs of the subtree with keys in [lo, hi] in key order.
+	int range_query_rec(node_t *root, const K& lo, const K& hi,
+	                    std::vector<std::pair<K,V>>& kv_pairs)
+	{
+		if (root == NULL) return 0;
+		int nkeys = 0;
+		if (lo < root->key) nkeys += range_query_rec(root->left, lo, hi, kv_pairs);
+		if (!(root->key < lo) && !(hi < root->key)) {
+			kv_pairs.push_back(std::pair<K,V>(root->key, root->value));
+			nkeys++;
+		}
+		if (root->key < hi) nkeys += range_query_rec(root->right, lo, hi, kv_pairs);
+		return nkeys;
+	}
+
 	void validate_rec(node_t *root, int _th);
 
 	void print_rec(node_t *root, int level);
@@ -373,9 +396,9 @@ const std::pair<V,bool> FUNCT::find(const int tid, const K& key)
 
 TEMPL
 int FUNCT::rangeQuery(const int tid, const K& lo, const K& hi,
-                      std::vector<std::pair<K,V>> kv_pairs)
+                      std::vector<std::pair<K,V>>& kv_pairs)
 {
-	return 0;
+	return range_query_rec(root, lo, hi, kv_pairs);
 }
 
 TEMPL
@@ -24,7 +24,7 @@ public:
 	const std::pair<V,bool> find(const int tid, const K& key);
 	int                     rangeQuery(const int tid,
 	                                   const K& lo, const K& hi,
-	                                   std::vector<std::pair<K,V>> kv_pairs);
+	                                   std::vector<std::pair<K,V>>& kv_pairs);
 
 	const V                 insert(const int tid, const K& key, const V& val);
 	const V                 insertIfAbsent(const int tid, const K& key,
@@ -36,12 +36,22 @@ public:
 
 	void print() { print_helper(); };
 	unsigned long long size() { return size_rec(root); };
+	void memoryStats(MemoryStats *stats)
+	{
+		unsigned long long marked = 0, unmarked = 0;
+		memory_stats_rec(root, &marked, &unmarked);
+		stats->add_nodes("node", sizeof(node_t), unmarked);
+		stats->add_nodes("marked node", sizeof(node_t), marked);
+		stats->add_keys(unmarked);
+	}
 
 private:
 
 	typedef bst_unb_pext<K, V> tree_t;
 
 	struct node_t {
+		NODE_ALLOCATOR_OPERATORS
+
 		K key;
 		V value;
 		node_t *left, *right;
@@ -177,6 +187,16 @@ public:
 		return size_rec(n->left) + (n->marked ? 0 : 1) + size_rec(n->right);
 	}
 
+	void memory_stats_rec(node_t *n, unsigned long long *marked,
+	                      unsigned long long *unmarked)
+	{
+		if (n == NULL) return;
+		if (n->marked) (*marked)++;
+		else           (*unmarked)++;
+		memory_stats_rec(n->left, marked, unmarked);
+		memory_stats_rec(n->right, marked, unmarked);
+	}
+
 public:
 	/**
 	 * RCU-HTM adapting methods.
@@ -528,9 +548,9 @@ const std::pair<V,bool> BST_UNB_PEXT_FUNCT::find(const int tid, const K& key)
 
 BST_UNB_PEXT_TEMPL
 int BST_UNB_PEXT_FUNCT::rangeQuery(const int tid, const K& lo, const K& hi,
-                      std::vector<std::pair<K,V>> kv_pairs)
+                      std::vector<std::pair<K,V>>& kv_pairs)
 {
-	return 0;
+	return -1;
 }
 
 BST_UNB_PEXT_TEMPL
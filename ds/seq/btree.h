@@ -16,7 +16,7 @@
 template <typename K, typename V>
 class btree : public Map<K,V> {
 private:
-	static const unsigned int NODE_ORDER = 8;
+	static const int NODE_ORDER = 8;
 
 public:
 	btree(const K _NO_KEY, const V _NO_VALUE, const int numProcesses)
@@ -32,7 +32,7 @@ public:
 	const std::pair<V,bool> find(const int tid, const K& key);
 	int                     rangeQuery(const int tid,
 	                                   const K& lo, const K& hi,
-	                                   std::vector<std::pair<K,V>> kv_pairs);
+	                                   std::vector<std::pair<K,V>>& kv_pairs);
 
 	const V                 insert(const int tid, const K& key, const V& val);
 	const V                 insertIfAbsent(const int tid, const K& key,
@@ -48,6 +48,8 @@ public:
 private:
 
 	struct node_t {
+		NODE_ALLOCATOR_OPERATORS
+
 		bool leaf;
 	
 		int no_keys;
@@ -940,9 +942,9 @@ const std::pair<V,bool> BTREE_FUNCT::find(const int tid, const K& key)
 
 BTREE_TEMPL
 int BTREE_FUNCT::rangeQuery(const int tid, const K& lo, const K& hi,
-                      std::vector<std::pair<K,V>> kv_pairs)
+                      std::vector<std::pair<K,V>>& kv_pairs)
 {
-	return 0;
+	return -1;
 }
 
 BTREE_TEMPL
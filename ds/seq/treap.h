@@ -21,6 +21,8 @@ public:
 template<typename K>
 class TreapNodeInternal : TreapNode<K> {
 public:
+	NODE_ALLOCATOR_OPERATORS
+
 	K key;
 	unsigned long long weight;
 	TreapNode<K> *left,
@@ -47,6 +49,8 @@ private:
 	typedef TreapNodeExternal<K, V, DEGREE> node_external_t;
 
 public:
+	NODE_ALLOCATOR_OPERATORS
+
 	int nr_keys;
 	K keys[DEGREE];
 	V values[DEGREE];
@@ -194,7 +198,7 @@ public:
 	bool contains(const int tid, const K& key);
 	const std::pair<V,bool> find(const int tid, const K& key);
 	int rangeQuery(const int tid, const K& key1, const K& key2,
-	               std::vector<std::pair<K,V>> kv_pairs);
+	               std::vector<std::pair<K,V>>& kv_pairs);
 
 	const V insert(const int tid, const K& key, const V& val);
 	const V insertIfAbsent(const int tid, const K& key, const V& val);
@@ -208,6 +212,13 @@ public:
 	bool validate(bool print);
 
 	unsigned long long size() { return size_rec(root); }
+	void memoryStats(MemoryStats *stats)
+	{
+		unsigned long long internal = 0, external = 0;
+		stats->add_keys(memory_stats_rec(root, &internal, &external));
+		stats->add_nodes("internal", sizeof(node_internal_t), internal);
+		stats->add_nodes("external", sizeof(node_external_t), external);
+	}
 	bool is_empty() { return root == NULL; }
 	long long get_key_sum() { return get_key_sum_rec(root); }
 
@@ -218,12 +229,14 @@ private:
 		if (node->is_internal()) {
 			node_internal_t *internal = (node_internal_t *)node;
 			print_rec(internal->right, level+1);
-			for (int i=0; i < level; i++) printf("-"); printf("> ");
+			for (int i=0; i < level; i++) printf("-");
+			printf("> ");
 			internal->print();
 			print_rec(internal->left, level+1);
 		} else {
 			node_external_t *external = (node_external_t *)node;
-			for (int i=0; i < level; i++) printf("-"); printf("> ");
+			for (int i=0; i < level; i++) printf("-");
+			printf("> ");
 			external->print();
 		}
 	}
@@ -244,6 +257,23 @@ private:
 		}
 	}
 
+	//> Returns the number of keys under `root`.
+	unsigned long long memory_stats_rec(node_t *root, unsigned long long *internal,
+	                                    unsigned long long *external)
+	{
+		if (!root) return 0;
+
+		if (root->is_internal()) {
+			node_internal_t *n = (node_internal_t *)root;
+			(*internal)++;
+			return memory_stats_rec(n->left, internal, external) +
+			       memory_stats_rec(n->right, internal, external);
+		} else {
+			(*external)++;
+			return ((node_external_t *)root)->nr_keys;
+		}
+	}
+
 	long long get_key_sum_rec(node_t *n)
 	{
 		node_internal_t *internal;
@@ -521,7 +551,7 @@ const std::pair<V,bool> TREAP::find(const int tid, const K& key)
 
 TREAP_TEMPLATE
 int TREAP::rangeQuery(const int tid, const K& key1, const K& key2,
-                      std::vector<std::pair<K,V>> kv_pairs)
+                      std::vector<std::pair<K,V>>& kv_pairs)
 {
 	node_t *curr, *prev = NULL;
 	node_external_t *external;
@@ -562,7 +592,9 @@ int TREAP::rangeQuery(const int tid, const K& key1, const K& key2,
 			       (external->keys[key_index] == key2 ||
 			        external->keys[key_index] < key2)) {
 				kv_pairs.push_back(std::pair<K,V>(external->keys[key_index],
-				                                  external->values[key_index++]));
+				                                  external->values[key_index]));
+				key_index++;
+				nkeys++;
 			}
 			if (key_index < external->nr_keys)
 				break;
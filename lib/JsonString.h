@@ -0,0 +1,39 @@
+#pragma once
+
+#include <stdio.h>
+#include <string>
+
+/**
+ * A string as a quoted JSON string, for the results files of the benchmarks:
+ * quotes, backslashes and control characters (e.g., in a file name or in a
+ * parameter given on the command line) are escaped. Used as
+ *   fprintf(fp, "\"name\": %s", json_string(name).c_str());
+ **/
+static inline std::string json_string(const char *s)
+{
+	std::string ret = "\"";
+	for (; s && *s; s++) {
+		unsigned char c = *s;
+		switch (c) {
+		case '"':  ret += "\\\""; break;
+		case '\\': ret += "\\\\"; break;
+		case '\n': ret += "\\n";  break;
+		case '\r': ret += "\\r";  break;
+		case '\t': ret += "\\t";  break;
+		default:
+			if (c < 0x20) {
+				char buf[8];
+				snprintf(buf, sizeof(buf), "\\u%04x", c);
+				ret += buf;
+			} else {
+				ret += c;
+			}
+		}
+	}
+	return ret + "\"";
+}
+
+static inline std::string json_string(const std::string& s)
+{
+	return json_string(s.c_str());
+}
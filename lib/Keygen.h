@@ -12,6 +12,7 @@
  **/
 class KeyGenerator {
 public:
+	virtual ~KeyGenerator() {}
 	virtual uint64_t next() = 0;
 };
 
@@ -99,3 +100,81 @@ private:
 	double alpha;
 	uint64_t max_key;
 };
+
+/**
+ * Zipfian keys in O(1) per key, with the method of Gray et al. ("Quickly
+ * generating billion-record synthetic databases", SIGMOD 1994), as in YCSB.
+ * Key 0 is the most popular one. `theta` must be in (0,1). The O(max_key)
+ * zeta constant can be computed once with zeta() and passed to all the
+ * generators that share the same max_key and theta.
+ **/
+class KeyGeneratorZipfFast : public KeyGenerator {
+public:
+	KeyGeneratorZipfFast(uint64_t seed, uint64_t max_key, double theta,
+	                     double zetan = 0)
+	{
+		assert(theta > 0 && theta < 1);
+		this->rng.set_seed(seed);
+		this->max_key = max_key;
+		this->theta = theta;
+		this->zetan = (zetan > 0) ? zetan : zeta(max_key, theta);
+		this->alpha = 1.0 / (1.0 - theta);
+		this->eta = (1.0 - pow(2.0 / max_key, 1.0 - theta)) /
+		            (1.0 - zeta(2, theta) / this->zetan);
+	}
+
+	static double zeta(uint64_t n, double theta)
+	{
+		double sum = 0;
+		for (uint64_t i=1; i <= n; i++)
+			sum += 1.0 / pow((double)i, theta);
+		return sum;
+	}
+
+	uint64_t next()
+	{
+		double u = (rng.next() >> 11) * (1.0 / 9007199254740992.0);
+		double uz = u * zetan;
+
+		if (uz < 1.0) return 0;
+		if (uz < 1.0 + pow(0.5, theta)) return 1;
+		uint64_t ret = (uint64_t)(max_key * pow(eta * u - eta + 1.0, alpha));
+		return (ret < max_key) ? ret : max_key - 1;
+	}
+
+private:
+	RandomFNV1A rng;
+	uint64_t max_key;
+	double theta, zetan, alpha, eta;
+};
+
+/**
+ * Hotspot keys: `hot_ops` of the keys (a fraction in [0,1]) are drawn
+ * uniformly from the first `hot_keys` fraction of the key space and the rest
+ * uniformly from the remaining keys.
+ **/
+class KeyGeneratorHotspot : public KeyGenerator {
+public:
+	KeyGeneratorHotspot(uint64_t seed, uint64_t max_key, double hot_keys,
+	                    double hot_ops)
+	{
+		assert(hot_keys >= 0 && hot_keys <= 1 && hot_ops >= 0 && hot_ops <= 1);
+		this->rng.set_seed(seed);
+		this->max_key = max_key;
+		this->hot_max = (uint64_t)(hot_keys * max_key);
+		if (this->hot_max == 0) this->hot_max = 1;
+		if (this->hot_max > max_key) this->hot_max = max_key;
+		this->hot_threshold = (uint64_t)(hot_ops * (double)UINT32_MAX);
+	}
+
+	uint64_t next()
+	{
+		bool hot = (rng.next() & UINT32_MAX) < hot_threshold;
+		if (hot || hot_max == max_key) return rng.next(hot_max);
+		return hot_max + rng.next(max_key - hot_max);
+	}
+
+private:
+	RandomFNV1A rng;
+	uint64_t max_key, hot_max, hot_threshold;
+};
@@ -0,0 +1,111 @@
+#pragma once
+
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+
+#include "Log.h"
+
+/**
+ * Internal events of a data structure, as filled in by Map::stats().
+ *
+ * A data structure that counts its events keeps a MapCounters, i.e., one
+ * cache-line-padded set of counters per thread that only the thread itself
+ * increments, and adds them up to a MapStats when asked. The events are only
+ * counted on the slow paths (failed CAS, retry, help, ...), so the counters
+ * cost nothing on the common path.
+ **/
+enum map_stat_t {
+	MAP_STAT_CAS_FAILURES = 0, //> CASes that failed
+	MAP_STAT_RESTARTS,         //> Operations restarted (e.g., from the root)
+	MAP_STAT_HELPS,            //> Helping of other threads' pending operations
+	MAP_STAT_REBUILDS,         //> Subtree rebuilds
+	MAP_STAT_SPLITS,           //> Node/partition splits
+	MAP_STAT_JOINS,            //> Node/partition joins
+	MAP_STAT_TX_STARTS,        //> Hardware transactions started
+	MAP_STAT_TX_ABORTS,        //> Hardware transactions aborted
+	MAP_STAT_FALLBACKS,        //> Operations that took the fallback (e.g., lock) path
+	MAP_NR_STATS
+};
+
+//> The thread ids that a MapCounters has slots for, i.e., 0 to
+//> MAP_STATS_MAX_THREADS-1. The benchmarks reject runs with more threads.
+#ifndef MAP_STATS_MAX_THREADS
+#	define MAP_STATS_MAX_THREADS 256
+#endif
+
+class MapStats {
+public:
+	unsigned long long counts[MAP_NR_STATS];
+
+	MapStats() { memset(counts, 0, sizeof(counts)); }
+
+	static const char *name(int stat)
+	{
+		static const char *names[MAP_NR_STATS] = {
+			"cas_failures", "restarts", "helps", "rebuilds", "splits", "joins",
+			"tx_starts", "tx_aborts", "fallbacks"
+		};
+		return names[stat];
+	}
+
+	void subtract(const MapStats& other)
+	{
+		for (int s=0; s < MAP_NR_STATS; s++)
+			counts[s] -= other.counts[s];
+	}
+
+	bool empty()
+	{
+		for (int s=0; s < MAP_NR_STATS; s++)
+			if (counts[s] > 0) return false;
+		return true;
+	}
+
+	//> Prints the events that happened, also per operation.
+	void print(unsigned long long nr_operations)
+	{
+		if (empty()) {
+			log_info("  No internal events counted by this data structure\n");
+			return;
+		}
+		for (int s=0; s < MAP_NR_STATS; s++)
+			if (counts[s] > 0)
+				log_info("  %-14s %14llu (%.4lf per op)\n", name(s), counts[s],
+				         nr_operations ? (double)counts[s] / nr_operations : 0.0);
+	}
+};
+
+class MapCounters {
+public:
+	MapCounters()
+	{
+		threads = (thread_counters_t *)aligned_alloc(64,
+		                      MAP_STATS_MAX_THREADS * sizeof(thread_counters_t));
+		memset(threads, 0, MAP_STATS_MAX_THREADS * sizeof(thread_counters_t));
+	}
+	~MapCounters() { free(threads); }
+
+	inline void inc(int tid, map_stat_t stat, unsigned long long n = 1)
+	{
+		assert(tid >= 0 && tid < MAP_STATS_MAX_THREADS);
+		threads[tid].counts[stat] += n;
+	}
+
+	void add_to(MapStats *stats)
+	{
+		for (int t=0; t < MAP_STATS_MAX_THREADS; t++)
+			for (int s=0; s < MAP_NR_STATS; s++)
+				stats->counts[s] += threads[t].counts[s];
+	}
+
+private:
+	struct thread_counters_t {
+		unsigned long long counts[MAP_NR_STATS];
+	} __attribute__((aligned(64)));
+
+	thread_counters_t *threads;
+
+	MapCounters(const MapCounters&);
+	MapCounters& operator=(const MapCounters&);
+};
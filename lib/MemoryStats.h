@@ -0,0 +1,94 @@
+#pragma once
+
+#include <string.h>
+#include <vector>
+
+#include "Log.h"
+#include "NodeAllocator.h"
+
+/**
+ * The memory footprint of a map, as filled in by Map::memoryStats().
+ *
+ * The data structure walks the nodes that are reachable from its root and
+ * adds them by type, together with the number of keys it holds. The node
+ * allocator knows how many bytes of nodes are live, i.e., allocated and not
+ * yet freed. Most of the data structures here never free the nodes they
+ * unlink (the concurrent ones have no memory reclamation) and RCU-HTM does
+ * not free the nodes it replaces with copies, so the live bytes that are not
+ * reachable are the ones that have been retired but not freed.
+ **/
+class MemoryStats {
+public:
+	struct node_type_t {
+		const char *name;
+		size_t size;
+		unsigned long long count;
+	};
+
+	std::vector<node_type_t> node_types;
+	unsigned long long keys;
+
+	MemoryStats() { keys = 0; }
+
+	//> Accounts for `count` reachable nodes of type `name`, `size` bytes each.
+	void add_nodes(const char *name, size_t size, unsigned long long count)
+	{
+		for (size_t i=0; i < node_types.size(); i++) {
+			if (!strcmp(node_types[i].name, name) && node_types[i].size == size) {
+				node_types[i].count += count;
+				return;
+			}
+		}
+		node_types.push_back({ name, size, count });
+	}
+
+	void add_keys(unsigned long long count) { keys += count; }
+
+	//> Whether the data structure walked its nodes, i.e., whether the
+	//> reachable and retired bytes are known.
+	bool walked() { return !node_types.empty(); }
+
+	unsigned long long reachable_bytes()
+	{
+		unsigned long long bytes = 0;
+		for (size_t i=0; i < node_types.size(); i++)
+			bytes += node_types[i].size * node_types[i].count;
+		return bytes;
+	}
+
+	unsigned long long allocated_bytes() { return NodeAllocator::live_bytes(); }
+
+	unsigned long long retired_bytes()
+	{
+		unsigned long long allocated = allocated_bytes(), reachable = reachable_bytes();
+		return (allocated > reachable) ? allocated - reachable : 0;
+	}
+
+	double bytes_per_key()
+	{
+		return (keys > 0) ? (double)allocated_bytes() / keys : 0.0;
+	}
+
+	void print()
+	{
+		log_info("Memory footprint\n");
+		log_info("=======================\n");
+		for (size_t i=0; i < node_types.size(); i++)
+			log_info("  %-20s %12llu x %4zu bytes = %10.2lf MB\n",
+			         node_types[i].name, node_types[i].count, node_types[i].size,
+			         node_types[i].count * node_types[i].size / (1024.0 * 1024.0));
+		log_info("  Keys: %llu\n", keys);
+		log_info("  Allocated (live) bytes: %llu (%.2lf MB, %llu blocks)\n",
+		         allocated_bytes(), allocated_bytes() / (1024.0 * 1024.0),
+		         NodeAllocator::live_blocks());
+		if (walked()) {
+			log_info("  Reachable bytes: %llu (%.2lf MB)\n", reachable_bytes(),
+			         reachable_bytes() / (1024.0 * 1024.0));
+			log_info("  Retired but not freed bytes: %llu (%.2lf MB)\n",
+			         retired_bytes(), retired_bytes() / (1024.0 * 1024.0));
+		} else {
+			log_info("  Reachable and retired bytes are not reported by this data structure\n");
+		}
+		log_info("  Bytes per key: %.2lf\n", bytes_per_key());
+	}
+};
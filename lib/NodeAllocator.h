@@ -0,0 +1,576 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <assert.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <atomic>
+#include <algorithm>
+#include <mutex>
+#include <new>
+
+#include "Log.h"
+
+/**
+ * The allocator that is used for the nodes of all the data structures in ds/.
+ * Each node struct includes NODE_ALLOCATOR_OPERATORS so that every `new`
+ * and `delete` of a node goes through NodeAllocator::alloc() and
+ * NodeAllocator::free().
+ *
+ * The placement policy is selected once, before the map is created:
+ *   - malloc:      plain ::operator new (the default, no NUMA awareness)
+ *   - first-touch: nodes come from 2MB chunks owned by the allocating thread,
+ *                  so each page lands on the socket of the thread that
+ *                  allocated (and first touched) it
+ *   - interleave:  chunks are interleaved page by page across all NUMA nodes
+ *   - per-socket:  one arena per NUMA node, a thread always gets its chunks
+ *                  from the arena of the socket it runs on
+ *
+ * All the non-malloc policies carve chunks out of a single virtual address
+ * range that is reserved at startup. The chunks of the different arenas are
+ * striped over the lower part of the range, so the range fills up from its
+ * start whatever the policy is; allocations larger than a chunk come from its
+ * upper quarter. Freed nodes go to a per-thread free list of their size class
+ * and are reused by the same thread.
+ *
+ * The arena chunks can also be backed by 2MB huge pages, to cut down the dTLB
+ * misses of traversals on large trees:
+ *   - thp:       transparent huge pages, requested with madvise(MADV_HUGEPAGE)
+ *   - hugetlbfs: pages from the preallocated hugetlbfs pool (MAP_HUGETLB),
+ *                falls back to small pages when the pool is empty
+ * Huge pages need the arena, so with the malloc policy they imply first-touch.
+ * The raw syscalls are used so that libnuma is not needed.
+ *
+ * Since arena addresses are close to each other, a node pointer can also be
+ * stored as a 32-bit offset from the arena start (see compress() and
+ * CompactPtr below), which is what the compact node layouts use. Their nodes
+ * must stay within the reach of the offsets, so once a compact layout is in
+ * use the allocator exits instead of falling back to malloc.
+ *
+ * With count_live() every thread also counts the bytes and blocks it
+ * allocates and frees, so live_bytes() and live_blocks() report the node
+ * memory that is currently in use (see MemoryStats.h).
+ **/
+
+#define NODE_ALLOCATOR_OPERATORS \
+	static void *operator new(size_t sz) { return NodeAllocator::alloc(sz); } \
+	static void operator delete(void *p, size_t sz) { NodeAllocator::free(p, sz); }
+
+#ifndef NODE_ALLOCATOR_VA_SZ
+#	define NODE_ALLOCATOR_VA_SZ (1ULL << 40)
+#endif
+#define NODE_ALLOCATOR_CHUNK_SZ (2ULL << 20)
+//> Blocks are 8-byte aligned, and 16-byte aligned if their size is a
+//> multiple of 16 (e.g., for cmpxchg16b).
+#define NODE_ALLOCATOR_ALIGN 8
+#define NODE_ALLOCATOR_MAX_SMALL 4096
+#define NODE_ALLOCATOR_MAX_NUMA_NODES 64
+#define NODE_ALLOCATOR_PAGE_SZ 4096
+//> Max pages that are queried when reporting the distribution
+#define NODE_ALLOCATOR_MAX_SAMPLED_PAGES (1 << 16)
+
+class NodeAllocator {
+public:
+	enum policy_t {
+		POLICY_MALLOC = 0,
+		POLICY_FIRST_TOUCH,
+		POLICY_INTERLEAVE,
+		POLICY_PER_SOCKET
+	};
+
+	enum pages_t {
+		PAGES_SMALL = 0,
+		PAGES_THP,
+		PAGES_HUGETLBFS
+	};
+
+	//> Must be called before set_policy().
+	//> Returns false if `name` is not a known page mode.
+	static bool set_pages(const char *name)
+	{
+		global_t& g = global();
+		if      (!strcmp(name, "small"))     g.pages = PAGES_SMALL;
+		else if (!strcmp(name, "thp"))       g.pages = PAGES_THP;
+		else if (!strcmp(name, "hugetlbfs")) g.pages = PAGES_HUGETLBFS;
+		else return false;
+		return true;
+	}
+
+	//> Must be called before any node is allocated.
+	//> Returns false if `name` is not a known policy.
+	static bool set_policy(const char *name)
+	{
+		global_t& g = global();
+		policy_t policy;
+
+		if      (!strcmp(name, "malloc"))      policy = POLICY_MALLOC;
+		else if (!strcmp(name, "first-touch")) policy = POLICY_FIRST_TOUCH;
+		else if (!strcmp(name, "interleave"))  policy = POLICY_INTERLEAVE;
+		else if (!strcmp(name, "per-socket"))  policy = POLICY_PER_SOCKET;
+		else return false;
+
+		if (policy == POLICY_MALLOC && g.pages != PAGES_SMALL)
+			policy = POLICY_FIRST_TOUCH;
+
+		if (policy == POLICY_MALLOC || g.base != NULL) {
+			g.policy = policy;
+			return true;
+		}
+
+		//> One extra chunk is reserved so that the arena can start at a
+		//> chunk-aligned address, as huge pages need.
+		g.nr_numa_nodes = count_numa_nodes();
+		char *reserved = (char *)mmap(NULL, NODE_ALLOCATOR_VA_SZ + NODE_ALLOCATOR_CHUNK_SZ,
+		                              PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE,
+		                              -1, 0);
+		if (reserved == MAP_FAILED) {
+			log_warning("NodeAllocator: could not reserve the arena, using malloc\n");
+			return true;
+		}
+		g.base = (char *)round_up((size_t)reserved, NODE_ALLOCATOR_CHUNK_SZ);
+
+		g.nr_arenas = (policy == POLICY_PER_SOCKET) ? g.nr_numa_nodes : 1;
+		g.max_chunks = (NODE_ALLOCATOR_VA_SZ / 4 * 3 / NODE_ALLOCATOR_CHUNK_SZ - 1) / g.nr_arenas;
+		for (int i=0; i < g.nr_arenas; i++) g.arenas[i].nr_chunks = 0;
+		g.large_used = 0;
+		g.policy = policy;
+		return true;
+	}
+
+	//> Must be called before any node is allocated. Without it the live
+	//> node memory is not counted and live_bytes() and live_blocks() are 0.
+	static void count_live() { global().count_live = true; }
+
+	//> Used by data structures that need their nodes in the arena (e.g., to
+	//> compress their pointers), all of them within its first `reach` bytes.
+	//> Falls back to first-touch if no arena policy has been selected.
+	static void require_arena(size_t reach = (UINT32_MAX + 1ULL) * NODE_ALLOCATOR_ALIGN)
+	{
+		global_t& g = global();
+		if (g.policy == POLICY_MALLOC) set_policy("first-touch");
+		if (g.base == NULL) {
+			log_critical("NodeAllocator: compact nodes need the arena\n");
+			abort();
+		}
+		//> The chunks are striped over the arenas, so chunk k of every arena
+		//> must end before `reach`.
+		size_t max_chunks = (reach / NODE_ALLOCATOR_CHUNK_SZ - 1) / g.nr_arenas;
+		g.max_chunks = std::min(g.max_chunks, max_chunks);
+		g.compact = true;
+	}
+
+	static const char *pages_name()
+	{
+		switch (global().pages) {
+		case PAGES_THP:       return "thp";
+		case PAGES_HUGETLBFS: return "hugetlbfs";
+		default:              return "small";
+		}
+	}
+
+	static const char *policy_name()
+	{
+		switch (global().policy) {
+		case POLICY_FIRST_TOUCH: return "first-touch";
+		case POLICY_INTERLEAVE:  return "interleave";
+		case POLICY_PER_SOCKET:  return "per-socket";
+		default:                 return "malloc";
+		}
+	}
+
+	static void *alloc(size_t sz)
+	{
+		global_t& g = global();
+
+		sz = round_up(sz, NODE_ALLOCATOR_ALIGN);
+		if (g.count_live) {
+			thread_t& t = thread();
+			t.live_bytes += sz;
+			t.live_blocks++;
+		}
+		if (g.policy == POLICY_MALLOC) return ::operator new(sz);
+
+		thread_t& t = thread();
+		if (sz > NODE_ALLOCATOR_CHUNK_SZ)
+			return grab_large(sz);
+
+		if (sz <= NODE_ALLOCATOR_MAX_SMALL) {
+			int sc = size_class(sz);
+			if (t.free_lists[sc] != NULL) {
+				void *ret = t.free_lists[sc];
+				t.free_lists[sc] = *(void **)ret;
+				return ret;
+			}
+		}
+
+		if (sz % 16 == 0) t.cur = (char *)round_up((size_t)t.cur, 16);
+		if (t.cur + sz > t.end) {
+			t.cur = (char *)grab_chunk();
+			if (t.cur == NULL) {
+				//> Arena is exhausted.
+				t.end = NULL;
+				return fallback(sz);
+			}
+			t.end = t.cur + NODE_ALLOCATOR_CHUNK_SZ;
+		}
+		void *ret = t.cur;
+		t.cur += sz;
+		return ret;
+	}
+
+	//> Blocks larger than NODE_ALLOCATOR_MAX_SMALL are not reused.
+	static void free(void *p, size_t sz)
+	{
+		if (p == NULL) return;
+
+		sz = round_up(sz, NODE_ALLOCATOR_ALIGN);
+		if (global().count_live) {
+			thread_t& t = thread();
+			t.live_bytes -= sz;
+			t.live_blocks--;
+		}
+		if (!in_arena(p)) {
+			::operator delete(p);
+			return;
+		}
+
+		if (sz > NODE_ALLOCATOR_MAX_SMALL) return;
+
+		thread_t& t = thread();
+		int sc = size_class(sz);
+		*(void **)p = t.free_lists[sc];
+		t.free_lists[sc] = p;
+	}
+
+	//> Pointer compression. An arena address is stored as its offset from
+	//> the arena start in NODE_ALLOCATOR_ALIGN units, so 32 bits reach the
+	//> first 32GB of the arena. NULL is 0 (the first chunk is never used).
+	//> require_arena() keeps all the nodes within reach, so the assert only
+	//> catches pointers that did not come from the allocator.
+	static inline uint32_t compress(const void *p)
+	{
+		if (p == NULL) return 0;
+		uint64_t off = ((const char *)p - global().base) / NODE_ALLOCATOR_ALIGN;
+		assert(in_arena((void *)p) && off <= UINT32_MAX);
+		return (uint32_t)off;
+	}
+	static inline void *decompress(uint32_t off)
+	{
+		if (off == 0) return NULL;
+		return global().base + (uint64_t)off * NODE_ALLOCATOR_ALIGN;
+	}
+
+	//> Node memory allocated and not yet freed, by all the threads. Exact once
+	//> the threads that allocate have stopped.
+	static unsigned long long live_bytes() { return live_sum(&thread_t::live_bytes); }
+	static unsigned long long live_blocks() { return live_sum(&thread_t::live_blocks); }
+
+	//> Prints how the pages that have been handed out so far are spread among
+	//> the NUMA nodes. The pages are queried with move_pages(2) and, for large
+	//> arenas, only a uniform sample of them is queried.
+	static void print_distribution()
+	{
+		global_t& g = global();
+		unsigned long long pages_per_node[NODE_ALLOCATOR_MAX_NUMA_NODES] = { 0 };
+		unsigned long long untouched = 0, sampled = 0, used_bytes = 0;
+
+		log_info("Node allocator\n");
+		log_info("=======================\n");
+		log_info("  Policy: %s\n", policy_name());
+		log_info("  Pages: %s\n", pages_name());
+		if (g.policy == POLICY_MALLOC || g.base == NULL) {
+			log_info("  Placement is not tracked for malloc allocations\n");
+			return;
+		}
+
+		size_t nr_chunks[NODE_ALLOCATOR_MAX_NUMA_NODES];
+		for (int i=0; i < g.nr_arenas; i++) {
+			nr_chunks[i] = std::min(g.arenas[i].nr_chunks.load(), g.max_chunks);
+			used_bytes += nr_chunks[i] * NODE_ALLOCATOR_CHUNK_SZ;
+		}
+		size_t large = std::min(g.large_used.load(), (size_t)NODE_ALLOCATOR_VA_SZ / 4);
+		used_bytes += large;
+
+		size_t total_pages = used_bytes / NODE_ALLOCATOR_PAGE_SZ;
+		size_t stride = total_pages / NODE_ALLOCATOR_MAX_SAMPLED_PAGES + 1;
+		void **pages = new void *[NODE_ALLOCATOR_MAX_SAMPLED_PAGES + 1];
+		int *status = new int[NODE_ALLOCATOR_MAX_SAMPLED_PAGES + 1];
+		long count = 0;
+		size_t page_no = 0;
+
+		//> Pick every `stride`-th page over all the chunks and the large area.
+		for (int i=0; i <= g.nr_arenas; i++) {
+			size_t n = (i < g.nr_arenas) ? nr_chunks[i] : 1;
+			for (size_t k=0; k < n; k++) {
+				char *start = (i < g.nr_arenas) ? chunk_addr(i, k) : large_area();
+				size_t len = (i < g.nr_arenas) ? NODE_ALLOCATOR_CHUNK_SZ : large;
+				for (size_t off=0; off < len; off += NODE_ALLOCATOR_PAGE_SZ, page_no++)
+					if (page_no % stride == 0 && count <= NODE_ALLOCATOR_MAX_SAMPLED_PAGES)
+						pages[count++] = start + off;
+			}
+		}
+
+		if (count > 0 && syscall(SYS_move_pages, 0, count, pages, NULL, status, 0) < 0) {
+			log_warning("  move_pages() failed, distribution not available\n");
+			count = 0;
+		}
+		for (long p=0; p < count; p++) {
+			if (status[p] >= 0 && status[p] < NODE_ALLOCATOR_MAX_NUMA_NODES)
+				pages_per_node[status[p]]++;
+			else
+				untouched++;
+		}
+		sampled = count;
+		delete[] pages;
+		delete[] status;
+
+		log_info("  Arena memory handed out: %.2lf MB\n", used_bytes / (1024.0 * 1024.0));
+		if (sampled == 0) return;
+		for (int i=0; i < NODE_ALLOCATOR_MAX_NUMA_NODES; i++)
+			if (pages_per_node[i] > 0)
+				log_info("  NUMA node %2d: %6.2lf%% of pages\n", i,
+				         100.0 * pages_per_node[i] / sampled);
+		if (untouched > 0)
+			log_info("  Not yet touched: %6.2lf%% of pages\n", 100.0 * untouched / sampled);
+	}
+
+private:
+	//> From <linux/mempolicy.h>
+	static const int MPOL_BIND_ = 2;
+	static const int MPOL_INTERLEAVE_ = 3;
+
+	struct arena_t {
+		std::atomic<size_t> nr_chunks;
+		char padding[64 - sizeof(std::atomic<size_t>)];
+	};
+
+	struct thread_t;
+
+	struct global_t {
+		policy_t policy;
+		pages_t pages;
+		bool count_live, compact;
+		char *base;
+		int nr_numa_nodes, nr_arenas;
+		size_t max_chunks;
+		std::atomic<size_t> large_used;
+		arena_t arenas[NODE_ALLOCATOR_MAX_NUMA_NODES];
+
+		//> The threads that have used the allocator, for live_bytes() and
+		//> live_blocks(), and the counters of those that have exited.
+		std::mutex threads_lock;
+		thread_t *threads;
+		long long exited_bytes, exited_blocks;
+	};
+
+	struct thread_t {
+		char *cur, *end;
+		void *free_lists[NODE_ALLOCATOR_MAX_SMALL / NODE_ALLOCATOR_ALIGN];
+		//> Allocated minus freed by this thread. Negative if it has freed
+		//> more blocks of other threads than it has allocated.
+		long long live_bytes, live_blocks;
+		thread_t *prev, *next;
+
+		thread_t()
+		{
+			global_t& g = global();
+			cur = end = NULL;
+			memset(free_lists, 0, sizeof(free_lists));
+			live_bytes = live_blocks = 0;
+			std::lock_guard<std::mutex> guard(g.threads_lock);
+			prev = NULL;
+			next = g.threads;
+			if (next) next->prev = this;
+			g.threads = this;
+		}
+
+		~thread_t()
+		{
+			global_t& g = global();
+			std::lock_guard<std::mutex> guard(g.threads_lock);
+			g.exited_bytes += live_bytes;
+			g.exited_blocks += live_blocks;
+			if (prev) prev->next = next;
+			else      g.threads = next;
+			if (next) next->prev = prev;
+		}
+	};
+
+	static global_t& global() { static global_t g; return g; }
+	static thread_t& thread() { static thread_local thread_t t; return t; }
+
+	static unsigned long long live_sum(long long thread_t::*counter)
+	{
+		global_t& g = global();
+		std::lock_guard<std::mutex> guard(g.threads_lock);
+		long long sum = (counter == &thread_t::live_bytes) ? g.exited_bytes
+		                                                    : g.exited_blocks;
+		for (thread_t *t = g.threads; t != NULL; t = t->next)
+			sum += t->*counter;
+		return (sum > 0) ? sum : 0;
+	}
+
+	static inline size_t round_up(size_t sz, size_t align)
+	{
+		return (sz + align - 1) / align * align;
+	}
+
+	static inline int size_class(size_t sz) { return sz / NODE_ALLOCATOR_ALIGN - 1; }
+
+	static inline bool in_arena(void *p)
+	{
+		char *base = global().base;
+		return base != NULL && (char *)p >= base &&
+		       (char *)p < base + NODE_ALLOCATOR_VA_SZ;
+	}
+
+	//> The k-th chunk of arena `arena`. Chunk 0 of the range is left unused.
+	static inline char *chunk_addr(int arena, size_t k)
+	{
+		global_t& g = global();
+		return g.base + (1 + k * g.nr_arenas + arena) * NODE_ALLOCATOR_CHUNK_SZ;
+	}
+
+	static inline char *large_area()
+	{
+		return global().base + NODE_ALLOCATOR_VA_SZ / 4 * 3;
+	}
+
+	static int count_numa_nodes()
+	{
+		char path[64];
+		int nr = 1;
+		for (int i=0; i < NODE_ALLOCATOR_MAX_NUMA_NODES; i++) {
+			sprintf(path, "/sys/devices/system/node/node%d", i);
+			if (access(path, F_OK) == 0) nr = i + 1;
+		}
+		return nr;
+	}
+
+	static int current_numa_node()
+	{
+		unsigned cpu, node;
+		if (syscall(SYS_getcpu, &cpu, &node, NULL) < 0) return 0;
+		return node;
+	}
+
+	static int current_arena()
+	{
+		global_t& g = global();
+		if (g.policy != POLICY_PER_SOCKET) return 0;
+		int arena = current_numa_node();
+		return (arena < g.nr_arenas) ? arena : 0;
+	}
+
+	//> Returns a new chunk from the calling thread's arena, or NULL if the
+	//> arena is exhausted.
+	static void *grab_chunk()
+	{
+		global_t& g = global();
+		int arena = current_arena();
+		size_t k = g.arenas[arena].nr_chunks.fetch_add(1);
+		if (k >= g.max_chunks) return NULL;
+		char *chunk = chunk_addr(arena, k);
+		commit(chunk, NODE_ALLOCATOR_CHUNK_SZ, arena);
+		return chunk;
+	}
+
+	//> Allocates outside the arena when it is exhausted. The compressed
+	//> pointers can not reach malloc'ed nodes, so with a compact layout the
+	//> run is over.
+	static void *fallback(size_t sz)
+	{
+		if (global().compact) {
+			log_error("NodeAllocator: arena exhausted, compact nodes can not be "
+			          "allocated with malloc\n");
+			exit(1);
+		}
+		static std::atomic<bool> warned(false);
+		if (!warned.exchange(true))
+			log_warning("NodeAllocator: arena %d exhausted, using malloc\n", current_arena());
+		return ::operator new(sz);
+	}
+
+	static void *grab_large(size_t sz)
+	{
+		global_t& g = global();
+		if (g.compact) {
+			//> The large area is beyond the reach of the compressed pointers.
+			log_error("NodeAllocator: compact nodes can not be larger than a chunk\n");
+			exit(1);
+		}
+		sz = round_up(sz, NODE_ALLOCATOR_CHUNK_SZ);
+		size_t off = g.large_used.fetch_add(sz);
+		if (off + sz > NODE_ALLOCATOR_VA_SZ / 4) {
+			static std::atomic<bool> warned(false);
+			if (!warned.exchange(true))
+				log_warning("NodeAllocator: large area exhausted, using malloc\n");
+			return ::operator new(sz);
+		}
+		char *ret = large_area() + off;
+		commit(ret, sz, current_arena());
+		return ret;
+	}
+
+	//> Makes [addr, addr + sz) accessible, with the selected page size and
+	//> NUMA policy.
+	static void commit(char *addr, size_t sz, int arena)
+	{
+		global_t& g = global();
+		void *ret = MAP_FAILED;
+		if (g.pages == PAGES_HUGETLBFS) {
+			ret = mmap(addr, sz, PROT_READ | PROT_WRITE,
+			           MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED | MAP_HUGETLB, -1, 0);
+			if (ret == MAP_FAILED) {
+				static std::atomic<bool> warned(false);
+				if (!warned.exchange(true))
+					log_warning("NodeAllocator: no hugetlbfs pages available, using small pages\n");
+			}
+		}
+		if (ret == MAP_FAILED)
+			ret = mmap(addr, sz, PROT_READ | PROT_WRITE,
+			           MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED, -1, 0);
+		if (ret == MAP_FAILED) {
+			log_critical("NodeAllocator: could not commit arena chunk\n");
+			abort();
+		}
+		if (g.pages == PAGES_THP)
+			madvise(addr, sz, MADV_HUGEPAGE);
+
+		unsigned long mask = 0;
+		int mode = -1;
+		if (g.policy == POLICY_INTERLEAVE) {
+			mode = MPOL_INTERLEAVE_;
+			for (int i=0; i < g.nr_numa_nodes; i++) mask |= 1UL << i;
+		} else if (g.policy == POLICY_PER_SOCKET) {
+			mode = MPOL_BIND_;
+			mask = 1UL << arena;
+		}
+		if (mode != -1 &&
+		    syscall(SYS_mbind, addr, sz, mode, &mask, NODE_ALLOCATOR_MAX_NUMA_NODES + 1, 0) < 0) {
+			static std::atomic<bool> warned(false);
+			if (!warned.exchange(true))
+				log_warning("NodeAllocator: mbind() failed, placement is first-touch\n");
+		}
+	}
+};
+
+/**
+ * A 32-bit pointer to a T that has been allocated by NodeAllocator.
+ * It converts to and from T* so that it can replace a plain T* field.
+ **/
+template <typename T>
+class CompactPtr {
+private:
+	uint32_t off;
+
+public:
+	CompactPtr(T *p = NULL) : off(NodeAllocator::compress(p)) {}
+
+	CompactPtr& operator=(T *p) { off = NodeAllocator::compress(p); return *this; }
+	operator T*() const { return (T *)NodeAllocator::decompress(off); }
+	T *operator->() const { return (T *)NodeAllocator::decompress(off); }
+};
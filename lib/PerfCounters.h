@@ -0,0 +1,237 @@
+#pragma once
+
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#include <vector>
+
+#include "Log.h"
+
+/**
+ * Per-thread hardware counters through perf_event_open(2), so that no PAPI
+ * installation is needed.
+ *
+ * Every thread opens its own counters with open(), or the first time it calls
+ * start() (and again if another thread has used the same tid before); they
+ * only count while that thread runs and only in user space, which also works
+ * with the default perf_event_paranoid setting of 2. stop() reads them, scaled
+ * up if the kernel had to multiplex them, and keeps the values of the last
+ * start()/stop() interval of the thread. An event that cannot be opened (no
+ * PMU, e.g., in a VM or container, or not supported by the CPU) is reported
+ * once and left out; the others are still counted.
+ **/
+class PerfCounters {
+public:
+	enum event_t {
+		CYCLES = 0,
+		INSTRUCTIONS,
+		LLC_MISSES,
+		DTLB_MISSES,
+		BRANCH_MISSES,
+		NR_EVENTS
+	};
+
+	//> Called once, before any thread calls start().
+	static void init(int nthreads)
+	{
+		global_t& g = global();
+		g.nthreads = nthreads;
+		g.fds.assign(nthreads * NR_EVENTS, -1);
+		g.owners.assign(nthreads, -1);
+		g.values.assign(nthreads * NR_EVENTS, 0);
+		for (int e=0; e < NR_EVENTS; e++) g.available[e] = true;
+	}
+
+	//> Opens the counters of the calling thread, to keep the perf_event_open()
+	//> calls out of the measured interval.
+	static void open(int tid)
+	{
+		global_t& g = global();
+		if (tid >= g.nthreads) return;
+		pid_t self = syscall(SYS_gettid);
+		if (g.owners[tid] != self) {
+			for (int e=0; e < NR_EVENTS; e++) {
+				int& fd = g.fds[tid * NR_EVENTS + e];
+				if (fd >= 0) close(fd);
+				fd = -1;
+			}
+			g.owners[tid] = self;
+		}
+		for (int e=0; e < NR_EVENTS; e++) {
+			int& fd = g.fds[tid * NR_EVENTS + e];
+			if (fd < 0 && g.available[e]) fd = open_event(e);
+		}
+	}
+
+	static void start(int tid)
+	{
+		global_t& g = global();
+		if (tid >= g.nthreads) return;
+		open(tid);
+		for (int e=0; e < NR_EVENTS; e++) {
+			int fd = g.fds[tid * NR_EVENTS + e];
+			if (fd < 0) continue;
+			ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+			ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+		}
+	}
+
+	static void stop(int tid)
+	{
+		global_t& g = global();
+		if (tid >= g.nthreads) return;
+		for (int e=0; e < NR_EVENTS; e++) {
+			int fd = g.fds[tid * NR_EVENTS + e];
+			uint64_t buf[3]; //> value, time enabled, time running
+			if (fd < 0) continue;
+			ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+			if (read(fd, buf, sizeof(buf)) != sizeof(buf)) continue;
+			if (buf[2] > 0 && buf[2] < buf[1])
+				buf[0] = (uint64_t)((double)buf[0] * buf[1] / buf[2]);
+			g.values[tid * NR_EVENTS + e] = buf[0];
+		}
+	}
+
+	//> Whether at least one of the events could be counted.
+	static bool available()
+	{
+		global_t& g = global();
+		if (g.nthreads == 0) return false;
+		for (int e=0; e < NR_EVENTS; e++)
+			if (g.available[e]) return true;
+		return false;
+	}
+	static bool available(event_t e) { return global().available[e]; }
+
+	static const char *event_name(int e)
+	{
+		static const char *names[NR_EVENTS] = {
+			"cycles", "instructions", "llc_misses", "dtlb_misses", "branch_misses"
+		};
+		return names[e];
+	}
+
+	static unsigned long long value(int tid, event_t e)
+	{
+		return global().values[tid * NR_EVENTS + e];
+	}
+
+	static unsigned long long total(event_t e)
+	{
+		global_t& g = global();
+		unsigned long long sum = 0;
+		for (int tid=0; tid < g.nthreads; tid++)
+			sum += g.values[tid * NR_EVENTS + e];
+		return sum;
+	}
+
+	//> Prints the counters of every thread and of all threads together,
+	//> divided by the number of operations each one has performed.
+	//> `thread_ops` may be NULL, to print the totals only.
+	static void print(const unsigned long long *thread_ops, unsigned long long total_ops)
+	{
+		global_t& g = global();
+		char line[256];
+		int len;
+
+		if (!available()) {
+			log_info("  Not available\n");
+			return;
+		}
+		len = snprintf(line, sizeof(line), "  %6s", "tid");
+		for (int e=0; e < NR_EVENTS; e++)
+			if (g.available[e])
+				len += snprintf(line + len, sizeof(line) - len, " %14s", event_name(e));
+		snprintf(line + len, sizeof(line) - len, " %8s", "IPC");
+		log_info("%s\n", line);
+		for (int tid=0; thread_ops && tid < g.nthreads; tid++)
+			print_row(tid, thread_ops[tid]);
+		print_row(-1, total_ops);
+	}
+
+private:
+	struct global_t {
+		int nthreads;
+		bool available[NR_EVENTS];
+		std::vector<int> fds;
+		std::vector<pid_t> owners; //> The thread that opened fds[tid]
+		std::vector<unsigned long long> values;
+	};
+
+	static global_t& global() { static global_t g; return g; }
+
+	static void print_row(int tid, unsigned long long ops)
+	{
+		global_t& g = global();
+		char line[256];
+		int len;
+
+		if (ops == 0) ops = 1;
+		if (tid >= 0) len = snprintf(line, sizeof(line), "  %6d", tid);
+		else          len = snprintf(line, sizeof(line), "  %6s", "total");
+		for (int e=0; e < NR_EVENTS; e++) {
+			if (!g.available[e]) continue;
+			unsigned long long v = (tid >= 0) ? value(tid, (event_t)e) : total((event_t)e);
+			len += snprintf(line + len, sizeof(line) - len, " %14.2lf", (double)v / ops);
+		}
+		unsigned long long cycles = (tid >= 0) ? value(tid, CYCLES) : total(CYCLES);
+		unsigned long long instrs = (tid >= 0) ? value(tid, INSTRUCTIONS) : total(INSTRUCTIONS);
+		if (g.available[CYCLES] && g.available[INSTRUCTIONS] && cycles > 0)
+			snprintf(line + len, sizeof(line) - len, " %8.2lf", (double)instrs / cycles);
+		log_info("%s\n", line);
+	}
+
+	//> Returns the file descriptor of the counter, or -1 (and marks the event
+	//> as unavailable for all the threads) if it cannot be opened.
+	static int open_event(int e)
+	{
+		global_t& g = global();
+		struct perf_event_attr attr;
+		int fd;
+
+		memset(&attr, 0, sizeof(attr));
+		attr.size = sizeof(attr);
+		attr.disabled = 1;
+		attr.exclude_kernel = 1;
+		attr.exclude_hv = 1;
+		attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED |
+		                   PERF_FORMAT_TOTAL_TIME_RUNNING;
+		switch (e) {
+		case CYCLES:
+			attr.type = PERF_TYPE_HARDWARE;
+			attr.config = PERF_COUNT_HW_CPU_CYCLES;
+			break;
+		case INSTRUCTIONS:
+			attr.type = PERF_TYPE_HARDWARE;
+			attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+			break;
+		case LLC_MISSES:
+			attr.type = PERF_TYPE_HW_CACHE;
+			attr.config = PERF_COUNT_HW_CACHE_LL |
+			              (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+			              (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+			break;
+		case DTLB_MISSES:
+			attr.type = PERF_TYPE_HW_CACHE;
+			attr.config = PERF_COUNT_HW_CACHE_DTLB |
+			              (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+			              (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+			break;
+		case BRANCH_MISSES:
+			attr.type = PERF_TYPE_HARDWARE;
+			attr.config = PERF_COUNT_HW_BRANCH_MISSES;
+			break;
+		}
+
+		//> pid 0 and cpu -1: the calling thread, on any cpu.
+		fd = syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+		if (fd < 0 && __sync_bool_compare_and_swap(&g.available[e], true, false))
+			log_warning("PerfCounters: %s not available (%s)\n", event_name(e),
+			            strerror(errno));
+		return fd;
+	}
+};
@@ -1,34 +1,114 @@
 #pragma once
 
 #include <stdlib.h>
-#include <sys/time.h>
+#include <stdint.h>
+#include <time.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#endif
 
+#include "Log.h"
+
+/**
+ * A high-resolution timer.
+ *
+ * On x86 CPUs with an invariant TSC (constant rate, not stopped in deep
+ * C-states) the timer reads the TSC, which costs a few nanoseconds; its rate
+ * is calibrated once against CLOCK_MONOTONIC_RAW, the first time the timer is
+ * used or when init() is called. Elsewhere it falls back to
+ * clock_gettime(CLOCK_MONOTONIC_RAW), i.e., ticks are nanoseconds.
+ *
+ * The static now()/ticks_to_ns() pair is meant for hot loops (e.g., per
+ * operation latencies); the instances accumulate the time between their
+ * start() and stop() calls.
+ **/
 class Timer {
-	private:
+public:
+	Timer() : ticks(0) {};
+	~Timer() {};
 
-    struct timeval t1;
-    struct timeval t2;
-    double duration;
+	inline void start() { t1 = now(); }
+	inline void stop()  { ticks += now() - t1; }
 
-	public:
+	//> The accumulated time, in ticks of now() and in (nano)seconds.
+	inline uint64_t cycles() { return ticks; }
+	inline double report_nsec() { return ticks * global().ns_per_tick; }
+	inline double report_sec() { return report_nsec() / 1000000000.0; }
 
-	Timer() : duration(0) {};
-	~Timer() {};
+	//> Calibrates the TSC, if not already done, and reports the backend.
+	static void init()
+	{
+		global_t& g = global();
+		if (g.tsc)
+			log_info("  Timer: invariant TSC (%.3lf GHz)\n", 1.0 / g.ns_per_tick);
+		else
+			log_info("  Timer: clock_gettime(CLOCK_MONOTONIC_RAW)\n");
+	}
+
+	static inline uint64_t now()
+	{
+#		if defined(__x86_64__) || defined(__i386__)
+		if (global().tsc) return __builtin_ia32_rdtsc();
+#		endif
+		return clock_ns();
+	}
 
-	inline void start()
+	static inline uint64_t ticks_to_ns(uint64_t t)
 	{
-		gettimeofday(&t1, 0);
+		return (uint64_t)(t * global().ns_per_tick);
 	}
 
-	inline void stop()
+	static inline uint64_t now_ns() { return ticks_to_ns(now()); }
+
+	static const char *backend_name() { return global().tsc ? "tsc" : "clock_gettime"; }
+
+private:
+	uint64_t t1, ticks;
+
+	struct global_t {
+		bool tsc;
+		double ns_per_tick;
+
+		global_t()
+		{
+			tsc = false;
+			ns_per_tick = 1.0;
+			if (invariant_tsc()) calibrate();
+		}
+
+		//> Counts TSC ticks for 20ms of CLOCK_MONOTONIC_RAW.
+		void calibrate()
+		{
+#			if defined(__x86_64__) || defined(__i386__)
+			uint64_t ns0 = clock_ns(), tsc0 = __builtin_ia32_rdtsc(), ns1, tsc1;
+			do {
+				ns1 = clock_ns();
+				tsc1 = __builtin_ia32_rdtsc();
+			} while (ns1 - ns0 < 20000000ULL);
+			if (tsc1 <= tsc0) return;
+			tsc = true;
+			ns_per_tick = (double)(ns1 - ns0) / (tsc1 - tsc0);
+#			endif
+		}
+	};
+
+	static global_t& global() { static global_t g; return g; }
+
+	static inline uint64_t clock_ns()
 	{
-		gettimeofday(&t2, 0);
-    	duration += (double)((t2.tv_sec - t1.tv_sec) * 1000000 \
-                       + t2.tv_usec - t1.tv_usec) / 1000000;
+		struct timespec ts;
+		clock_gettime(CLOCK_MONOTONIC_RAW, &ts);
+		return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
 	}
 
-	inline double report_sec()
+	//> CPUID.80000007H:EDX[8]
+	static bool invariant_tsc()
 	{
-    	return duration;
+#		if defined(__x86_64__) || defined(__i386__)
+		unsigned int eax, ebx, ecx, edx;
+		if (__get_cpuid(0x80000007, &eax, &ebx, &ecx, &edx))
+			return (edx >> 8) & 1;
+#		endif
+		return false;
 	}
 };
@@ -11,7 +11,7 @@ int all_cpu_counters[] = {
     PAPI_TOT_CYC,
 //    PAPI_TOT_INS,
 //    PAPI_RES_STL,
-//    PAPI_TLB_DM,
+    PAPI_TLB_DM,
 #endif
 };
 
@@ -23,7 +23,7 @@ std::string all_cpu_counters_strings[] = {
     "PAPI_TOT_CYC",
 //    "PAPI_TOT_INS",
 //    "PAPI_RES_STL",
-//    "PAPI_TLB_DM",
+    "PAPI_TLB_DM",
 #endif
 };
 